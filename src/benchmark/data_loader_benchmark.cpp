@@ -0,0 +1,667 @@
+/// \file data_loader_benchmark.cpp
+/// \brief Benchmark suite measuring DataLoader and DataLoaderService throughput.
+/// \details Every backend and row count runs in a forked child, so each case gets
+/// \details fresh DataLoader instances. Results are written to stdout as JSON.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+extern "C" {
+#include <sys/wait.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/format.hpp"
+
+#include "batch_writer/batch_writer.h"
+#include "bulk_importer/bulk_importer.h"
+#include "columnar_snapshot/columnar_snapshot.h"
+#include "data_loader/data_loader.h"
+#include "data_loader_service/data_loader_service.h"
+#include "sharded_store/sharded_store.h"
+
+namespace {
+  // C++ heap allocations of the process, counted by the replaced operator new
+  std::atomic<uint64_t> heap_allocations{0};
+}
+
+void *operator new(std::size_t size) {
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc{};
+}
+
+// kept out of line, gcc pairs an inlined free with operator new and warns
+__attribute__((noinline)) void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+  using crypto_wallet::client::BatchWriter;
+  using crypto_wallet::client::BulkImporter;
+  using crypto_wallet::client::DataLoader;
+  using crypto_wallet::client::DataLoaderService;
+  using crypto_wallet::client::MemoryPool;
+  using Clock = std::chrono::steady_clock;
+
+  struct TypedTransactionsName {
+    static constexpr std::string_view kName = "typed_wallet_transactions";
+  };
+  struct AddressColumn : crypto_wallet::client::Column<std::string> {
+    static constexpr std::string_view kName = "address";
+  };
+  struct AmountColumn : crypto_wallet::client::Column<int64_t> {
+    static constexpr std::string_view kName = "amount";
+  };
+  using TypedTransactions = crypto_wallet::client::TableSchema<TypedTransactionsName,
+                                                               AddressColumn, AmountColumn>;
+
+  constexpr std::size_t kBatchSize = 1000;
+  // every autocommit insert syncs the file, these cases are capped to keep large runs bounded
+  constexpr uint64_t kAutocommitRowsLimit = 100000;
+
+  double RowsPerSecond(uint64_t rows, Clock::time_point begin, Clock::time_point end) {
+    std::chrono::duration<double> elapsed = end - begin;
+    return elapsed.count() > 0 ? rows / elapsed.count() : 0;
+  }
+
+  // Former insert path: SQL text is formatted and parsed for every row.
+  double BenchmarkFormattedInsert(DataLoader &data_loader, uint64_t rows) {
+    std::string insert_template = "INSERT INTO %1% (%2%) VALUES ('%3%', %4%);";
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < rows; ++i)
+      data_loader.RunSqlScript(boost::str(boost::format{insert_template} %
+                                          data_loader.GetDataBaseTableName() %
+                                          data_loader.GetDBTableStructTemplate() %
+                                          ("address_" + std::to_string(i % 1000)) % i));
+    return RowsPerSecond(rows, begin, Clock::now());
+  }
+
+  // Insert through the cached prepared statement.
+  double BenchmarkPreparedInsert(DataLoader &data_loader, uint64_t rows) {
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < rows; ++i)
+      data_loader.InsertIntoTable({"address_" + std::to_string(i % 1000), std::to_string(i)});
+    return RowsPerSecond(rows, begin, Clock::now());
+  }
+
+  // Insert grouped into transactions of batch_size rows.
+  double BenchmarkBatchInsert(DataLoader &data_loader, uint64_t rows, std::size_t batch_size) {
+    auto begin = Clock::now();
+    {
+      BatchWriter batch_writer{data_loader, batch_size, std::chrono::milliseconds{1000}};
+      for (uint64_t i = 0; i < rows; ++i)
+        batch_writer.Add(std::vector<std::string>{"address_" + std::to_string(i % 1000),
+                                                  std::to_string(i)});
+    }
+    return RowsPerSecond(rows, begin, Clock::now());
+  }
+
+  // Insert native values through the schema, grouped into transactions of batch_size rows.
+  double BenchmarkTypedInsert(DataLoader &data_loader, uint64_t rows, std::size_t batch_size) {
+    bool is_table_exist = data_loader.GetDataBaseTableName() == TypedTransactions::kName;
+    if (!is_table_exist && data_loader.CreateDBTable<TypedTransactions>() != SQLITE_OK)
+      return 0;
+
+    std::string address;
+    auto begin = Clock::now();
+    data_loader.BeginTransaction();
+    for (uint64_t i = 0; i < rows; ++i) {
+      address = "address_" + std::to_string(i % 1000);
+      data_loader.InsertIntoTable<TypedTransactions>(address, i);
+      if ((i + 1) % batch_size == 0) {
+        data_loader.CommitTransaction();
+        data_loader.BeginTransaction();
+      }
+    }
+    data_loader.CommitTransaction();
+    return RowsPerSecond(rows, begin, Clock::now());
+  }
+
+  struct InsertAllocations {
+    uint64_t heap{0};
+    uint64_t sqlite{0};
+  };
+
+  // Allocations per 1000 single row inserts after warm up, SQLite allocations are
+  // counted when they are routed into the pool.
+  InsertAllocations BenchmarkInsertAllocations(DataLoader &data_loader, uint64_t rows) {
+    constexpr uint64_t kWarmUpRows = 100;
+    rows = std::min<uint64_t>(rows, 10000);
+    for (uint64_t i = 0; i < kWarmUpRows; ++i)
+      data_loader.InsertIntoTable({"address_" + std::to_string(i % 1000), std::to_string(i)});
+
+    auto heap_begin = heap_allocations.load(std::memory_order_relaxed);
+    auto metrics_begin = data_loader.GetAllocationMetrics();
+    for (uint64_t i = 0; i < rows; ++i)
+      data_loader.InsertIntoTable({"address_" + std::to_string(i % 1000), std::to_string(i)});
+    auto heap_end = heap_allocations.load(std::memory_order_relaxed);
+    auto metrics_end = data_loader.GetAllocationMetrics();
+
+    auto inserted = metrics_end.inserted_rows - metrics_begin.inserted_rows;
+    if (!inserted)
+      return InsertAllocations{};
+    // GetAllocationMetrics itself allocates nothing on the heap
+    return InsertAllocations{(heap_end - heap_begin) * 1000 / inserted,
+                             (metrics_end.pool_allocations - metrics_begin.pool_allocations) *
+                                 1000 / inserted};
+  }
+
+  // Table existence checks, answered from the schema catalog.
+  double BenchmarkExistenceCheck(DataLoader &data_loader, uint64_t checks) {
+    uint64_t found{0};
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < checks; ++i)
+      found += data_loader.IsDataBaseTableExist() ? 1 : 0;
+    auto end = Clock::now();
+    return found == checks ? RowsPerSecond(checks, begin, end) : 0;
+  }
+
+  // Import CSV dump of rows through the memory mapped importer.
+  BulkImporter::Report BenchmarkCsvImport(DataLoader &data_loader, uint64_t rows) {
+    const std::string csv_name{"benchmark_dump.csv"};
+    {
+      std::ofstream csv{csv_name};
+      csv << "address,amount\n";
+      for (uint64_t i = 0; i < rows; ++i)
+        csv << "address_" << i % 1000 << ',' << i << '\n';
+    }
+    BulkImporter::Options options;
+    options.is_header_skipped = true;
+    BulkImporter::Report report;
+    BulkImporter{data_loader, options}.Import(csv_name, report);
+    std::remove(csv_name.c_str());
+    return report;
+  }
+
+  // Balance of every address looked up through the aggregate, 1000 addresses are used.
+  double BenchmarkBalanceLookup(DataLoader &data_loader, uint64_t lookups) {
+    if (data_loader.EnableBalanceAggregate("address", "amount") != SQLITE_OK)
+      return 0;
+
+    crypto_wallet::client::BalanceAggregate::Balance balance;
+    std::string address;
+    uint64_t found{0};
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < lookups; ++i) {
+      address = "address_" + std::to_string(i % 1000);
+      if (data_loader.GetBalance(address, balance) == SQLITE_OK && balance.transactions)
+        ++found;
+    }
+    auto end = Clock::now();
+    return found ? RowsPerSecond(lookups, begin, end) : 0;
+  }
+
+  // Scan all rows through the cursor, page_size 0 scans in a single pass.
+  double BenchmarkCursorScan(DataLoader &data_loader, std::size_t page_size) {
+    auto begin = Clock::now();
+    uint64_t checksum{0};
+    auto cursor = data_loader.OpenSelectCursor({"address", "amount"}, page_size);
+    for (const auto &row : cursor)
+      checksum += row.GetText(0).size() + row.GetInt64(1);
+    auto end = Clock::now();
+    return checksum ? RowsPerSecond(cursor.GetRowsCount(), begin, end) : 0;
+  }
+
+  // Same projection selected repeatedly, memory_budget 0 runs every select in SQLite.
+  double BenchmarkRepeatedSelect(DataLoader &data_loader, uint64_t selects,
+                                 std::size_t memory_budget) {
+    data_loader.EnableResultCache(memory_budget);
+    std::shared_ptr<const crypto_wallet::client::ResultCache::Result> result;
+    uint64_t checksum{0};
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < selects; ++i)
+      if (data_loader.SelectFromTable({"address", "amount"}, result) == SQLITE_OK)
+        checksum += result->GetRowsCount();
+    auto end = Clock::now();
+    return checksum ? RowsPerSecond(selects, begin, end) : 0;
+  }
+
+  const std::string kColumnarSnapshotName{"benchmark_snapshot.cws"};
+
+  double BenchmarkColumnarExport(DataLoader &data_loader) {
+    crypto_wallet::client::ColumnarWriter::Report report;
+    if (data_loader.ExportTable(kColumnarSnapshotName, report) != SQLITE_OK || !report.seconds)
+      return 0;
+    return report.rows / report.seconds;
+  }
+
+  // Sum of the amount column read straight from the mapped snapshot.
+  double BenchmarkColumnarScan() {
+    using crypto_wallet::client::ColumnarReader;
+    using crypto_wallet::client::columnar::Encoding;
+    auto begin = Clock::now();
+    ColumnarReader reader;
+    if (reader.Open(kColumnarSnapshotName) != SQLITE_OK)
+      return 0;
+    auto column = reader.FindColumn("amount");
+    if (column == reader.GetColumnNames().size())
+      return 0;
+    int64_t checksum{0};
+    for (std::size_t group = 0; group < reader.GetRowGroupsCount(); ++group) {
+      const auto &chunk = reader.GetChunk(group, column);
+      if (chunk.GetEncoding() != Encoding::kInt64)
+        return 0;
+      auto values = chunk.GetInt64Values();
+      for (std::size_t i = 0; i < chunk.GetRowsCount(); ++i)
+        checksum += values[i];
+    }
+    auto end = Clock::now();
+    std::remove(kColumnarSnapshotName.c_str());
+    return checksum ? RowsPerSecond(reader.GetRowsCount(), begin, end) : 0;
+  }
+
+  struct ShardedResult {
+    double insert_rows_per_sec{0};
+    double scan_rows_per_sec{0};
+  };
+
+  // Rows inserted by 4 producers into shards_count shards, then scanned in parallel.
+  ShardedResult BenchmarkSharded(uint64_t rows, std::size_t shards_count) {
+    using crypto_wallet::client::ShardedStore;
+    const std::string db_name{"benchmark_sharded_db"};
+    auto remove_shards = [&]() {
+      for (std::size_t i = 0; i < shards_count; ++i)
+        for (const auto &suffix : {"", "-wal", "-shm", "-journal"})
+          std::remove((db_name + "_shard" + std::to_string(i) + suffix).c_str());
+    };
+    remove_shards();
+
+    ShardedResult result;
+    {
+      ShardedStore::Options options;
+      options.shards_count = shards_count;
+      options.storage_profile = crypto_wallet::client::StorageProfile::BulkLoad();
+      ShardedStore sharded_store{db_name, "wallet_transactions", {"address", "amount"}, 0,
+                                 options};
+      if (sharded_store.Open() != SQLITE_OK)
+        return result;
+
+      constexpr uint64_t kProducers{4};
+      auto begin = Clock::now();
+      std::vector<std::thread> producers;
+      for (uint64_t producer = 0; producer < kProducers; ++producer)
+        producers.emplace_back([&sharded_store, rows, producer]() {
+          for (uint64_t i = producer; i < rows; i += kProducers)
+            sharded_store.Insert({"address_" + std::to_string(i % 1000), std::to_string(i)});
+        });
+      for (auto &producer : producers)
+        producer.join();
+      if (sharded_store.Flush() != SQLITE_OK)
+        return result;
+      result.insert_rows_per_sec = RowsPerSecond(rows, begin, Clock::now());
+
+      uint64_t scanned{0};
+      begin = Clock::now();
+      if (sharded_store.Scan([&scanned](const std::string *, std::size_t) { ++scanned; }) ==
+          SQLITE_OK)
+        result.scan_rows_per_sec = RowsPerSecond(scanned, begin, Clock::now());
+    }
+    remove_shards();
+    return result;
+  }
+
+  struct DictionaryResult {
+    double insert_rows_per_sec{0};
+    double scan_rows_per_sec{0};
+    uint64_t size{0};
+  };
+
+  // Wallet rows with 1000 addresses, 8 assets and 4 transaction types written in
+  // batches, then scanned through the cursor, with the text columns plain or encoded.
+  DictionaryResult BenchmarkDictionary(uint64_t rows, bool is_encoded) {
+    // registry keeps the loader of the path open, each mode gets its own file
+    const std::string db_name = is_encoded ? "benchmark_encoded_db" : "benchmark_plain_db";
+    auto remove_db = [&]() {
+      for (const auto &suffix : {"", "-wal", "-shm", "-journal"})
+        std::remove((db_name + suffix).c_str());
+    };
+    remove_db();
+
+    DictionaryResult result;
+    {
+      auto data_loader = DataLoader::GetRegistry().Acquire(db_name);
+      data_loader->SetDBTableStructTemplate({"address", "asset", "tx_type", "amount"});
+      if (data_loader->CreateDBTable("wallet_transactions") != SQLITE_OK ||
+          (is_encoded && data_loader->EnableDictionaryEncoding({"address", "asset",
+                                                                "tx_type"}) != SQLITE_OK))
+        return result;
+
+      const char *assets[] = {"BTC", "ETH", "USDT", "USDC", "BNB", "XRP", "SOL", "DOGE"};
+      const char *tx_types[] = {"transfer", "deposit", "withdrawal", "exchange"};
+      std::vector<std::string> addresses;
+      for (uint64_t i = 0; i < 1000; ++i)
+        addresses.push_back(boost::str(boost::format{"0x%040x"} % (i * 2654435761u)));
+      std::vector<std::string> amounts;
+      for (uint64_t i = 0; i < kBatchSize; ++i)
+        amounts.push_back(std::to_string(i * 1000));
+
+      std::vector<std::string_view> values;
+      auto begin = Clock::now();
+      for (uint64_t row = 0; row < rows; ++row) {
+        values.insert(values.end(), {addresses[(row * 7) % addresses.size()],
+                                     assets[row % 8], tx_types[row % 4],
+                                     amounts[row % kBatchSize]});
+        if (values.size() == 4 * kBatchSize || row + 1 == rows) {
+          if (data_loader->InsertBatch(values, 4) != SQLITE_OK)
+            return result;
+          values.clear();
+        }
+      }
+      result.insert_rows_per_sec = RowsPerSecond(rows, begin, Clock::now());
+      data_loader->RunSqlScript("PRAGMA wal_checkpoint(TRUNCATE);");
+      result.size = data_loader->GetDataBaseSize();
+
+      uint64_t scanned{0};
+      uint64_t bytes{0};
+      begin = Clock::now();
+      auto cursor = data_loader->OpenSelectCursor({"address", "asset", "tx_type", "amount"});
+      for (const auto &row : cursor) {
+        bytes += row.GetText(0).size();
+        ++scanned;
+      }
+      if (cursor.GetResult() == SQLITE_OK && bytes > 0)
+        result.scan_rows_per_sec = RowsPerSecond(scanned, begin, Clock::now());
+    }
+    remove_db();
+    return result;
+  }
+
+  struct RegistryResult {
+    uint64_t cold_open_p99_ns{0};
+    uint64_t reopen_p99_ns{0};
+    uint64_t warm_acquire_p99_ns{0};
+    uint64_t evictions{0};
+  };
+
+  // Wallets acquired round robin through a registry holding a quarter of them open,
+  // every acquire of the second round reopens an evicted wallet.
+  RegistryResult BenchmarkRegistry(std::size_t wallets_count) {
+    using Registry = crypto_wallet::client::HandleRegistry<DataLoader>;
+    auto wallet_name = [](std::size_t i) { return "benchmark_wallet_" + std::to_string(i); };
+    auto remove_wallets = [&]() {
+      for (std::size_t i = 0; i < wallets_count; ++i)
+        for (const auto &suffix : {"", "-wal", "-shm", "-journal"})
+          std::remove((wallet_name(i) + suffix).c_str());
+    };
+    // acquire wallets [first, last) rounds times, returns p99 acquire latency in ns
+    auto acquire_p99 = [&](Registry &registry, std::size_t first, std::size_t last,
+                           std::size_t rounds) {
+      std::vector<uint64_t> latencies;
+      for (std::size_t round = 0; round < rounds; ++round)
+        for (std::size_t i = first; i < last; ++i) {
+          auto begin = Clock::now();
+          auto data_loader = registry.Acquire(wallet_name(i));
+          latencies.push_back(static_cast<uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin)
+                  .count()));
+        }
+      std::sort(latencies.begin(), latencies.end());
+      return latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100];
+    };
+    remove_wallets();
+
+    RegistryResult result;
+    {
+      Registry::Options options;
+      options.max_open_handles = std::max<std::size_t>(wallets_count / 4, 1);
+      Registry registry{options};
+      registry.SetInitializer([](DataLoader &data_loader, const std::string &) {
+        data_loader.RunSqlScript(
+            "CREATE TABLE IF NOT EXISTS wallet_transactions (address, amount);");
+      });
+      result.cold_open_p99_ns = acquire_p99(registry, 0, wallets_count, 1);
+      result.reopen_p99_ns = acquire_p99(registry, 0, wallets_count, 1);
+      // the last max_open_handles wallets are still open after the second round
+      result.warm_acquire_p99_ns = acquire_p99(
+          registry, wallets_count - options.max_open_handles, wallets_count, 100);
+      result.evictions = registry.GetMetrics().evictions;
+    }
+    remove_wallets();
+    return result;
+  }
+
+  // Enqueue records into the ingest pipeline, returns p99 enqueue latency in ns.
+  uint64_t BenchmarkIngestEnqueue(DataLoaderService &data_loader_service, uint64_t rows) {
+    std::vector<uint64_t> latencies;
+    latencies.reserve(rows);
+    for (uint64_t i = 0; i < rows; ++i) {
+      std::string record = "address_" + std::to_string(i % 1000) +
+                           DataLoaderService::kFieldSeparator + std::to_string(i);
+      auto begin = Clock::now();
+      data_loader_service.PushData(std::move(record));
+      latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now() - begin).count());
+    }
+    data_loader_service.StopIngest();
+    if (latencies.empty())
+      return 0;
+    auto p99 = latencies.begin() + (latencies.size() * 99) / 100;
+    std::nth_element(latencies.begin(), p99, latencies.end());
+    return *p99;
+  }
+
+  void AppendResult(std::ostringstream &json, bool &is_first, const std::string &backend,
+                    uint64_t rows, const std::string &bench_case, const std::string &metric,
+                    double value) {
+    json << (is_first ? "" : ",\n") << "    {\"backend\": \"" << backend
+         << "\", \"rows\": " << rows << ", \"case\": \"" << bench_case
+         << "\", \"" << metric << "\": " << static_cast<uint64_t>(value) << "}";
+    is_first = false;
+  }
+
+  // Run all cases against one backend, returns JSON result objects.
+  std::string RunBackend(const std::string &backend, uint64_t rows, bool is_pooled) {
+    // SQLite accepts allocator configuration only before it is initialized
+    if (is_pooled && MemoryPool::ConfigureSqlite(MemoryPool::SqliteOptions{}) != SQLITE_OK)
+      return "";
+    bool is_file = backend == "file";
+    std::string db_name = is_file ? "benchmark_db" : "file::memory:?cache=shared";
+    std::string service_db_name = "benchmark_service_db";
+    for (const auto &name : {db_name, service_db_name})
+      for (const auto &suffix : {"", "-wal", "-shm", "-journal"})
+        std::remove((name + suffix).c_str());
+
+    std::ostringstream json;
+    bool is_first{true};
+    auto &data_loader = DataLoader::GetDataLoaderInstance(db_name);
+    data_loader.SetDBTableStructTemplate({"address", "amount"});
+    if (data_loader.CreateDBTable("wallet_transactions") != SQLITE_OK)
+      return json.str();
+
+    auto autocommit_rows = std::min(rows, kAutocommitRowsLimit);
+    AppendResult(json, is_first, backend, autocommit_rows, "formatted_insert", "rows_per_sec",
+                 BenchmarkFormattedInsert(data_loader, autocommit_rows));
+    AppendResult(json, is_first, backend, autocommit_rows, "single_row_insert", "rows_per_sec",
+                 BenchmarkPreparedInsert(data_loader, autocommit_rows));
+    auto allocations = BenchmarkInsertAllocations(data_loader, autocommit_rows);
+    AppendResult(json, is_first, backend, autocommit_rows, "single_row_insert_heap_allocations",
+                 "allocations_per_1k_rows", allocations.heap);
+    AppendResult(json, is_first, backend, autocommit_rows,
+                 "single_row_insert_sqlite_allocations", "allocations_per_1k_rows",
+                 allocations.sqlite);
+    AppendResult(json, is_first, backend, rows, "batched_insert", "rows_per_sec",
+                 BenchmarkBatchInsert(data_loader, rows, kBatchSize));
+    AppendResult(json, is_first, backend, rows, "existence_check", "checks_per_sec",
+                 BenchmarkExistenceCheck(data_loader, rows));
+    AppendResult(json, is_first, backend, rows, "select_scan", "rows_per_sec",
+                 BenchmarkCursorScan(data_loader, 0));
+    AppendResult(json, is_first, backend, rows, "paged_select_scan", "rows_per_sec",
+                 BenchmarkCursorScan(data_loader, 10000));
+    AppendResult(json, is_first, backend, rows, "columnar_export", "rows_per_sec",
+                 BenchmarkColumnarExport(data_loader));
+    AppendResult(json, is_first, backend, rows, "columnar_scan", "rows_per_sec",
+                 BenchmarkColumnarScan());
+    AppendResult(json, is_first, backend, rows, "uncached_select", "selects_per_sec",
+                 BenchmarkRepeatedSelect(data_loader, 20, 0));
+    AppendResult(json, is_first, backend, rows, "cached_select", "selects_per_sec",
+                 BenchmarkRepeatedSelect(data_loader, 1000, std::size_t{1} << 30));
+    AppendResult(json, is_first, backend, rows, "result_cache_hit_ratio", "percent",
+                 data_loader.GetResultCacheMetrics().hit_ratio * 100);
+    data_loader.EnableResultCache(0);
+    auto import_report = BenchmarkCsvImport(data_loader, rows);
+    AppendResult(json, is_first, backend, rows, "csv_import", "rows_per_sec",
+                 import_report.rows_per_second);
+    AppendResult(json, is_first, backend, rows, "csv_import_throughput", "mb_per_sec",
+                 import_report.megabytes_per_second);
+    AppendResult(json, is_first, backend, rows, "typed_batched_insert", "rows_per_sec",
+                 BenchmarkTypedInsert(data_loader, rows, kBatchSize));
+    AppendResult(json, is_first, backend, rows, "balance_lookup", "lookups_per_sec",
+                 BenchmarkBalanceLookup(data_loader, rows));
+    AppendResult(json, is_first, backend, rows, "balance_aggregate_batched_insert",
+                 "rows_per_sec", BenchmarkTypedInsert(data_loader, rows, kBatchSize));
+
+    // profiles are compared last, the fastest one stays applied whatever its durability
+    if (is_file) {
+      std::vector<double> seconds;
+      auto profiles = crypto_wallet::client::StorageProfile::GetProfiles();
+      data_loader.AutoTuneStorageProfile(profiles, autocommit_rows, &seconds);
+      for (std::size_t i = 0; i < profiles.size() && i < seconds.size(); ++i)
+        AppendResult(json, is_first, backend, autocommit_rows,
+                     "storage_profile_" + profiles[i].name, "rows_per_sec",
+                     seconds[i] > 0 ? autocommit_rows / seconds[i] : 0);
+    }
+
+    // one writer per shard file, throughput is compared across shard counts
+    if (is_file) {
+      for (std::size_t shards_count : {1, 2, 4, 8}) {
+        auto sharded_result = BenchmarkSharded(rows, shards_count);
+        AppendResult(json, is_first, backend, rows,
+                     "sharded_insert_" + std::to_string(shards_count), "rows_per_sec",
+                     sharded_result.insert_rows_per_sec);
+        AppendResult(json, is_first, backend, rows,
+                     "sharded_scan_" + std::to_string(shards_count), "rows_per_sec",
+                     sharded_result.scan_rows_per_sec);
+      }
+    }
+
+    // repeated text columns stored in full against dictionary ids
+    if (is_file) {
+      for (bool is_encoded : {false, true}) {
+        auto dictionary_result = BenchmarkDictionary(rows, is_encoded);
+        std::string bench_case = is_encoded ? "dictionary_encoded_" : "dictionary_plain_";
+        AppendResult(json, is_first, backend, rows, bench_case + "insert", "rows_per_sec",
+                     dictionary_result.insert_rows_per_sec);
+        AppendResult(json, is_first, backend, rows, bench_case + "scan", "rows_per_sec",
+                     dictionary_result.scan_rows_per_sec);
+        AppendResult(json, is_first, backend, rows, bench_case + "size", "bytes",
+                     dictionary_result.size);
+      }
+    }
+
+    // wallet files opened on demand under the open handles budget
+    if (is_file) {
+      constexpr std::size_t kWalletsCount{256};
+      auto registry_result = BenchmarkRegistry(kWalletsCount);
+      AppendResult(json, is_first, backend, kWalletsCount, "registry_cold_open_p99", "ns",
+                   registry_result.cold_open_p99_ns);
+      AppendResult(json, is_first, backend, kWalletsCount, "registry_reopen_p99", "ns",
+                   registry_result.reopen_p99_ns);
+      AppendResult(json, is_first, backend, kWalletsCount, "registry_warm_acquire_p99", "ns",
+                   registry_result.warm_acquire_p99_ns);
+      AppendResult(json, is_first, backend, kWalletsCount, "registry_evictions", "count",
+                   registry_result.evictions);
+    }
+
+    // service database is file backed, in-memory shared cache would be the loader one
+    if (is_file) {
+      auto &data_loader_service = DataLoaderService::GetDataLoaderServiceInstance(service_db_name);
+      data_loader_service.SetDataBaseTableName("wallet_transactions");
+      data_loader_service.SetSqlScript("CREATE TABLE IF NOT EXISTS %1% (address, amount);");
+      data_loader_service.RunSqlScript();
+      data_loader_service.SetSqlScript("INSERT INTO %1% (address, amount) VALUES (?, ?);");
+      if (data_loader_service.StartIngest() == SQLITE_OK)
+        AppendResult(json, is_first, backend, rows, "ingest_enqueue_p99", "ns",
+                     BenchmarkIngestEnqueue(data_loader_service, rows));
+    }
+    return json.str();
+  }
+
+  // Run backend in a child process, DataLoader instances are kept open till exit.
+  std::string RunIsolated(const std::string &backend, uint64_t rows, bool is_pooled) {
+    int fds[2];
+    if (pipe(fds) != 0)
+      return "";
+    auto pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      auto json = RunBackend(backend, rows, is_pooled);
+      auto res = write(fds[1], json.data(), json.size());
+      _exit(res == static_cast<ssize_t>(json.size()) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fds[1]);
+    std::string json;
+    char buffer[4096];
+    ssize_t count{0};
+    while (pid > 0 && (count = read(fds[0], buffer, sizeof(buffer))) > 0)
+      json.append(buffer, static_cast<std::size_t>(count));
+    close(fds[0]);
+    int status{0};
+    if (pid > 0)
+      waitpid(pid, &status, 0);
+    return json;
+  }
+
+  std::vector<uint64_t> ParseRowCounts(const std::string &arg) {
+    std::vector<uint64_t> row_counts;
+    std::istringstream stream{arg};
+    std::string token;
+    while (std::getline(stream, token, ','))
+      if (auto rows = std::strtoull(token.c_str(), nullptr, 10))
+        row_counts.push_back(rows);
+    return row_counts;
+  }
+}
+
+/// Usage: data_loader_benchmark [rows[,rows...]] [memory|file|all] [system|pool]
+/// Row counts default to 1000,10000,100000, pass 1000000,10000000 for large runs.
+int main(int argc, char *argv[]) {
+  auto row_counts = ParseRowCounts((argc > 1) ? argv[1] : "1000,10000,100000");
+  std::string backend_arg = (argc > 2) ? argv[2] : "all";
+  std::string allocator = (argc > 3) ? argv[3] : "system";
+  std::vector<std::string> backends;
+  if (backend_arg == "all" || backend_arg == "memory")
+    backends.emplace_back("memory");
+  if (backend_arg == "all" || backend_arg == "file")
+    backends.emplace_back("file");
+  if (row_counts.empty() || backends.empty() || (allocator != "system" && allocator != "pool")) {
+    std::cerr << "usage: " << argv[0] << " [rows[,rows...]] [memory|file|all] [system|pool]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool is_failed{false};
+  std::string results;
+  for (const auto &backend : backends) {
+    for (auto rows : row_counts) {
+      auto json = RunIsolated(backend, rows, allocator == "pool");
+      is_failed |= json.empty();
+      if (!json.empty())
+        results += (results.empty() ? "" : ",\n") + json;
+    }
+  }
+  std::cout << "{\n  \"benchmark\": \"data_loader\",\n  \"sqlite_version\": \""
+            << sqlite3_libversion() << "\",\n  \"allocator\": \"" << allocator
+            << "\",\n  \"results\": [\n" << results << "\n  ]\n}"
+            << std::endl;
+  return is_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/// \file ingest_load_generator.cpp
+/// \brief Load generator measuring end to end ingest over the Unix socket.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+extern "C" {
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "data_loader_service/data_loader_service.h"
+#include "socket_connection/unix_connection.h"
+
+namespace {
+  using crypto_wallet::client::DataLoaderService;
+  using Clock = std::chrono::steady_clock;
+
+  constexpr std::size_t kRecordsPerWrite = 256;
+
+  int32_t ConnectClient(const std::string &socket_path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      close(fd);
+      fd = -1;
+    }
+    return fd;
+  }
+
+  bool WriteAll(int32_t fd, const std::string &buffer) {
+    std::size_t offset{0};
+    while (offset < buffer.size()) {
+      auto res = write(fd, buffer.data() + offset, buffer.size() - offset);
+      if (res < 0)
+        return false;
+      offset += res;
+    }
+    return true;
+  }
+
+  // Send records in writes of kRecordsPerWrite frames, collect write latency.
+  void RunClient(const std::string &socket_path, uint32_t client_id, uint64_t records,
+                 std::vector<uint64_t> &latencies) {
+    auto fd = ConnectClient(socket_path);
+    if (fd < 0) {
+      std::cout << "client " << client_id << " failed to connect " << std::strerror(errno)
+                << std::endl;
+      return;
+    }
+
+    std::string buffer;
+    for (uint64_t i = 0; i < records;) {
+      buffer.clear();
+      for (std::size_t j = 0; j < kRecordsPerWrite && i < records; ++j, ++i)
+        crypto_wallet::socket_communication::AppendFrame(buffer,
+            "address_" + std::to_string(client_id) + DataLoaderService::kFieldSeparator +
+            std::to_string(i));
+      auto begin = Clock::now();
+      if (!WriteAll(fd, buffer))
+        break;
+      latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now() - begin).count());
+    }
+    close(fd);
+  }
+}
+
+/// Usage: ingest_load_generator [clients] [records per client] [socket path]
+/// Service runs in-process, records travel through the real socket and queue.
+int main(int argc, char *argv[]) {
+  uint32_t clients = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4;
+  uint64_t records = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 100000;
+  std::string socket_path = (argc > 3) ? argv[3] : "/tmp/crypto_wallet_load_generator.sock";
+
+  auto &data_loader_service =
+      DataLoaderService::GetDataLoaderServiceInstance("load_generator_db");
+  data_loader_service.SetDataBaseTableName("wallet_transactions");
+  data_loader_service.SetSqlScript("CREATE TABLE IF NOT EXISTS %1% (address, amount);");
+  data_loader_service.RunSqlScript();
+  data_loader_service.SetSqlScript("INSERT INTO %1% (address, amount) VALUES (?, ?);");
+  data_loader_service.SetSocketPath(socket_path);
+  std::thread server{[&data_loader_service]() {
+    data_loader_service.SetAndProcessConnection();
+  }};
+  // wait for the listening socket
+  while (access(socket_path.c_str(), F_OK) != 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+  auto begin = Clock::now();
+  std::vector<std::vector<uint64_t>> latencies(clients);
+  std::vector<std::thread> client_threads;
+  for (uint32_t i = 0; i < clients; ++i)
+    client_threads.emplace_back(RunClient, socket_path, i, records, std::ref(latencies[i]));
+  for (auto &client_thread : client_threads)
+    client_thread.join();
+  auto sent = Clock::now();
+
+  uint64_t total = clients * records;
+  while (data_loader_service.GetConnectionMetrics().records < total &&
+         data_loader_service.GetConnectionMetrics().active_clients > 0)
+    std::this_thread::sleep_for(std::chrono::microseconds{100});
+  data_loader_service.StopConnection();
+  server.join();
+  data_loader_service.StopIngest();
+  auto written = Clock::now();
+
+  std::vector<uint64_t> all_latencies;
+  for (const auto &el : latencies)
+    all_latencies.insert(all_latencies.end(), el.begin(), el.end());
+  std::sort(all_latencies.begin(), all_latencies.end());
+  auto percentile = [&all_latencies](std::size_t pct) -> uint64_t {
+    return all_latencies.empty() ? 0 : all_latencies[(all_latencies.size() - 1) * pct / 100];
+  };
+
+  auto connection = data_loader_service.GetConnectionMetrics();
+  std::chrono::duration<double> send_time = sent - begin;
+  std::chrono::duration<double> total_time = written - begin;
+  std::cout << "clients: " << clients << std::endl
+            << "records received: " << connection.records << " of " << total << std::endl
+            << "clients paused by full queue: " << connection.paused_clients << std::endl
+            << "send, records/sec: " << total / send_time.count() << std::endl
+            << "end to end, records/sec: " << total / total_time.count() << std::endl
+            << "write of " << kRecordsPerWrite << " frames p50/p99, ns: " << percentile(50)
+            << "/" << percentile(99) << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+/// \file balance_aggregate.cpp
+/// \brief Source file containing class BalanceAggregate methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "balance_aggregate.h"
+
+#include <iostream>
+
+namespace {
+  const char *kNoteFunctionName = "balance_aggregate_note";
+
+  int32_t run_script(sqlite3 *database, const std::string &sql_script) {
+    char *err_msg{nullptr};
+    auto res = sqlite3_exec(database, sql_script.c_str(), nullptr, nullptr, &err_msg);
+    if (res != SQLITE_OK) {
+      // throw exception here
+      std::cout << "Balance aggregate script results in error: "
+                << (err_msg ? err_msg : sqlite3_errstr(res)) << std::endl;
+      sqlite3_free(err_msg);
+    }
+    return res;
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+BalanceAggregate::BalanceAggregate(const Options &options) : options_{options} {}
+
+BalanceAggregate::~BalanceAggregate() {
+  sqlite3_finalize(select_stmt_);
+  sqlite3_finalize(data_version_stmt_);
+  if (!database_)
+    return;
+
+  // temp triggers call back into this object
+  sqlite3_exec(database_, ("DROP TRIGGER IF EXISTS temp." + balances_table_name_ +
+                           "_cache_insert;DROP TRIGGER IF EXISTS temp." +
+                           balances_table_name_ + "_cache_delete;DROP TRIGGER IF EXISTS temp." +
+                           balances_table_name_ + "_cache_update;").c_str(),
+               nullptr, nullptr, nullptr);
+  sqlite3_create_function_v2(database_, kNoteFunctionName, 3, SQLITE_UTF8, nullptr, nullptr,
+                             nullptr, nullptr, nullptr);
+  sqlite3_rollback_hook(database_, nullptr, nullptr);
+}
+
+int32_t BalanceAggregate::Attach(sqlite3 *database, const std::string &table_name,
+                                 const std::string &address_column,
+                                 const std::string &amount_column) {
+  if (database_ || !sqlite3_get_autocommit(database))
+    return SQLITE_MISUSE;
+
+  database_ = database;
+  balances_table_name_ = table_name + "_balances";
+  const auto &balances = balances_table_name_;
+  const auto new_address = "NEW." + address_column;
+  const auto new_amount = "CAST(NEW." + amount_column + " AS INTEGER)";
+  const auto old_address = "OLD." + address_column;
+  const auto old_amount = "CAST(OLD." + amount_column + " AS INTEGER)";
+  recompute_sql_ = "SELECT " + address_column + " AS address, SUM(CAST(" + amount_column +
+                   " AS INTEGER)) AS balance, COUNT(*) AS transactions FROM main." +
+                   table_name + " WHERE " + address_column + " IS NOT NULL GROUP BY " +
+                   address_column;
+
+  auto res = sqlite3_create_function_v2(database_, kNoteFunctionName, 3, SQLITE_UTF8, this,
+                                        &BalanceAggregate::NoteDelta, nullptr, nullptr,
+                                        nullptr);
+  if (res != SQLITE_OK)
+    return res;
+  sqlite3_rollback_hook(database_, &BalanceAggregate::RollbackHook, this);
+
+  std::string sql_script =
+      "BEGIN;"
+      "CREATE TABLE IF NOT EXISTS main." + balances + " (address TEXT PRIMARY KEY NOT NULL, "
+      "balance INTEGER NOT NULL, transactions INTEGER NOT NULL) WITHOUT ROWID;"
+      // aggregate is built once, triggers keep it afterwards
+      "INSERT INTO main." + balances + " SELECT * FROM (" + recompute_sql_ + ") WHERE NOT "
+      "EXISTS (SELECT 1 FROM sqlite_master WHERE type = 'trigger' AND name = '" + balances +
+      "_insert');"
+      "CREATE TRIGGER IF NOT EXISTS main." + balances + "_insert AFTER INSERT ON " +
+      table_name + " WHEN " + new_address + " IS NOT NULL BEGIN INSERT INTO " + balances +
+      " (address, balance, transactions) VALUES (" + new_address + ", " + new_amount + ", 1) "
+      "ON CONFLICT (address) DO UPDATE SET balance = balance + excluded.balance, "
+      "transactions = transactions + 1; END;"
+      "CREATE TRIGGER IF NOT EXISTS main." + balances + "_delete AFTER DELETE ON " +
+      table_name + " WHEN " + old_address + " IS NOT NULL BEGIN UPDATE " + balances +
+      " SET balance = balance - " + old_amount + ", transactions = transactions - 1 "
+      "WHERE address = " + old_address + "; END;"
+      // update moves the old amount out and the new one in, address may change too
+      "CREATE TRIGGER IF NOT EXISTS main." + balances + "_update AFTER UPDATE OF " +
+      address_column + ", " + amount_column + " ON " + table_name + " BEGIN UPDATE " +
+      balances + " SET balance = balance - " + old_amount + ", transactions = transactions - 1 "
+      "WHERE address = " + old_address + "; INSERT INTO " + balances +
+      " (address, balance, transactions) SELECT " + new_address + ", " + new_amount + ", 1 "
+      "WHERE " + new_address + " IS NOT NULL ON CONFLICT (address) DO UPDATE SET "
+      "balance = balance + excluded.balance, transactions = transactions + 1; END;"
+      "CREATE TEMP TRIGGER IF NOT EXISTS " + balances + "_cache_insert AFTER INSERT ON main." +
+      table_name + " WHEN " + new_address + " IS NOT NULL BEGIN SELECT " + kNoteFunctionName +
+      "(" + new_address + ", " + new_amount + ", 1); END;"
+      "CREATE TEMP TRIGGER IF NOT EXISTS " + balances + "_cache_delete AFTER DELETE ON main." +
+      table_name + " WHEN " + old_address + " IS NOT NULL BEGIN SELECT " + kNoteFunctionName +
+      "(" + old_address + ", -" + old_amount + ", -1); END;"
+      "CREATE TEMP TRIGGER IF NOT EXISTS " + balances + "_cache_update AFTER UPDATE OF " +
+      address_column + ", " + amount_column + " ON main." + table_name + " BEGIN SELECT " +
+      kNoteFunctionName + "(" + old_address + ", -" + old_amount + ", -1) WHERE " +
+      old_address + " IS NOT NULL; SELECT " + kNoteFunctionName + "(" + new_address + ", " +
+      new_amount + ", 1) WHERE " + new_address + " IS NOT NULL; END;"
+      "COMMIT;";
+  res = run_script(database_, sql_script);
+  if (res != SQLITE_OK) {
+    if (!sqlite3_get_autocommit(database_))
+      sqlite3_exec(database_, "ROLLBACK;", nullptr, nullptr, nullptr);
+    return res;
+  }
+
+  res = sqlite3_prepare_v2(database_, ("SELECT balance, transactions FROM main." + balances +
+                                       " WHERE address = ?1;").c_str(),
+                           -1, &select_stmt_, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_prepare_v2(database_, "PRAGMA data_version;", -1, &data_version_stmt_,
+                             nullptr);
+  return res;
+}
+
+int32_t BalanceAggregate::GetBalance(const std::string &address, Balance &balance) {
+  balance = Balance{};
+  if (!select_stmt_)
+    return SQLITE_MISUSE;
+
+  auto res = CheckDataVersion(false);
+  if (res != SQLITE_OK)
+    return res;
+
+  auto it = cache_.find(address);
+  if (it != cache_.end()) {
+    cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    balance = it->second;
+    return SQLITE_OK;
+  }
+
+  cache_misses_.fetch_add(1, std::memory_order_relaxed);
+  sqlite3_bind_text(select_stmt_, 1, address.data(), static_cast<int>(address.size()),
+                    SQLITE_STATIC);
+  res = sqlite3_step(select_stmt_);
+  if (res == SQLITE_ROW)
+    balance = Balance{sqlite3_column_int64(select_stmt_, 0),
+                      sqlite3_column_int64(select_stmt_, 1)};
+  sqlite3_reset(select_stmt_);
+  if (res != SQLITE_ROW && res != SQLITE_DONE)
+    return res;
+
+  // unknown addresses are cached too, the trigger keeps them up to date
+  if (cache_.size() >= options_.max_cached_addresses)
+    DropCache();
+  cache_.emplace(address, balance);
+  return SQLITE_OK;
+}
+
+int32_t BalanceAggregate::Verify(std::vector<Mismatch> &mismatches) {
+  mismatches.clear();
+  if (!select_stmt_)
+    return SQLITE_MISUSE;
+
+  auto res = CheckDataVersion(true);
+  if (res != SQLITE_OK)
+    return res;
+
+  const auto &balances = balances_table_name_;
+  std::string verify_sql =
+      "WITH fresh AS (" + recompute_sql_ + ") "
+      "SELECT f.address, f.balance, f.transactions, b.balance, b.transactions FROM fresh AS f "
+      "LEFT JOIN main." + balances + " AS b ON b.address = f.address "
+      "WHERE b.address IS NULL OR b.balance != f.balance OR b.transactions != f.transactions "
+      "UNION ALL "
+      "SELECT b.address, 0, 0, b.balance, b.transactions FROM main." + balances + " AS b "
+      "WHERE b.transactions != 0 AND b.address NOT IN (SELECT address FROM fresh);";
+  sqlite3_stmt *stmt{nullptr};
+  res = sqlite3_prepare_v2(database_, verify_sql.c_str(), -1, &stmt, nullptr);
+  if (res != SQLITE_OK)
+    return res;
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW) {
+    auto address = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    mismatches.push_back(Mismatch{address ? address : "",
+                                  Balance{sqlite3_column_int64(stmt, 1),
+                                          sqlite3_column_int64(stmt, 2)},
+                                  Balance{sqlite3_column_int64(stmt, 3),
+                                          sqlite3_column_int64(stmt, 4)}});
+  }
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_DONE)
+    return res;
+
+  // cached entries are diffed with the aggregate table
+  for (const auto &entry : cache_) {
+    Balance stored{};
+    sqlite3_bind_text(select_stmt_, 1, entry.first.data(),
+                      static_cast<int>(entry.first.size()), SQLITE_STATIC);
+    res = sqlite3_step(select_stmt_);
+    if (res == SQLITE_ROW)
+      stored = Balance{sqlite3_column_int64(select_stmt_, 0),
+                       sqlite3_column_int64(select_stmt_, 1)};
+    sqlite3_reset(select_stmt_);
+    if (res != SQLITE_ROW && res != SQLITE_DONE)
+      return res;
+    if (stored.balance != entry.second.balance ||
+        stored.transactions != entry.second.transactions)
+      mismatches.push_back(Mismatch{entry.first, stored, entry.second});
+  }
+  return SQLITE_OK;
+}
+
+int32_t BalanceAggregate::Rebuild() {
+  if (!select_stmt_ || !sqlite3_get_autocommit(database_))
+    return SQLITE_MISUSE;
+
+  auto res = run_script(database_, "BEGIN;DELETE FROM main." + balances_table_name_ +
+                                   ";INSERT INTO main." + balances_table_name_ + " " +
+                                   recompute_sql_ + ";COMMIT;");
+  if (res != SQLITE_OK && !sqlite3_get_autocommit(database_))
+    sqlite3_exec(database_, "ROLLBACK;", nullptr, nullptr, nullptr);
+  DropCache();
+  return res;
+}
+
+BalanceAggregate::Metrics BalanceAggregate::GetMetrics() const noexcept {
+  return Metrics{cache_hits_.load(std::memory_order_relaxed),
+                 cache_misses_.load(std::memory_order_relaxed),
+                 cache_drops_.load(std::memory_order_relaxed),
+                 applied_rows_.load(std::memory_order_relaxed)};
+}
+
+void BalanceAggregate::DropCache() {
+  if (cache_.empty())
+    return;
+  cache_.clear();
+  cache_drops_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BalanceAggregate::NoteDelta(sqlite3_context *context, int argc, sqlite3_value **argv) {
+  auto balance_aggregate = static_cast<BalanceAggregate *>(sqlite3_user_data(context));
+  if (argc != 3 || sqlite3_value_type(argv[0]) == SQLITE_NULL)
+    return;
+
+  balance_aggregate->applied_rows_.fetch_add(1, std::memory_order_relaxed);
+  auto &cache = balance_aggregate->cache_;
+  if (cache.empty())
+    return;
+  auto address = reinterpret_cast<const char *>(sqlite3_value_text(argv[0]));
+  balance_aggregate->scratch_address_.assign(
+      address, static_cast<std::size_t>(sqlite3_value_bytes(argv[0])));
+  auto it = cache.find(balance_aggregate->scratch_address_);
+  if (it == cache.end())
+    return;
+  it->second.balance += sqlite3_value_int64(argv[1]);
+  it->second.transactions += sqlite3_value_int64(argv[2]);
+}
+
+void BalanceAggregate::RollbackHook(void *balance_aggregate) {
+  static_cast<BalanceAggregate *>(balance_aggregate)->DropCache();
+}
+
+int32_t BalanceAggregate::CheckDataVersion(bool is_forced) {
+  auto now = std::chrono::steady_clock::now();
+  if (!is_forced && data_version_ >= 0 &&
+      now - data_version_time_ < options_.data_version_check_interval)
+    return SQLITE_OK;
+
+  data_version_time_ = now;
+  auto res = sqlite3_step(data_version_stmt_);
+  auto data_version = (res == SQLITE_ROW) ? sqlite3_column_int64(data_version_stmt_, 0) : -1;
+  sqlite3_reset(data_version_stmt_);
+  if (res != SQLITE_ROW)
+    return res;
+
+  if (data_version != data_version_)
+    DropCache();
+  data_version_ = data_version;
+  return SQLITE_OK;
+}
+
+} // namespace client
+} // namespace crypto_wallet
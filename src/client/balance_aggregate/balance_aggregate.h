@@ -0,0 +1,158 @@
+/// \file balance_aggregate.h
+/// \brief Class maintaining per-address balances of the transactions table.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_BALANCE_AGGREGATE_H_
+#define CRYPTO_WALLET_CLIENT_BALANCE_AGGREGATE_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class BalanceAggregate balance_aggregate.h.
+/// \brief Materialized SUM(amount), COUNT(*) GROUP BY address of a table.
+/// \details Table <table>_balances is kept by triggers, so every insert, delete or
+/// \details update of the address or amount changes it in the same transaction whatever
+/// \details connection runs it. Balances read through the connection are cached in
+/// \details process, temp triggers apply deltas of the connection to the cached
+/// \details entries, rollback and commits of other connections (data_version, polled
+/// \details every few milliseconds) drop the cache. Amounts are integers.
+/// \details Lookups run on the thread writing through the connection. ROLLBACK TO
+/// \details a savepoint is not tracked by SQLite hooks, Verify reports the cache then.
+class BalanceAggregate {
+ public:
+  /// \struct Options balance_aggregate.h.
+  /// \brief Cache limits.
+  struct Options {
+    // cache is dropped once it grows over the limit
+    std::size_t max_cached_addresses{1000000};
+    // data_version check takes a read lock, commits of other connections are seen
+    // this late at most
+    std::chrono::milliseconds data_version_check_interval{10};
+  };
+
+  /// \struct Balance balance_aggregate.h.
+  /// \brief Aggregate of one address.
+  struct Balance {
+    int64_t balance{0};
+    int64_t transactions{0};
+  };
+
+  /// \struct Mismatch balance_aggregate.h.
+  /// \brief Address whose aggregate differs from the recomputed one.
+  struct Mismatch {
+    std::string address{};
+    Balance expected{};
+    Balance actual{};
+  };
+
+  /// \struct Metrics balance_aggregate.h.
+  /// \brief Cache counters.
+  struct Metrics {
+    uint64_t cache_hits{0};
+    uint64_t cache_misses{0};
+    uint64_t cache_drops{0};
+    uint64_t applied_rows{0};
+  };
+
+  /// \brief BalanceAggregate constructor.
+  /// \param[in] options Cache limits.
+  explicit BalanceAggregate(const Options &options);
+
+  /// \brief BalanceAggregate destructor, removes the connection hooks.
+  ~BalanceAggregate();
+
+  /// \brief Class BalanceAggregate copy constructor.
+  /// \param[in] balance_aggregate Class BalanceAggregate object.
+  BalanceAggregate(const BalanceAggregate &balance_aggregate) = delete;
+
+  /// \brief Class BalanceAggregate copy assignment.
+  /// \param[in] balance_aggregate Class BalanceAggregate object.
+  /// \return BalanceAggregate object.
+  BalanceAggregate &operator=(const BalanceAggregate &balance_aggregate) = delete;
+
+  /// \brief Create aggregate table and triggers, built from the table if it is new.
+  /// \details Must be called outside of transaction. Installs the rollback hook.
+  /// \param[in] database Connection.
+  /// \param[in] table_name Transactions table.
+  /// \param[in] address_column Address column.
+  /// \param[in] amount_column Amount column.
+  /// \return Result of the setup.
+  int32_t Attach(sqlite3 *database, const std::string &table_name,
+                 const std::string &address_column, const std::string &amount_column);
+
+  /// \brief Get balance of the address as seen by the connection.
+  /// \param[in] address Address.
+  /// \param[out] balance Aggregate, zero for unknown address.
+  /// \return Result of the lookup.
+  int32_t GetBalance(const std::string &address, Balance &balance);
+
+  /// \brief Recompute balances from the table and diff them with the aggregate
+  /// \brief table and the cache.
+  /// \param[out] mismatches Addresses that differ, expected is the recomputed value.
+  /// \return Result of the recomputation.
+  int32_t Verify(std::vector<Mismatch> &mismatches);
+
+  /// \brief Recompute aggregate table from scratch, must be called outside of transaction.
+  /// \return Result of the rebuild.
+  int32_t Rebuild();
+
+  /// \brief Get aggregate table name.
+  /// \return Table name.
+  inline std::string GetTableName() const { return balances_table_name_; }
+
+  /// \brief Get cache counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const noexcept;
+
+ private:
+  /// \brief Drop the cached balances.
+  void DropCache();
+
+  /// \brief SQL function called by the temp trigger: note(address, amount, count).
+  static void NoteDelta(sqlite3_context *context, int argc, sqlite3_value **argv);
+
+  /// \brief Rollback hook, cached deltas of the transaction are gone.
+  static void RollbackHook(void *balance_aggregate);
+
+  /// \brief Drop cache if other connection committed since the last check.
+  /// \param[in] is_forced Check even if the interval has not passed.
+  /// \return Result of the check.
+  int32_t CheckDataVersion(bool is_forced);
+
+  Options options_;
+  sqlite3 *database_{nullptr};
+  std::string balances_table_name_{};
+  std::string recompute_sql_{};
+  sqlite3_stmt *select_stmt_{nullptr};
+  sqlite3_stmt *data_version_stmt_{nullptr};
+  int64_t data_version_{-1};
+  std::chrono::steady_clock::time_point data_version_time_{};
+  std::unordered_map<std::string, Balance> cache_{};
+  // trigger lookups reuse its capacity
+  std::string scratch_address_{};
+  std::atomic<uint64_t> cache_hits_{0};
+  std::atomic<uint64_t> cache_misses_{0};
+  std::atomic<uint64_t> cache_drops_{0};
+  std::atomic<uint64_t> applied_rows_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_BALANCE_AGGREGATE_H_
@@ -0,0 +1,72 @@
+/// \file batch_writer.cpp
+/// \brief Source file containing class BatchWriter methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "batch_writer.h"
+
+#include <utility>
+
+namespace crypto_wallet {
+namespace client {
+
+BatchWriter::BatchWriter(DataLoader &data_loader, std::size_t max_rows,
+                         std::chrono::milliseconds max_delay)
+    : data_loader_{data_loader}, max_rows_{max_rows ? max_rows : 1}, max_delay_{max_delay} {
+  rows_.reserve(max_rows_);
+}
+
+BatchWriter::~BatchWriter() {
+  Flush();
+}
+
+int32_t BatchWriter::Add(const std::vector<std::string> &row) {
+  if (rows_.empty())
+    first_row_time_ = std::chrono::steady_clock::now();
+  rows_.push_back(row);
+  return FlushIfNeeded();
+}
+
+int32_t BatchWriter::Add(std::vector<std::string> &&row) {
+  if (rows_.empty())
+    first_row_time_ = std::chrono::steady_clock::now();
+  rows_.push_back(std::move(row));
+  return FlushIfNeeded();
+}
+
+int32_t BatchWriter::FlushIfExpired() {
+  if (rows_.empty() || std::chrono::steady_clock::now() - first_row_time_ < max_delay_)
+    return SQLITE_OK;
+  return Flush();
+}
+
+int32_t BatchWriter::Flush() {
+  if (rows_.empty())
+    return SQLITE_OK;
+
+  auto res = data_loader_.InsertBatch(rows_, &row_results_);
+  for (std::size_t i = 0; i < rows_.size(); ++i) {
+    if (row_results_[i] == SQLITE_OK)
+      continue;
+    ++failed_rows_count_;
+    if (failure_handler_)
+      failure_handler_(rows_[i], row_results_[i]);
+  }
+
+  rows_.clear();
+  return res;
+}
+
+void BatchWriter::SetFailureHandler(FailureHandler failure_handler) {
+  failure_handler_ = std::move(failure_handler);
+}
+
+int32_t BatchWriter::FlushIfNeeded() {
+  if (rows_.size() >= max_rows_)
+    return Flush();
+  return FlushIfExpired();
+}
+
+} // namespace client
+} // namespace crypt_wallet
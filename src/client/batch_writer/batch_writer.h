@@ -0,0 +1,101 @@
+/// \file batch_writer.h
+/// \brief Class grouping inserted rows into transactions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_BATCH_WRITER_H_
+#define CRYPTO_WALLET_CLIENT_BATCH_WRITER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "data_loader/data_loader.h"
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class BatchWriter batch_writer.h.
+/// \brief Class buffering rows and flushing them with DataLoader::InsertBatch
+/// \brief once row count or time threshold is reached, whichever comes first.
+class BatchWriter {
+ public:
+  /// \brief Row failure handler.
+  /// \param[in] row Row failed to be inserted.
+  /// \param[in] result Result of the row insert.
+  using FailureHandler = std::function<void(const std::vector<std::string> &row,
+                                            int32_t result)>;
+
+  /// \brief BatchWriter constructor.
+  /// \param[in] data_loader DataLoader rows are written with.
+  /// \param[in] max_rows Row count flush threshold.
+  /// \param[in] max_delay Time flush threshold counted from the first buffered row.
+  BatchWriter(DataLoader &data_loader, std::size_t max_rows = 1000,
+              std::chrono::milliseconds max_delay = std::chrono::milliseconds{100});
+
+  /// \brief BatchWriter destructor, flushes buffered rows.
+  ~BatchWriter();
+
+  /// \brief Class BatchWriter copy constructor.
+  /// \param[in] batch_writer Class BatchWriter object.
+  BatchWriter(const BatchWriter &batch_writer) = delete;
+
+  /// \brief Class BatchWriter copy assignment.
+  /// \param[in] batch_writer Class BatchWriter object.
+  /// \return BatchWriter object.
+  BatchWriter &operator=(const BatchWriter &batch_writer) = delete;
+
+  /// \brief Buffer row, flush if any threshold is reached.
+  /// \param[in] row Row values.
+  /// \return Result of the flush if it happened, SQLITE_OK otherwise.
+  int32_t Add(const std::vector<std::string> &row);
+  int32_t Add(std::vector<std::string> &&row);
+
+  /// \brief Flush buffered rows if time threshold is reached.
+  /// \return Result of the flush if it happened, SQLITE_OK otherwise.
+  int32_t FlushIfExpired();
+
+  /// \brief Write all buffered rows in one transaction.
+  /// \return Result of the batch insert.
+  int32_t Flush();
+
+  /// \brief Set handler called for every row failed to be inserted.
+  /// \param[in] failure_handler Row failure handler.
+  void SetFailureHandler(FailureHandler failure_handler);
+
+  /// \brief Get number of buffered rows.
+  /// \return Number of buffered rows.
+  inline std::size_t GetPendingRowsCount() const noexcept {
+    return rows_.size();
+  }
+
+  /// \brief Get number of rows failed to be inserted.
+  /// \return Number of failed rows.
+  inline uint64_t GetFailedRowsCount() const noexcept {
+    return failed_rows_count_;
+  }
+
+ private:
+  /// \brief Flush if any threshold is reached.
+  /// \return Result of the flush if it happened, SQLITE_OK otherwise.
+  int32_t FlushIfNeeded();
+
+  DataLoader &data_loader_;
+  std::size_t max_rows_{1000};
+  std::chrono::milliseconds max_delay_{100};
+  std::chrono::steady_clock::time_point first_row_time_{};
+  std::vector<std::vector<std::string>> rows_{};
+  std::vector<int32_t> row_results_{};
+  FailureHandler failure_handler_{};
+  uint64_t failed_rows_count_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_BATCH_WRITER_H_
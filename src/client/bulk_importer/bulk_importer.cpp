@@ -0,0 +1,394 @@
+/// \file bulk_importer.cpp
+/// \brief Source file containing class BulkImporter methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "bulk_importer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <thread>
+
+#include "mpsc_queue/mpsc_queue.h"
+
+namespace {
+  using crypto_wallet::client::BulkImporter;
+
+  constexpr std::size_t kBlockSize = 64;
+
+  // Bit i is set if block[i] is the delimiter or a newline.
+  using MaskFunction = uint64_t (*)(const char *block, char delimiter);
+
+  uint64_t ScalarMask(const char *block, char delimiter) {
+    uint64_t mask{0};
+    for (std::size_t i = 0; i < kBlockSize; ++i)
+      if (block[i] == delimiter || block[i] == '\n')
+        mask |= uint64_t{1} << i;
+    return mask;
+  }
+
+#if defined(__SSE2__)
+  uint64_t Sse2Mask(const char *block, char delimiter) {
+    const auto delimiters = _mm_set1_epi8(delimiter);
+    const auto newlines = _mm_set1_epi8('\n');
+    uint64_t mask{0};
+    for (std::size_t i = 0; i < kBlockSize; i += 16) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+      auto matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiters),
+                                  _mm_cmpeq_epi8(chunk, newlines));
+      mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(matches))) << i;
+    }
+    return mask;
+  }
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+  // compiled for AVX2 whatever the build flags are, called only if the CPU has it
+  __attribute__((target("avx2"))) uint64_t Avx2Mask(const char *block, char delimiter) {
+    const auto delimiters = _mm256_set1_epi8(delimiter);
+    const auto newlines = _mm256_set1_epi8('\n');
+    auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+    auto low_mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(low, delimiters), _mm256_cmpeq_epi8(low, newlines))));
+    auto high_mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(high, delimiters),
+                        _mm256_cmpeq_epi8(high, newlines))));
+    return static_cast<uint64_t>(low_mask) | (static_cast<uint64_t>(high_mask) << 32);
+  }
+#endif
+
+  BulkImporter::SimdLevel ResolveSimdLevel(BulkImporter::SimdLevel simd_level) {
+    auto supported = BulkImporter::GetSupportedSimdLevel();
+    if (simd_level == BulkImporter::SimdLevel::kAuto ||
+        static_cast<int>(simd_level) > static_cast<int>(supported))
+      return supported;
+    return simd_level;
+  }
+
+  MaskFunction GetMaskFunction(BulkImporter::SimdLevel simd_level) {
+    switch (simd_level) {
+#if defined(__x86_64__) || defined(__i386__)
+      case BulkImporter::SimdLevel::kAvx2:
+        return &Avx2Mask;
+#endif
+#if defined(__SSE2__)
+      case BulkImporter::SimdLevel::kSse2:
+        return &Sse2Mask;
+#endif
+      default:
+        return &ScalarMask;
+    }
+  }
+
+  // Finds delimiters and newlines, the mask of the current 64 byte block is reused
+  // until the position leaves it.
+  class SeparatorScanner {
+   public:
+    SeparatorScanner(const char *end, char delimiter, MaskFunction mask_function)
+        : end_{end}, delimiter_{delimiter}, mask_function_{mask_function} {}
+
+    // First separator at or after pos, end if there is none.
+    const char *Next(const char *pos) {
+      while (pos < end_) {
+        if (!block_ || pos < block_ || pos >= block_ + kBlockSize) {
+          block_ = pos;
+          mask_ = (static_cast<std::size_t>(end_ - pos) >= kBlockSize) ?
+                      mask_function_(pos, delimiter_) : TailMask(pos);
+        }
+        auto mask = mask_ & (~uint64_t{0} << (pos - block_));
+        if (mask)
+          return block_ + __builtin_ctzll(mask);
+        pos = block_ + kBlockSize;
+      }
+      return end_;
+    }
+
+   private:
+    uint64_t TailMask(const char *pos) const {
+      uint64_t mask{0};
+      for (std::size_t i = 0; pos + i < end_; ++i)
+        if (pos[i] == delimiter_ || pos[i] == '\n')
+          mask |= uint64_t{1} << i;
+      return mask;
+    }
+
+    const char *end_;
+    char delimiter_;
+    MaskFunction mask_function_;
+    const char *block_{nullptr};
+    uint64_t mask_{0};
+  };
+
+  class RowParser {
+   public:
+    RowParser(std::string_view text, char delimiter, BulkImporter::SimdLevel simd_level)
+        : pos_{text.data()}, end_{text.data() + text.size()},
+          scanner_{end_, delimiter, GetMaskFunction(simd_level)} {}
+
+    // Append fields of the next row, false once the text is over. Quoted field with
+    // doubled quotes is unescaped into a string appended to unescaped, deque keeps
+    // the strings in place so the views stay valid while it grows.
+    bool NextRow(std::vector<std::string_view> &fields, std::size_t &count,
+                 std::deque<std::string> &unescaped) {
+      count = 0;
+      if (pos_ >= end_)
+        return false;
+
+      auto pos = pos_;
+      while (true) {
+        const char *field_begin{pos};
+        const char *field_end{nullptr};
+        const char *separator{nullptr};
+        bool is_quoted{pos < end_ && *pos == '"'};
+        bool is_escaped{false};
+        if (is_quoted) {
+          ++field_begin;
+          field_end = FindClosingQuote(field_begin, is_escaped);
+          separator = (field_end < end_) ? scanner_.Next(field_end + 1) : end_;
+        } else {
+          separator = scanner_.Next(pos);
+          field_end = separator;
+        }
+        bool is_row_end = separator >= end_ || *separator == '\n';
+        if (is_row_end && !is_quoted && field_end > field_begin && field_end[-1] == '\r')
+          --field_end;
+        if (is_escaped)
+          fields.emplace_back(Unescape(field_begin, field_end, unescaped));
+        else
+          fields.emplace_back(field_begin, static_cast<std::size_t>(field_end - field_begin));
+        ++count;
+        if (is_row_end) {
+          pos_ = (separator < end_) ? separator + 1 : end_;
+          return true;
+        }
+        pos = separator + 1;
+      }
+    }
+
+   private:
+    // Doubled quotes are skipped, is_escaped is set if there were any.
+    const char *FindClosingQuote(const char *pos, bool &is_escaped) const {
+      while (pos < end_) {
+        auto quote = static_cast<const char *>(std::memchr(pos, '"',
+                                                           static_cast<std::size_t>(end_ - pos)));
+        if (!quote)
+          return end_;
+        if (quote + 1 < end_ && quote[1] == '"') {
+          is_escaped = true;
+          pos = quote + 2;
+          continue;
+        }
+        return quote;
+      }
+      return end_;
+    }
+
+    static std::string_view Unescape(const char *begin, const char *end,
+                                     std::deque<std::string> &unescaped) {
+      auto &value = unescaped.emplace_back();
+      value.reserve(static_cast<std::size_t>(end - begin));
+      for (auto pos = begin; pos < end; ++pos) {
+        value.push_back(*pos);
+        if (*pos == '"' && pos + 1 < end && pos[1] == '"')
+          ++pos;
+      }
+      return value;
+    }
+
+    const char *pos_;
+    const char *end_;
+    SeparatorScanner scanner_;
+  };
+
+  struct RowBatch {
+    std::vector<std::string_view> values{};
+    // values of the quoted fields with doubled quotes, viewed from values
+    std::deque<std::string> unescaped{};
+    std::size_t columns_count{0};
+    uint64_t malformed_rows{0};
+  };
+
+  template <typename T>
+  void Push(crypto_wallet::client::MpscQueue<T> &queue, T &&value) {
+    while (!queue.TryPush(std::move(value)))
+      std::this_thread::yield();
+  }
+
+  template <typename T>
+  void Pop(crypto_wallet::client::MpscQueue<T> &queue, T &value) {
+    while (!queue.TryPop(value))
+      std::this_thread::yield();
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+BulkImporter::BulkImporter(DataLoader &data_loader, const Options &options)
+    : data_loader_{data_loader}, options_{options} {
+  options_.rows_per_batch = std::max<std::size_t>(options_.rows_per_batch, 1);
+  options_.batches_in_flight = std::max<std::size_t>(options_.batches_in_flight, 2);
+}
+
+BulkImporter::SimdLevel BulkImporter::GetSupportedSimdLevel() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx2"))
+    return SimdLevel::kAvx2;
+#endif
+#if defined(__SSE2__)
+  return SimdLevel::kSse2;
+#else
+  return SimdLevel::kScalar;
+#endif
+}
+
+void BulkImporter::Split(std::string_view text, char delimiter, SimdLevel simd_level,
+                         std::vector<std::string_view> &fields,
+                         std::vector<std::size_t> &fields_per_row,
+                         std::deque<std::string> &unescaped) {
+  fields.clear();
+  fields_per_row.clear();
+  unescaped.clear();
+  RowParser parser{text, delimiter, ResolveSimdLevel(simd_level)};
+  std::size_t count{0};
+  while (parser.NextRow(fields, count, unescaped))
+    fields_per_row.push_back(count);
+}
+
+/// Parser and inserter exchange batches through two queues: parsed ones go to the
+/// inserter, inserted ones come back empty with their capacity.
+int32_t BulkImporter::Import(const std::string &file_path, Report &report) {
+  report = Report{};
+  report.simd_level = ResolveSimdLevel(options_.simd_level);
+  auto start = std::chrono::steady_clock::now();
+
+  auto fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return SQLITE_CANTOPEN;
+  struct stat sb{};
+  if (fstat(fd, &sb) != 0) {
+    close(fd);
+    return SQLITE_CANTOPEN;
+  }
+  auto size = static_cast<std::size_t>(sb.st_size);
+  void *mapping{nullptr};
+  if (size) {
+    mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      return SQLITE_CANTOPEN;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+  report.bytes = size;
+  if (!size)
+    return SQLITE_OK;
+
+  bool is_bulk_load = options_.is_bulk_load && data_loader_.BeginBulkLoad() == SQLITE_OK;
+
+  MpscQueue<RowBatch> parsed_batches{options_.batches_in_flight};
+  MpscQueue<RowBatch> free_batches{options_.batches_in_flight};
+  for (std::size_t i = 0; i < options_.batches_in_flight; ++i)
+    Push(free_batches, RowBatch{});
+  std::atomic<bool> is_parsed{false};
+
+  std::thread parser_thread{[&]() {
+    RowParser parser{std::string_view{static_cast<const char *>(mapping), size},
+                     options_.delimiter, report.simd_level};
+    RowBatch batch;
+    Pop(free_batches, batch);
+    std::size_t columns_count{options_.columns_count};
+    std::size_t count{0};
+    std::size_t batch_rows{0};
+    if (options_.is_header_skipped && parser.NextRow(batch.values, count, batch.unescaped))
+      batch.values.clear();
+
+    auto row_begin = batch.values.size();
+    while (parser.NextRow(batch.values, count, batch.unescaped)) {
+      if (count == 1 && batch.values.back().empty()) {
+        batch.values.pop_back();
+        continue;
+      }
+      columns_count = columns_count ? columns_count : count;
+      if (count != columns_count) {
+        batch.values.resize(row_begin);
+        ++batch.malformed_rows;
+        continue;
+      }
+      row_begin = batch.values.size();
+      if (++batch_rows == options_.rows_per_batch) {
+        batch.columns_count = columns_count;
+        Push(parsed_batches, std::move(batch));
+        Pop(free_batches, batch);
+        batch_rows = 0;
+        row_begin = 0;
+      }
+    }
+    if (batch_rows || batch.malformed_rows) {
+      batch.columns_count = columns_count;
+      Push(parsed_batches, std::move(batch));
+    }
+    is_parsed.store(true, std::memory_order_release);
+  }};
+
+  int32_t res{SQLITE_OK};
+  RowBatch batch;
+  std::vector<int32_t> row_results;
+  while (true) {
+    if (!parsed_batches.TryPop(batch)) {
+      if (is_parsed.load(std::memory_order_acquire) && !parsed_batches.TryPop(batch))
+        break;
+      std::this_thread::yield();
+      continue;
+    }
+    report.malformed_rows += batch.malformed_rows;
+    if (!batch.values.empty()) {
+      auto batch_res = data_loader_.InsertBatch(batch.values, batch.columns_count,
+                                                &row_results);
+      res = (batch_res != SQLITE_OK) ? batch_res : res;
+      auto failed = static_cast<uint64_t>(std::count_if(
+          row_results.begin(), row_results.end(),
+          [](int32_t row_res) { return row_res != SQLITE_OK; }));
+      report.failed_rows += failed;
+      report.rows += row_results.size() - failed;
+    }
+    batch.values.clear();
+    batch.unescaped.clear();
+    batch.malformed_rows = 0;
+    Push(free_batches, std::move(batch));
+  }
+  parser_thread.join();
+  munmap(mapping, size);
+
+  if (is_bulk_load) {
+    auto bulk_res = data_loader_.EndBulkLoad();
+    res = (bulk_res != SQLITE_OK) ? bulk_res : res;
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  report.seconds = elapsed.count();
+  if (report.seconds > 0) {
+    report.rows_per_second = report.rows / report.seconds;
+    report.megabytes_per_second = report.bytes / 1e6 / report.seconds;
+  }
+  return res;
+}
+
+} // namespace client
+} // namespace crypto_wallet
@@ -0,0 +1,123 @@
+/// \file bulk_importer.h
+/// \brief Class importing delimited text dumps into the loader table.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_BULK_IMPORTER_H_
+#define CRYPTO_WALLET_CLIENT_BULK_IMPORTER_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data_loader/data_loader.h"
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class BulkImporter bulk_importer.h.
+/// \brief CSV importer reading the memory mapped file.
+/// \details Parser thread finds delimiters and newlines 64 bytes at a time with SIMD
+/// \details compares and hands rows as string_views into the mapping to the calling
+/// \details thread, which inserts them with DataLoader::InsertBatch while the next
+/// \details batch is parsed. A field in double quotes may contain delimiters and
+/// \details newlines, doubled quotes inside it stand for one quote. Only such fields
+/// \details are copied, unescaped into a buffer of the batch.
+class BulkImporter {
+ public:
+  /// \enum SimdLevel bulk_importer.h.
+  /// \brief Instruction set of the delimiter search.
+  enum class SimdLevel {
+    kAuto,
+    kScalar,
+    kSse2,
+    kAvx2
+  };
+
+  /// \struct Options bulk_importer.h.
+  /// \brief Import options.
+  struct Options {
+    char delimiter{','};
+    bool is_header_skipped{false};
+    // 0 takes the number of fields of the first row
+    std::size_t columns_count{0};
+    std::size_t rows_per_batch{10000};
+    // batches parsed ahead of the inserts
+    std::size_t batches_in_flight{4};
+    SimdLevel simd_level{SimdLevel::kAuto};
+    // declared indexes are suspended during the import
+    bool is_bulk_load{true};
+  };
+
+  /// \struct Report bulk_importer.h.
+  /// \brief Import results.
+  struct Report {
+    uint64_t rows{0};
+    uint64_t failed_rows{0};
+    // rows whose number of fields differs from columns_count, skipped
+    uint64_t malformed_rows{0};
+    uint64_t bytes{0};
+    double seconds{0.0};
+    double rows_per_second{0.0};
+    double megabytes_per_second{0.0};
+    SimdLevel simd_level{SimdLevel::kScalar};
+  };
+
+  /// \brief BulkImporter constructor.
+  /// \param[in] data_loader Loader, its current table receives the rows.
+  /// \param[in] options Import options.
+  BulkImporter(DataLoader &data_loader, const Options &options);
+
+  /// \brief Class BulkImporter copy constructor.
+  /// \param[in] bulk_importer Class BulkImporter object.
+  BulkImporter(const BulkImporter &bulk_importer) = delete;
+
+  /// \brief Class BulkImporter copy assignment.
+  /// \param[in] bulk_importer Class BulkImporter object.
+  /// \return BulkImporter object.
+  BulkImporter &operator=(const BulkImporter &bulk_importer) = delete;
+
+  /// \brief Import the file, must be called on the thread using the loader.
+  /// \param[in] file_path File path.
+  /// \param[out] report Import results.
+  /// \return SQLITE_CANTOPEN if file cannot be mapped, otherwise result of the last
+  /// \return failed batch or SQLITE_OK.
+  int32_t Import(const std::string &file_path, Report &report);
+
+  /// \brief Get best instruction set supported by the CPU.
+  /// \return SIMD level.
+  static SimdLevel GetSupportedSimdLevel() noexcept;
+
+  /// \brief Split text into rows of fields.
+  /// \details Used by Import on the parser thread, exposed for the benchmarks.
+  /// \param[in] text Text.
+  /// \param[in] delimiter Field delimiter.
+  /// \param[in] simd_level SIMD level, kAuto selects the supported one.
+  /// \param[out] fields Fields of all rows one row after another.
+  /// \param[out] fields_per_row Number of fields of every row.
+  /// \param[out] unescaped Unescaped values of the quoted fields with doubled quotes,
+  /// \param[out] their fields view it, other fields view the text.
+  static void Split(std::string_view text, char delimiter, SimdLevel simd_level,
+                    std::vector<std::string_view> &fields,
+                    std::vector<std::size_t> &fields_per_row,
+                    std::deque<std::string> &unescaped);
+
+ private:
+  DataLoader &data_loader_;
+  Options options_;
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_BULK_IMPORTER_H_
@@ -0,0 +1,504 @@
+/// \file columnar_snapshot.cpp
+/// \brief Source file containing classes ColumnarWriter and ColumnarReader methods
+/// \brief definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "columnar_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+  using namespace crypto_wallet::client::columnar;
+
+  static_assert(sizeof(FooterHeader) == 24, "footer header layout");
+  static_assert(sizeof(ChunkMeta) == 56, "chunk meta layout");
+  static_assert(sizeof(Trailer) == 24, "trailer layout");
+
+  enum ValueKind : uint8_t {
+    kNull,
+    kInteger,
+    kReal,
+    kText
+  };
+
+  // Integer text the way SQLite prints integers: no '+', no leading zeros, no "-0".
+  bool ParseCanonicalInt64(const char *text, std::size_t size, int64_t &value) {
+    if (size == 0 || size > 20)
+      return false;
+    std::size_t digits_begin = (text[0] == '-') ? 1 : 0;
+    if (digits_begin == size || (text[digits_begin] == '0' && size - digits_begin > 1) ||
+        (digits_begin && text[1] == '0'))
+      return false;
+    for (std::size_t i = digits_begin; i < size; ++i)
+      if (text[i] < '0' || text[i] > '9')
+        return false;
+    char buffer[24];
+    std::memcpy(buffer, text, size);
+    buffer[size] = '\0';
+    errno = 0;
+    value = std::strtoll(buffer, nullptr, 10);
+    return errno == 0;
+  }
+
+  void FormatReal(double value, std::string &text) {
+    char buffer[64];
+    sqlite3_snprintf(sizeof(buffer), buffer, "%!.15g", value);
+    text = buffer;
+  }
+
+  // Values of one column in the current row group.
+  struct ColumnBuffer {
+    std::vector<uint8_t> kinds{};
+    std::vector<int64_t> ints{};
+    std::vector<double> reals{};
+    std::string bytes{};
+    std::vector<uint64_t> text_ends{};
+    bool is_int{true};
+    bool is_numeric{true};
+    bool has_nulls{false};
+
+    void Append(sqlite3_stmt *stmt, int column) {
+      int64_t int_value{0};
+      double real_value{0.0};
+      auto kind = kText;
+      switch (sqlite3_column_type(stmt, column)) {
+        case SQLITE_NULL:
+          kind = kNull;
+          has_nulls = true;
+          break;
+        case SQLITE_INTEGER:
+          kind = kInteger;
+          int_value = sqlite3_column_int64(stmt, column);
+          break;
+        case SQLITE_FLOAT:
+          kind = kReal;
+          real_value = sqlite3_column_double(stmt, column);
+          is_int = false;
+          break;
+        case SQLITE_TEXT: {
+          auto text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, column));
+          auto size = static_cast<std::size_t>(sqlite3_column_bytes(stmt, column));
+          if (ParseCanonicalInt64(text, size, int_value)) {
+            kind = kInteger;
+          } else {
+            bytes.append(text, size);
+            is_int = is_numeric = false;
+          }
+          break;
+        }
+        default: {
+          auto blob = static_cast<const char *>(sqlite3_column_blob(stmt, column));
+          bytes.append(blob ? blob : "", static_cast<std::size_t>(
+                                             sqlite3_column_bytes(stmt, column)));
+          is_int = is_numeric = false;
+        }
+      }
+      kinds.push_back(kind);
+      ints.push_back(int_value);
+      reals.push_back(kind == kInteger ? static_cast<double>(int_value) : real_value);
+      text_ends.push_back(bytes.size());
+    }
+
+    void Clear() {
+      kinds.clear();
+      ints.clear();
+      reals.clear();
+      bytes.clear();
+      text_ends.clear();
+      is_int = is_numeric = true;
+      has_nulls = false;
+    }
+  };
+
+  class FileSink {
+   public:
+    explicit FileSink(FILE *file) : file_{file} {}
+
+    void Write(const void *data, std::size_t size) {
+      if (size && std::fwrite(data, 1, size, file_) != size)
+        is_failed_ = true;
+      offset_ += size;
+    }
+
+    void Align() {
+      static const char zeros[8] = {};
+      Write(zeros, (8 - offset_ % 8) % 8);
+    }
+
+    inline uint64_t GetOffset() const noexcept { return offset_; }
+    inline bool IsFailed() const noexcept { return is_failed_; }
+
+   private:
+    FILE *file_;
+    uint64_t offset_{0};
+    bool is_failed_{false};
+  };
+
+  ChunkMeta WriteChunk(FileSink &sink, const ColumnBuffer &column) {
+    ChunkMeta meta{};
+    const auto rows = column.kinds.size();
+    meta.has_nulls = column.has_nulls ? 1 : 0;
+    if (column.has_nulls) {
+      std::vector<uint64_t> nulls((rows + 63) / 64);
+      for (std::size_t i = 0; i < rows; ++i)
+        if (column.kinds[i] == kNull)
+          nulls[i / 64] |= uint64_t{1} << (i % 64);
+      sink.Align();
+      meta.null_offset = sink.GetOffset();
+      sink.Write(nulls.data(), nulls.size() * sizeof(uint64_t));
+    }
+
+    sink.Align();
+    meta.data_offset = sink.GetOffset();
+    if (column.is_int) {
+      meta.encoding = Encoding::kInt64;
+      int64_t min_value{std::numeric_limits<int64_t>::max()};
+      int64_t max_value{std::numeric_limits<int64_t>::min()};
+      for (std::size_t i = 0; i < rows; ++i) {
+        if (column.kinds[i] == kNull)
+          continue;
+        min_value = std::min(min_value, column.ints[i]);
+        max_value = std::max(max_value, column.ints[i]);
+      }
+      meta.min_value = min_value;
+      meta.max_value = max_value;
+      meta.data_size = rows * sizeof(int64_t);
+      sink.Write(column.ints.data(), meta.data_size);
+      return meta;
+    }
+
+    if (column.is_numeric) {
+      meta.encoding = Encoding::kDouble;
+      double min_value{std::numeric_limits<double>::infinity()};
+      double max_value{-std::numeric_limits<double>::infinity()};
+      for (std::size_t i = 0; i < rows; ++i) {
+        if (column.kinds[i] == kNull)
+          continue;
+        min_value = std::min(min_value, column.reals[i]);
+        max_value = std::max(max_value, column.reals[i]);
+      }
+      std::memcpy(&meta.min_value, &min_value, sizeof(double));
+      std::memcpy(&meta.max_value, &max_value, sizeof(double));
+      meta.data_size = rows * sizeof(double);
+      sink.Write(column.reals.data(), meta.data_size);
+      return meta;
+    }
+
+    // dictionary keeps first seen order, NULL gets code 0 and the null bit
+    meta.encoding = Encoding::kDictionary;
+    std::unordered_map<std::string, uint32_t> codes_by_text;
+    std::vector<const std::string *> dictionary;
+    std::vector<uint32_t> codes(rows, 0);
+    std::string text;
+    for (std::size_t i = 0; i < rows; ++i) {
+      auto text_begin = i ? column.text_ends[i - 1] : 0;
+      switch (column.kinds[i]) {
+        case kNull:
+          continue;
+        case kInteger:
+          text = std::to_string(column.ints[i]);
+          break;
+        case kReal:
+          FormatReal(column.reals[i], text);
+          break;
+        default:
+          text.assign(column.bytes, text_begin, column.text_ends[i] - text_begin);
+      }
+      auto it = codes_by_text.find(text);
+      if (it == codes_by_text.end()) {
+        it = codes_by_text.emplace(text, static_cast<uint32_t>(dictionary.size())).first;
+        dictionary.push_back(&it->first);
+      }
+      codes[i] = it->second;
+    }
+
+    std::vector<uint64_t> offsets{0};
+    for (const auto entry : dictionary)
+      offsets.push_back(offsets.back() + entry->size());
+    uint64_t count{dictionary.size()};
+    sink.Write(&count, sizeof(count));
+    sink.Write(offsets.data(), offsets.size() * sizeof(uint64_t));
+    for (const auto entry : dictionary)
+      sink.Write(entry->data(), entry->size());
+    meta.data_size = sink.GetOffset() - meta.data_offset;
+    sink.Align();
+    meta.codes_offset = sink.GetOffset();
+    sink.Write(codes.data(), codes.size() * sizeof(uint32_t));
+    return meta;
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+ColumnarWriter::ColumnarWriter(const Options &options) : options_{options} {
+  options_.rows_per_group = std::max<std::size_t>(options_.rows_per_group, 1);
+}
+
+int32_t ColumnarWriter::Export(sqlite3 *database, const std::string &table_name,
+                               const std::string &file_path, Report &report) {
+  report = Report{};
+  auto start = std::chrono::steady_clock::now();
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v2(database, ("SELECT * FROM " + table_name + ";").c_str(), -1,
+                                &stmt, nullptr);
+  if (res != SQLITE_OK)
+    return res;
+
+  const auto tmp_path = file_path + ".tmp";
+  auto file = std::fopen(tmp_path.c_str(), "wb");
+  if (!file) {
+    sqlite3_finalize(stmt);
+    return SQLITE_IOERR;
+  }
+
+  FileSink sink{file};
+  sink.Write(columnar::kMagic, sizeof(columnar::kMagic));
+  const auto columns_count = static_cast<std::size_t>(sqlite3_column_count(stmt));
+  std::vector<ColumnBuffer> columns(columns_count);
+  std::vector<uint64_t> group_rows;
+  std::vector<columnar::ChunkMeta> chunks;
+  std::size_t rows_in_group{0};
+  auto flush_group = [&]() {
+    group_rows.push_back(rows_in_group);
+    for (auto &column : columns) {
+      chunks.push_back(WriteChunk(sink, column));
+      column.Clear();
+    }
+    rows_in_group = 0;
+  };
+
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW) {
+    for (std::size_t i = 0; i < columns_count; ++i)
+      columns[i].Append(stmt, static_cast<int>(i));
+    ++report.rows;
+    if (++rows_in_group == options_.rows_per_group)
+      flush_group();
+  }
+  res = (res == SQLITE_DONE) ? SQLITE_OK : res;
+  if (res == SQLITE_OK && rows_in_group)
+    flush_group();
+
+  if (res == SQLITE_OK) {
+    sink.Align();
+    columnar::Trailer trailer{};
+    trailer.footer_offset = sink.GetOffset();
+    columnar::FooterHeader header{columns_count, group_rows.size(), report.rows};
+    sink.Write(&header, sizeof(header));
+    for (std::size_t i = 0; i < columns_count; ++i) {
+      auto name = sqlite3_column_name(stmt, static_cast<int>(i));
+      uint64_t length = name ? std::strlen(name) : 0;
+      sink.Write(&length, sizeof(length));
+      sink.Write(name, length);
+      sink.Align();
+    }
+    for (std::size_t group = 0; group < group_rows.size(); ++group) {
+      sink.Write(&group_rows[group], sizeof(uint64_t));
+      sink.Write(&chunks[group * columns_count], columns_count * sizeof(columnar::ChunkMeta));
+    }
+    trailer.footer_size = sink.GetOffset() - trailer.footer_offset;
+    std::memcpy(trailer.magic, columnar::kMagic, sizeof(trailer.magic));
+    sink.Write(&trailer, sizeof(trailer));
+  }
+  sqlite3_finalize(stmt);
+
+  if (std::fclose(file) != 0 || sink.IsFailed())
+    res = (res == SQLITE_OK) ? SQLITE_IOERR : res;
+  if (res == SQLITE_OK && std::rename(tmp_path.c_str(), file_path.c_str()) != 0)
+    res = SQLITE_IOERR;
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Columnar export of " << table_name << " failed: " << sqlite3_errstr(res)
+              << std::endl;
+    std::remove(tmp_path.c_str());
+    return res;
+  }
+
+  report.row_groups = group_rows.size();
+  report.bytes = sink.GetOffset();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  report.seconds = elapsed.count();
+  return SQLITE_OK;
+}
+
+std::string ColumnarReader::ColumnChunk::GetText(std::size_t idx) const {
+  if (IsNull(idx))
+    return "";
+  std::string text;
+  switch (meta_->encoding) {
+    case columnar::Encoding::kInt64:
+      return std::to_string(ints_[idx]);
+    case columnar::Encoding::kDouble:
+      FormatReal(doubles_[idx], text);
+      return text;
+    default:
+      return std::string{GetDictionaryValue(codes_[idx])};
+  }
+}
+
+bool ColumnarReader::ColumnChunk::GetInt64Bounds(int64_t &min_value,
+                                                 int64_t &max_value) const noexcept {
+  if (meta_->encoding != columnar::Encoding::kInt64 || meta_->min_value > meta_->max_value)
+    return false;
+  min_value = meta_->min_value;
+  max_value = meta_->max_value;
+  return true;
+}
+
+ColumnarReader::~ColumnarReader() {
+  Close();
+}
+
+void ColumnarReader::Close() noexcept {
+  if (mapping_)
+    munmap(const_cast<char *>(mapping_), size_);
+  mapping_ = nullptr;
+  size_ = 0;
+  rows_count_ = 0;
+  columns_.clear();
+  row_groups_.clear();
+}
+
+/// Every offset read from the file is checked against its size, so a truncated or
+/// corrupted snapshot is rejected instead of read out of bounds.
+int32_t ColumnarReader::Open(const std::string &file_path) {
+  Close();
+  auto fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return SQLITE_CANTOPEN;
+  struct stat sb{};
+  if (fstat(fd, &sb) != 0 || sb.st_size < static_cast<off_t>(sizeof(columnar::kMagic) +
+                                                                sizeof(columnar::Trailer))) {
+    close(fd);
+    return sb.st_size ? SQLITE_CORRUPT : SQLITE_CANTOPEN;
+  }
+  size_ = static_cast<std::size_t>(sb.st_size);
+  auto mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    size_ = 0;
+    return SQLITE_CANTOPEN;
+  }
+  mapping_ = static_cast<const char *>(mapping);
+
+  auto is_inside = [this](uint64_t offset, uint64_t size) {
+    return offset <= size_ && size <= size_ - offset;
+  };
+  columnar::Trailer trailer{};
+  std::memcpy(&trailer, mapping_ + size_ - sizeof(trailer), sizeof(trailer));
+  if (std::memcmp(mapping_, columnar::kMagic, sizeof(columnar::kMagic)) != 0 ||
+      std::memcmp(trailer.magic, columnar::kMagic, sizeof(columnar::kMagic)) != 0 ||
+      trailer.footer_offset % 8 ||
+      !is_inside(trailer.footer_offset, trailer.footer_size + sizeof(trailer))) {
+    Close();
+    return SQLITE_CORRUPT;
+  }
+
+  uint64_t pos{trailer.footer_offset};
+  const uint64_t footer_end{trailer.footer_offset + trailer.footer_size};
+  auto read = [&](void *value, uint64_t size) {
+    if (pos > footer_end || size > footer_end - pos)
+      return false;
+    std::memcpy(value, mapping_ + pos, size);
+    pos += size;
+    return true;
+  };
+
+  columnar::FooterHeader header{};
+  bool is_valid = read(&header, sizeof(header)) && header.columns_count <= trailer.footer_size;
+  for (uint64_t i = 0; is_valid && i < header.columns_count; ++i) {
+    uint64_t length{0};
+    is_valid = read(&length, sizeof(length)) && is_inside(pos, length) &&
+               pos + length <= footer_end;
+    if (is_valid) {
+      columns_.emplace_back(mapping_ + pos, length);
+      pos += length + (8 - length % 8) % 8;
+    }
+  }
+
+  uint64_t rows_count{0};
+  for (uint64_t group = 0; is_valid && group < header.row_groups_count; ++group) {
+    uint64_t rows{0};
+    is_valid = read(&rows, sizeof(rows)) && rows <= size_;
+    std::vector<ColumnChunk> chunks(header.columns_count);
+    for (uint64_t column = 0; is_valid && column < header.columns_count; ++column) {
+      auto &chunk = chunks[column];
+      chunk.meta_ = reinterpret_cast<const columnar::ChunkMeta *>(mapping_ + pos);
+      columnar::ChunkMeta meta{};
+      is_valid = (pos % 8 == 0) && read(&meta, sizeof(meta)) && meta.data_offset % 8 == 0 &&
+                 is_inside(meta.data_offset, meta.data_size);
+      if (!is_valid)
+        break;
+      chunk.rows_ = rows;
+      if (meta.has_nulls) {
+        is_valid = meta.null_offset % 8 == 0 &&
+                   is_inside(meta.null_offset, (rows + 63) / 64 * sizeof(uint64_t));
+        chunk.nulls_ = reinterpret_cast<const uint64_t *>(mapping_ + meta.null_offset);
+      }
+      if (meta.encoding == columnar::Encoding::kInt64) {
+        is_valid = is_valid && meta.data_size >= rows * sizeof(int64_t);
+        chunk.ints_ = reinterpret_cast<const int64_t *>(mapping_ + meta.data_offset);
+      } else if (meta.encoding == columnar::Encoding::kDouble) {
+        is_valid = is_valid && meta.data_size >= rows * sizeof(double);
+        chunk.doubles_ = reinterpret_cast<const double *>(mapping_ + meta.data_offset);
+      } else if (meta.encoding == columnar::Encoding::kDictionary) {
+        uint64_t count{0};
+        is_valid = is_valid && meta.data_size >= sizeof(count);
+        if (is_valid)
+          std::memcpy(&count, mapping_ + meta.data_offset, sizeof(count));
+        is_valid = is_valid && count + 2 <= meta.data_size / sizeof(uint64_t) &&
+                   meta.codes_offset % 8 == 0 &&
+                   is_inside(meta.codes_offset, rows * sizeof(uint32_t));
+        if (is_valid) {
+          chunk.dictionary_size_ = count;
+          chunk.dictionary_offsets_ =
+              reinterpret_cast<const uint64_t *>(mapping_ + meta.data_offset + sizeof(count));
+          chunk.dictionary_bytes_ = reinterpret_cast<const char *>(
+              chunk.dictionary_offsets_ + count + 1);
+          auto bytes_size = meta.data_size - sizeof(count) - (count + 1) * sizeof(uint64_t);
+          for (uint64_t i = 0; is_valid && i < count; ++i)
+            is_valid = chunk.dictionary_offsets_[i] <= chunk.dictionary_offsets_[i + 1];
+          is_valid = is_valid && chunk.dictionary_offsets_[count] <= bytes_size;
+          chunk.codes_ = reinterpret_cast<const uint32_t *>(mapping_ + meta.codes_offset);
+          // accessors index the dictionary with codes as they are
+          for (uint64_t i = 0; is_valid && i < rows; ++i)
+            is_valid = chunk.IsNull(i) || chunk.codes_[i] < count;
+        }
+      } else {
+        is_valid = false;
+      }
+    }
+    rows_count += rows;
+    row_groups_.push_back(std::move(chunks));
+  }
+
+  if (!is_valid || rows_count != header.rows_count) {
+    Close();
+    return SQLITE_CORRUPT;
+  }
+  rows_count_ = rows_count;
+  return SQLITE_OK;
+}
+
+std::size_t ColumnarReader::FindColumn(const std::string &column_name) const noexcept {
+  return static_cast<std::size_t>(std::find(columns_.begin(), columns_.end(), column_name) -
+                                   columns_.begin());
+}
+
+} // namespace client
+} // namespace crypto_wallet
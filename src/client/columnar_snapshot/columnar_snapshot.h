@@ -0,0 +1,241 @@
+/// \file columnar_snapshot.h
+/// \brief Classes writing and reading columnar table snapshots.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_COLUMNAR_SNAPSHOT_H_
+#define CRYPTO_WALLET_CLIENT_COLUMNAR_SNAPSHOT_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \namespace columnar
+/// \brief Snapshot file format, native byte order, every section 8 byte aligned.
+/// \details "CWCOLS01" | row groups | footer | Trailer. Footer: FooterHeader, column
+/// \details names (uint64 length, bytes, padding), then per row group uint64 rows
+/// \details and ChunkMeta of every column. Chunk data: int64 or double values,
+/// \details or dictionary (uint64 count, uint64 offsets[count + 1], bytes) with
+/// \details uint32 codes; optional null bitmap, bit set for NULL.
+namespace columnar {
+  constexpr char kMagic[8] = {'C', 'W', 'C', 'O', 'L', 'S', '0', '1'};
+
+  enum class Encoding : uint32_t {
+    kInt64 = 1,
+    kDouble = 2,
+    kDictionary = 3
+  };
+
+  struct FooterHeader {
+    uint64_t columns_count;
+    uint64_t row_groups_count;
+    uint64_t rows_count;
+  };
+
+  struct ChunkMeta {
+    Encoding encoding;
+    uint32_t has_nulls;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t codes_offset;
+    uint64_t null_offset;
+    // int64 bounds, or double bit patterns, of the non-null values
+    int64_t min_value;
+    int64_t max_value;
+  };
+
+  struct Trailer {
+    uint64_t footer_offset;
+    uint64_t footer_size;
+    char magic[8];
+  };
+}  // namespace columnar
+
+/// \class ColumnarWriter columnar_snapshot.h.
+/// \brief Streams a table into the snapshot file in row groups.
+/// \details Memory is bounded by one row group. Encoding is chosen per column chunk:
+/// \details int64 if every value is an integer (integer text included), double if
+/// \details every value is numeric, dictionary of the text otherwise.
+class ColumnarWriter {
+ public:
+  /// \struct Options columnar_snapshot.h.
+  /// \brief Export options.
+  struct Options {
+    std::size_t rows_per_group{65536};
+  };
+
+  /// \struct Report columnar_snapshot.h.
+  /// \brief Export results.
+  struct Report {
+    uint64_t rows{0};
+    uint64_t row_groups{0};
+    uint64_t bytes{0};
+    double seconds{0.0};
+  };
+
+  /// \brief ColumnarWriter constructor.
+  /// \param[in] options Export options.
+  explicit ColumnarWriter(const Options &options);
+
+  /// \brief Export the result of SELECT * FROM table_name.
+  /// \details File is written next to the destination and renamed once complete.
+  /// \param[in] database Connection, a dedicated reader keeps the writer free.
+  /// \param[in] table_name Table name.
+  /// \param[in] file_path Snapshot path.
+  /// \param[out] report Export results.
+  /// \return SQLITE_IOERR if the file cannot be written, otherwise result of the scan.
+  int32_t Export(sqlite3 *database, const std::string &table_name,
+                 const std::string &file_path, Report &report);
+
+ private:
+  Options options_;
+};
+
+/// \class ColumnarReader columnar_snapshot.h.
+/// \brief Memory maps the snapshot file, column chunks point into the mapping.
+class ColumnarReader {
+ public:
+  /// \class ColumnChunk columnar_snapshot.h.
+  /// \brief Values of one column in one row group.
+  class ColumnChunk {
+   public:
+    /// \brief Get encoding.
+    /// \return Encoding.
+    inline columnar::Encoding GetEncoding() const noexcept { return meta_->encoding; }
+
+    /// \brief Get number of values.
+    /// \return Number of values.
+    inline std::size_t GetRowsCount() const noexcept { return rows_; }
+
+    /// \brief Check if the value is NULL.
+    /// \param[in] idx Value index.
+    /// \return NULL state.
+    inline bool IsNull(std::size_t idx) const noexcept {
+      return nulls_ && ((nulls_[idx / 64] >> (idx % 64)) & 1);
+    }
+
+    /// \brief Get int64 values, nullptr unless encoding is kInt64.
+    /// \return Values.
+    inline const int64_t *GetInt64Values() const noexcept { return ints_; }
+
+    /// \brief Get double values, nullptr unless encoding is kDouble.
+    /// \return Values.
+    inline const double *GetDoubleValues() const noexcept { return doubles_; }
+
+    /// \brief Get dictionary codes, nullptr unless encoding is kDictionary.
+    /// \details Open checks codes of the non-NULL values are below the dictionary size.
+    /// \return Codes.
+    inline const uint32_t *GetCodes() const noexcept { return codes_; }
+
+    /// \brief Get number of dictionary entries.
+    /// \return Dictionary size.
+    inline std::size_t GetDictionarySize() const noexcept { return dictionary_size_; }
+
+    /// \brief Get dictionary entry.
+    /// \param[in] code Dictionary code.
+    /// \return Text of the entry.
+    inline std::string_view GetDictionaryValue(uint32_t code) const noexcept {
+      return std::string_view{dictionary_bytes_ + dictionary_offsets_[code],
+                              static_cast<std::size_t>(dictionary_offsets_[code + 1] -
+                                                       dictionary_offsets_[code])};
+    }
+
+    /// \brief Get value as text whatever the encoding is.
+    /// \param[in] idx Value index.
+    /// \return Text, empty for NULL.
+    std::string GetText(std::size_t idx) const;
+
+    /// \brief Get min and max of the non-null int64 values.
+    /// \param[out] min_value Min value.
+    /// \param[out] max_value Max value.
+    /// \return false unless encoding is kInt64 with at least one value.
+    bool GetInt64Bounds(int64_t &min_value, int64_t &max_value) const noexcept;
+
+   private:
+    friend class ColumnarReader;
+
+    const columnar::ChunkMeta *meta_{nullptr};
+    std::size_t rows_{0};
+    const uint64_t *nulls_{nullptr};
+    const int64_t *ints_{nullptr};
+    const double *doubles_{nullptr};
+    const uint32_t *codes_{nullptr};
+    std::size_t dictionary_size_{0};
+    const uint64_t *dictionary_offsets_{nullptr};
+    const char *dictionary_bytes_{nullptr};
+  };
+
+  /// \brief ColumnarReader constructor.
+  ColumnarReader() = default;
+
+  /// \brief ColumnarReader destructor, unmaps the file.
+  ~ColumnarReader();
+
+  /// \brief Class ColumnarReader copy constructor.
+  /// \param[in] columnar_reader Class ColumnarReader object.
+  ColumnarReader(const ColumnarReader &columnar_reader) = delete;
+
+  /// \brief Class ColumnarReader copy assignment.
+  /// \param[in] columnar_reader Class ColumnarReader object.
+  /// \return ColumnarReader object.
+  ColumnarReader &operator=(const ColumnarReader &columnar_reader) = delete;
+
+  /// \brief Map the snapshot file and check its footer.
+  /// \param[in] file_path Snapshot path.
+  /// \return SQLITE_CANTOPEN if file cannot be mapped, SQLITE_CORRUPT if the footer
+  /// \return or any chunk points outside of the file or a dictionary code is out of
+  /// \return range, otherwise SQLITE_OK.
+  int32_t Open(const std::string &file_path);
+
+  /// \brief Get column names.
+  /// \return Column names.
+  inline const std::vector<std::string> &GetColumnNames() const noexcept { return columns_; }
+
+  /// \brief Find column index.
+  /// \param[in] column_name Column name.
+  /// \return Column index, number of columns if there is no such column.
+  std::size_t FindColumn(const std::string &column_name) const noexcept;
+
+  /// \brief Get number of row groups.
+  /// \return Number of row groups.
+  inline std::size_t GetRowGroupsCount() const noexcept { return row_groups_.size(); }
+
+  /// \brief Get number of rows.
+  /// \return Number of rows.
+  inline uint64_t GetRowsCount() const noexcept { return rows_count_; }
+
+  /// \brief Get column chunk.
+  /// \param[in] row_group Row group index.
+  /// \param[in] column Column index.
+  /// \return Column chunk, valid while the reader is open.
+  inline const ColumnChunk &GetChunk(std::size_t row_group, std::size_t column) const noexcept {
+    return row_groups_[row_group][column];
+  }
+
+ private:
+  /// \brief Unmap the file.
+  void Close() noexcept;
+
+  const char *mapping_{nullptr};
+  std::size_t size_{0};
+  uint64_t rows_count_{0};
+  std::vector<std::string> columns_{};
+  std::vector<std::vector<ColumnChunk>> row_groups_{};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_COLUMNAR_SNAPSHOT_H_
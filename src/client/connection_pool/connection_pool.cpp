@@ -0,0 +1,144 @@
+/// \file connection_pool.cpp
+/// \brief Source file containing class ConnectionPool methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "connection_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace crypto_wallet {
+namespace client {
+
+namespace {
+  // Connection the calling thread is pinned to, so it keeps its page cache warm.
+  std::size_t PreferredReader(std::size_t readers_count) {
+    return std::hash<std::thread::id>{}(std::this_thread::get_id()) % readers_count;
+  }
+}
+
+ConnectionPool::Lease::~Lease() {
+  Release();
+}
+
+ConnectionPool::Lease::Lease(Lease &&lease) noexcept
+    : pool_{std::move(lease.pool_)}, idx_{lease.idx_} {}
+
+ConnectionPool::Lease &ConnectionPool::Lease::operator=(Lease &&lease) noexcept {
+  if (this != &lease) {
+    Release();
+    pool_ = std::move(lease.pool_);
+    idx_ = lease.idx_;
+  }
+  return *this;
+}
+
+sqlite3 *ConnectionPool::Lease::Get() const noexcept {
+  return pool_ ? pool_->readers_[idx_] : nullptr;
+}
+
+/// Last lease of the dropped pool closes it on return.
+void ConnectionPool::Lease::Release() noexcept {
+  if (!pool_)
+    return;
+  auto pool = std::move(pool_);
+  pool->ReleaseReader(idx_);
+}
+
+ConnectionPool::ConnectionPool(const std::string &db_name, std::size_t readers_count)
+    : db_name_{db_name}, readers_(std::max<std::size_t>(readers_count, 1), nullptr),
+      is_leased_(readers_.size(), false) {}
+
+ConnectionPool::~ConnectionPool() {
+  // statements left unfinalized must not leak the connection
+  for (auto reader : readers_)
+    sqlite3_close_v2(reader);
+}
+
+void ConnectionPool::SetInitScript(const std::string &sql_script) {
+  init_script_ = sql_script;
+}
+
+void ConnectionPool::SetInitializer(std::function<void(sqlite3 *)> initializer) {
+  initializer_ = std::move(initializer);
+}
+
+int32_t ConnectionPool::Open() {
+  for (auto &reader : readers_) {
+    auto res = sqlite3_open_v2(db_name_.c_str(), &reader,
+                               SQLITE_OPEN_READONLY | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX,
+                               nullptr);
+    if (res != SQLITE_OK) {
+      // throw error becasuse connection was not set
+      std::cout << "read connection was not established: " << sqlite3_errmsg(reader)
+                << std::endl;
+      return res;
+    }
+    // reader must not fail right away while the writer checkpoints
+    sqlite3_busy_timeout(reader, 1000);
+    if (!init_script_.empty()) {
+      res = sqlite3_exec(reader, init_script_.c_str(), NULL, 0, NULL);
+      if (res != SQLITE_OK) {
+        std::cout << "read connection init script results in error: " << sqlite3_errmsg(reader)
+                  << std::endl;
+        return res;
+      }
+    }
+    if (initializer_)
+      initializer_(reader);
+  }
+  return SQLITE_OK;
+}
+
+ConnectionPool::Lease ConnectionPool::AcquireReader() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  if (!readers_.front())
+    return Lease{};
+
+  auto find_free = [this]() {
+    auto preferred = PreferredReader(readers_.size());
+    if (!is_leased_[preferred])
+      return preferred;
+    auto it = std::find(is_leased_.begin(), is_leased_.end(), false);
+    return static_cast<std::size_t>(it - is_leased_.begin());
+  };
+
+  auto idx = find_free();
+  if (idx == readers_.size()) {
+    auto wait_begin = std::chrono::steady_clock::now();
+    reader_released_.wait(lock, [&]() { return (idx = find_free()) != readers_.size(); });
+    uint64_t wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wait_begin).count();
+    ++metrics_.contended_acquisitions;
+    metrics_.total_wait_ns += wait_ns;
+    metrics_.max_wait_ns = std::max(metrics_.max_wait_ns, wait_ns);
+  }
+
+  is_leased_[idx] = true;
+  ++metrics_.acquisitions;
+  ++metrics_.leased_count;
+  return Lease{shared_from_this(), idx};
+}
+
+ConnectionPool::Metrics ConnectionPool::GetMetrics() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return metrics_;
+}
+
+void ConnectionPool::ReleaseReader(std::size_t idx) noexcept {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    is_leased_[idx] = false;
+    --metrics_.leased_count;
+  }
+  reader_released_.notify_one();
+}
+
+} // namespace client
+} // namespace crypt_wallet
@@ -0,0 +1,158 @@
+/// \file connection_pool.h
+/// \brief Class handing out read-only database connections.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_CONNECTION_POOL_H_
+#define CRYPTO_WALLET_CLIENT_CONNECTION_POOL_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class ConnectionPool connection_pool.h.
+/// \brief Class handing out read-only connections to the database.
+/// \details The single writer connection stays with the owner of the pool,
+/// \details readers run in parallel with it once the database is in WAL mode.
+/// \details Pool is owned by std::shared_ptr, every lease keeps it alive, so the
+/// \details owner may drop or replace the pool while cursors still read.
+class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
+ public:
+  /// \struct Metrics connection_pool.h.
+  /// \brief Pool contention metrics.
+  struct Metrics {
+    uint64_t acquisitions{0};
+    uint64_t contended_acquisitions{0};
+    uint64_t total_wait_ns{0};
+    uint64_t max_wait_ns{0};
+    std::size_t leased_count{0};
+  };
+
+  /// \class Lease connection_pool.h.
+  /// \brief Connection leased from the pool, returned back on destruction.
+  class Lease {
+   public:
+    /// \brief Lease constructor.
+    /// \param[in] pool Pool connection is leased from.
+    /// \param[in] idx Index of the connection in the pool.
+    Lease(std::shared_ptr<ConnectionPool> pool = nullptr, std::size_t idx = 0) noexcept
+        : pool_{std::move(pool)}, idx_{idx} {}
+
+    /// \brief Lease destructor.
+    ~Lease();
+
+    /// \brief Class Lease move constructor.
+    /// \param[in] lease Class Lease object.
+    Lease(Lease &&lease) noexcept;
+
+    /// \brief Class Lease move assignment.
+    /// \param[in] lease Class Lease object.
+    /// \return Lease object.
+    Lease &operator=(Lease &&lease) noexcept;
+
+    /// \brief Class Lease copy constructor.
+    /// \param[in] lease Class Lease object.
+    Lease(const Lease &lease) = delete;
+
+    /// \brief Class Lease copy assignment.
+    /// \param[in] lease Class Lease object.
+    /// \return Lease object.
+    Lease &operator=(const Lease &lease) = delete;
+
+    /// \brief Get leased connection.
+    /// \return Connection or nullptr for the empty lease.
+    sqlite3 *Get() const noexcept;
+
+    /// \brief Check if the lease holds a connection.
+    explicit operator bool() const noexcept {
+      return pool_ != nullptr;
+    }
+
+    /// \brief Return connection to the pool.
+    void Release() noexcept;
+
+   private:
+    std::shared_ptr<ConnectionPool> pool_{};
+    std::size_t idx_{0};
+  };
+
+  /// \brief ConnectionPool constructor.
+  /// \param[in] db_name Database name or URI.
+  /// \param[in] readers_count Number of read-only connections.
+  ConnectionPool(const std::string &db_name, std::size_t readers_count);
+
+  /// \brief ConnectionPool destructor, runs once the owner and every lease are gone.
+  ~ConnectionPool();
+
+  /// \brief Class ConnectionPool copy constructor.
+  /// \param[in] connection_pool Class ConnectionPool object.
+  ConnectionPool(const ConnectionPool &connection_pool) = delete;
+
+  /// \brief Class ConnectionPool copy assignment.
+  /// \param[in] connection_pool Class ConnectionPool object.
+  /// \return ConnectionPool object.
+  ConnectionPool &operator=(const ConnectionPool &connection_pool) = delete;
+
+  /// \brief Set script run on every connection once it is opened.
+  /// \param[in] sql_script SQL script.
+  void SetInitScript(const std::string &sql_script);
+
+  /// \brief Set callback run on every connection after the init script.
+  /// \param[in] initializer Callback, e.g. installing a tracer.
+  void SetInitializer(std::function<void(sqlite3 *)> initializer);
+
+  /// \brief Open read-only connections.
+  /// \return Result of opening connections.
+  int32_t Open();
+
+  /// \brief Lease read-only connection, wait until one is free.
+  /// \details Calling thread gets the connection it is pinned to if that one is
+  /// \details free, so every thread keeps working with its own warm page cache.
+  /// \details Pool must be owned by std::shared_ptr.
+  /// \return Lease of the connection, empty if the pool is not open.
+  Lease AcquireReader();
+
+  /// \brief Get number of read-only connections.
+  /// \return Number of connections.
+  inline std::size_t GetReadersCount() const noexcept {
+    return readers_.size();
+  }
+
+  /// \brief Get contention metrics.
+  /// \return Metrics snapshot.
+  Metrics GetMetrics() const;
+
+ private:
+  /// \brief Return connection to the pool.
+  /// \param[in] idx Index of the connection.
+  void ReleaseReader(std::size_t idx) noexcept;
+
+  std::string db_name_{};
+  std::string init_script_{};
+  std::function<void(sqlite3 *)> initializer_{};
+  std::vector<sqlite3 *> readers_{};
+  std::vector<bool> is_leased_{};
+  Metrics metrics_{};
+  mutable std::mutex mutex_{};
+  std::condition_variable reader_released_{};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_CONNECTION_POOL_H_
@@ -13,12 +13,17 @@ extern "C" {
 #include <unistd.h>
 }
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <regex>
+#include <unordered_map>
+#include <vector>
 
 #include "boost/format.hpp"
 
@@ -28,6 +33,11 @@ namespace client {
 #define DB_SIZE_LIMIT 1000 // MB
 
 namespace {
+  bool IsFileExist(const std::string &file_name) {
+    struct stat sb{};
+    return stat(file_name.c_str(), &sb) == 0;
+  }
+
   // Name containing ONLY alphanumeric symbols is valid.
   bool IsDBNameValid(const std::string &db_name) {
     bool res{false};
@@ -49,14 +59,57 @@ namespace {
     return res;
   }
 
-  std::string init_list_to_string(const std::initializer_list<std::string> &init_lst) {
-    std::string res = "";
+  void append_init_list(std::string &res, const std::initializer_list<std::string> &init_lst) {
     auto sz = init_lst.size();
     for (const auto &el : init_lst) {
       res += el;
       if (--sz >= 1)
         res += ", ";
     }
+  }
+
+  std::string init_list_to_string(const std::initializer_list<std::string> &init_lst) {
+    std::string res = "";
+    append_init_list(res, init_lst);
+    return res;
+  }
+
+  // Column definition may carry a type ("amount INTEGER"), its first token
+  // is the column name.
+  std::vector<std::string> struct_template_to_columns(const std::string &struct_template) {
+    std::vector<std::string> res;
+    std::size_t pos{0};
+    while (pos < struct_template.size()) {
+      auto end = struct_template.find(',', pos);
+      if (end == std::string::npos)
+        end = struct_template.size();
+      auto begin = struct_template.find_first_not_of(' ', pos);
+      if (begin < end) {
+        auto name_end = struct_template.find(' ', begin);
+        res.emplace_back(struct_template.substr(begin, std::min(name_end, end) - begin));
+      }
+      pos = end + 1;
+    }
+    return res;
+  }
+
+  std::string columns_to_string(const std::vector<std::string> &columns) {
+    std::string res = "";
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      res += columns[i];
+      if (i + 1 < columns.size())
+        res += ", ";
+    }
+    return res;
+  }
+
+  std::string placeholders_to_string(std::size_t count) {
+    std::string res = "";
+    for (std::size_t i = 0; i < count; ++i) {
+      res += "?";
+      if (i + 1 < count)
+        res += ", ";
+    }
     return res;
   }
 }
@@ -67,24 +120,167 @@ struct DataLoader::PimplDBHandler {
   /// \param[in] db_table_name Database table name.
   void SetDataBaseTableName(const std::string &db_table_name);
 
-  /// \brief Evaluate database size.
-  /// \return Database size.
-  int32_t GetDataBaseSize() const noexcept;
+  /// \brief Open connection and install the commit hook.
+  /// \param[in] db_name Database name.
+  /// \param[out] database Opened connection.
+  /// \return Result of opening.
+  int32_t OpenDataBase(const std::string &db_name, sqlite3 **database);
+
+  /// \brief Commit hook, marks the size stale and drops cached results of the
+  /// \brief written tables.
+  /// \param[in] pimpl_db_handler PimplDBHandler object.
+  /// \return 0, commit is never turned into rollback.
+  static int CommitHook(void *pimpl_db_handler);
+
+  /// \brief Let the result cache take results again after the commit is done.
+  void FinishCommit() noexcept;
+
+  /// \brief Evaluate database size, refreshed only after commits.
+  /// \return Size of the current partition pages plus its WAL in bytes.
+  uint64_t GetDataBaseSize() noexcept;
+
+  /// \brief Run single value query with the cached statement.
+  /// \param[in] sql_script SQL script.
+  /// \return First column of the first row, 0 on error.
+  int64_t QueryInt64(std::string_view sql_script);
+
+  /// \brief Find prepared statement in the cache.
+  /// \param[in] key Cache key (statement kind, table and column set).
+  /// \return Prepared statement or nullptr on a cache miss.
+  sqlite3_stmt *FindCachedStatement(const std::string &key) noexcept;
+
+  /// \brief Prepare persistent statement and put it into the cache.
+  /// \param[in] key Cache key (statement kind, table and column set).
+  /// \param[in] sql_script SQL script to prepare.
+  /// \return Prepared statement or nullptr if preparation failed.
+  sqlite3_stmt *PrepareCachedStatement(const std::string &key, const std::string &sql_script);
+
+  /// \brief Finalize and drop all cached statements.
+  void ClearStatementCache() noexcept;
+
+  /// \brief Get insert statement for current table and column set.
+  /// \return Prepared statement or nullptr if preparation failed.
+  sqlite3_stmt *GetInsertStatement();
+
+  /// \brief Get statement for the constant SQL script.
+  /// \param[in] sql_script SQL script, used as cache key as well.
+  /// \return Prepared statement or nullptr if preparation failed.
+  sqlite3_stmt *GetStatement(std::string_view sql_script);
+
+  /// \brief Bind values to the insert statement and run it.
+  /// \param[in] begin First value.
+  /// \param[in] end Past the last value.
+  /// \param[in] count Number of values.
+  /// \return Result of the insert.
+  template <typename Iterator>
+  int32_t InsertValues(Iterator begin, Iterator end, std::size_t count) {
+    if (count != db_table_columns_.size())
+      return SQLITE_MISMATCH;
+
+    auto insert_stmt = GetInsertStatement();
+    if (!insert_stmt)
+      return SQLITE_ERROR;
+
+    int32_t idx{1};
+    for (auto it = begin; it != end; ++it, ++idx) {
+      if (!encoded_columns_.empty() && encoded_columns_[idx - 1]) {
+        auto res = value_dictionary_->BindEncoded(insert_stmt, idx,
+                                                  std::string_view{it->data(), it->size()});
+        if (res != SQLITE_OK)
+          return res;
+      } else {
+        sqlite3_bind_text(insert_stmt, idx, it->data(), static_cast<int>(it->size()),
+                          SQLITE_STATIC);
+      }
+    }
+    auto res = RunStatement(insert_stmt);
+    if (res == SQLITE_OK)
+      inserted_rows_.fetch_add(1, std::memory_order_relaxed);
+    return res;
+  }
+
+  /// \brief Mark columns of the current table stored as dictionary ids.
+  void UpdateEncodedColumns();
+
+  /// \brief Get select list of the columns, dictionary encoded ones are decoded.
+  /// \details Reads the table state only, concurrent selects of the read pool call it.
+  /// \param[in] columns Columns.
+  /// \param[in] is_writer Select runs on the writer connection, not a reader.
+  /// \return Select list.
+  template <typename Columns>
+  std::string GetProjection(const Columns &columns, bool is_writer) const {
+    std::string res = "";
+    bool is_encoded_table = value_dictionary_ && db_table_name_ == encoded_table_name_;
+    for (const auto &column : columns) {
+      if (!res.empty())
+        res += ", ";
+      if (is_encoded_table && std::find(encoded_column_names_.begin(),
+                                        encoded_column_names_.end(), column) !=
+                              encoded_column_names_.end())
+        res += value_dictionary_->GetDecodeExpression(column, is_writer) + " AS " + column;
+      else
+        res += column;
+    }
+    return res;
+  }
+
+  /// \brief Report committed rows to write-behind once no transaction is open.
+  void NoteCommittedRows() noexcept;
+
+  /// \brief Step the statement to completion and reset it for the next use.
+  /// \param[in] stmt Prepared statement.
+  /// \return Result of the statement evaluation.
+  int32_t RunStatement(sqlite3_stmt *stmt);
 
   //sqlite3 *database_{nullptr};
   std::unique_ptr<sqlite3 *> database_ = std::make_unique<sqlite3 *>();
   std::string db_name_{"file::memory:?cache=shared"};
   std::string db_table_name_;
   std::string db_table_struct_template_;
-  bool is_data_table_exist_{false};
+  std::vector<std::string> db_table_columns_;
+  std::unordered_map<std::string, sqlite3_stmt *> statement_cache_;
+  std::unordered_map<const char *, sqlite3_stmt *> schema_statement_cache_;
+  // shared with the leases of open cursors and snapshots
+  std::shared_ptr<ConnectionPool> read_pool_;
+  std::size_t read_pool_size_{0};
+  std::unique_ptr<StorageProfile> storage_profile_;
+  SchemaCatalog schema_catalog_;
+  QueryStats query_stats_;
+  // size accounting, commit hook marks the size stale
+  std::atomic<bool> is_size_dirty_{true};
+  uint64_t db_size_{0};
+  uint64_t db_size_limit_{static_cast<uint64_t>(DB_SIZE_LIMIT) * 1000 * 1000};
+  // partitioning, db_name_ is the first partition
+  bool is_partitioning_enabled_{false};
+  std::string partition_name_;
+  std::vector<std::string> partition_names_;
+  std::chrono::seconds rotation_interval_{0};
+  std::chrono::steady_clock::time_point partition_start_time_{};
+  std::unique_ptr<WriteBehind> write_behind_;
+  std::unique_ptr<BalanceAggregate> balance_aggregate_;
+  std::unique_ptr<ResultCache> result_cache_;
+  // DDL count seen by the result cache, DDL drops all cached results
+  std::atomic<uint64_t> result_cache_ddl_count_{0};
+  std::unique_ptr<ValueDictionary> value_dictionary_;
+  std::string encoded_table_name_;
+  std::vector<std::string> encoded_column_names_;
+  // per db_table_columns_ entry, empty unless the current table is encoded
+  std::vector<bool> encoded_columns_;
+  IndexManager index_manager_;
+  // per request scratch of the writer thread, capacity is reused so steady state
+  // lookups do not allocate, selects served by the read pool must not touch it
+  std::string scratch_key_;
+  sqlite3_stmt *insert_stmt_{nullptr};
+  std::atomic<uint64_t> inserted_rows_{0};
 };
 
 
 DataLoader::DataLoader(std::string &&path = nullptr) 
     : pimpl_db_handler_{std::make_unique<DataLoader::PimplDBHandler>()} {
   SetDataBaseName(path);
-  if (SQLITE_OK != sqlite3_open((pimpl_db_handler_->db_name_).c_str(),
-                                ((pimpl_db_handler_->database_).get())))
+  pimpl_db_handler_->partition_name_ = pimpl_db_handler_->db_name_;
+  if (SQLITE_OK != pimpl_db_handler_->OpenDataBase(pimpl_db_handler_->db_name_,
+                                                   (pimpl_db_handler_->database_).get()))
     // throw error becasuse connection was not set
     std::cout << "connection was not established" << std::endl;
   //if (*database_ != NULL)
@@ -94,8 +290,9 @@ DataLoader::DataLoader(std::string &&path = nullptr)
 DataLoader::DataLoader(const std::string &path = nullptr) 
     : pimpl_db_handler_{std::make_unique<DataLoader::PimplDBHandler>()} {
   SetDataBaseName(path);
-  if (SQLITE_OK != sqlite3_open((pimpl_db_handler_->db_name_).c_str(), 
-                                (pimpl_db_handler_->database_).get()))
+  pimpl_db_handler_->partition_name_ = pimpl_db_handler_->db_name_;
+  if (SQLITE_OK != pimpl_db_handler_->OpenDataBase(pimpl_db_handler_->db_name_,
+                                                   (pimpl_db_handler_->database_).get()))
     // throw error becasuse connection was not set
     std::cout << "connection was not established" << std::endl;
   //if (*database_ != NULL)
@@ -104,8 +301,14 @@ DataLoader::DataLoader(const std::string &path = nullptr)
 
 int32_t DataLoader::RunSqlScript(const std::string &sql_script) {
   char *errMsg;
+  auto &schema_catalog = pimpl_db_handler_->schema_catalog_;
+  auto ddl_count = schema_catalog.GetDdlCount();
   auto res = sqlite3_exec(*((pimpl_db_handler_->database_).get()), 
                           sql_script.c_str(), NULL, 0, &errMsg);
+  pimpl_db_handler_->FinishCommit();
+  // DDL is applied on step, a lookup in between could load the old schema
+  if (schema_catalog.GetDdlCount() != ddl_count)
+    schema_catalog.Invalidate();
   if (res != SQLITE_OK) {
     // throw exception here
     std::cout << "Script evaluation results in error: " << std::string(errMsg) << std::endl;
@@ -140,6 +343,9 @@ std::string DataLoader::GetDataBaseTableName() const noexcept {
 void DataLoader::SetDBTableStructTemplate(const std::initializer_list<std::string> 
                                           &db_struct_template) {
   pimpl_db_handler_->db_table_struct_template_ = init_list_to_string(db_struct_template);
+  pimpl_db_handler_->db_table_columns_ =
+      struct_template_to_columns(pimpl_db_handler_->db_table_struct_template_);
+  pimpl_db_handler_->UpdateEncodedColumns();
 }
 
 std::string DataLoader::GetDBTableStructTemplate() const noexcept {
@@ -151,22 +357,134 @@ int32_t DataLoader::CreateDBTable(const std::string &table_name) {
   std::string create_table_template = "CREATE TABLE %1% (%2%)";
   auto sql_script = boost::str(boost::format{create_table_template} %
                                pimpl_db_handler_->db_table_name_  % GetDBTableStructTemplate());
-  return RunSqlScript(sql_script);
+  // schema changes, cached statements must be prepared against the new one
+  pimpl_db_handler_->ClearStatementCache();
+  pimpl_db_handler_->UpdateEncodedColumns();
+  auto res = RunSqlScript(sql_script);
+  if (res == SQLITE_OK && !pimpl_db_handler_->index_manager_.GetIndexes().empty())
+    res = RunSqlScript(pimpl_db_handler_->index_manager_.GetCreateScript(
+        pimpl_db_handler_->db_table_name_));
+  if (pimpl_db_handler_->write_behind_)
+    pimpl_db_handler_->write_behind_->SetTable(pimpl_db_handler_->db_table_name_,
+                                               pimpl_db_handler_->db_table_columns_);
+  // older partitions view is created for the current table only
+  if (res == SQLITE_OK && !pimpl_db_handler_->partition_names_.empty())
+    res = SwitchPartition(pimpl_db_handler_->partition_name_,
+                          pimpl_db_handler_->partition_names_);
+  return res;
 }
 
 /// Valid insert request ex: INSERT INTO table_name (col1, ... colN) 
-/// VALUES (val1 ... valN);
+/// VALUES (?1 ... ?N); values are bound as text, column affinity applies.
 int32_t DataLoader::InsertIntoTable(const std::initializer_list<std::string> &val_lst) {
-  if (val_lst.size() != pimpl_db_handler_->db_table_struct_template_.size())
+  if (val_lst.size() != pimpl_db_handler_->db_table_columns_.size())
     return SQLITE_MISMATCH;
 
   if (!IsDataBaseTableExist())
     return SQLITE_INTERNAL;
 
-  std::string insert_template = "INSERT INTO %1% (%2%) VALUES (%3%);";
-  auto sql_script = boost::str(boost::format{insert_template} % pimpl_db_handler_->db_table_name_ %
-                              GetDBTableStructTemplate() % init_list_to_string(val_lst));
-  return RunSqlScript(sql_script);
+  CheckPartitionRotation();
+  auto res = pimpl_db_handler_->InsertValues(val_lst.begin(), val_lst.end(), val_lst.size());
+  pimpl_db_handler_->NoteCommittedRows();
+  return res;
+}
+
+int32_t DataLoader::InsertRow(const std::vector<std::string> &row) {
+  if (row.size() != pimpl_db_handler_->db_table_columns_.size())
+    return SQLITE_MISMATCH;
+
+  if (!IsDataBaseTableExist())
+    return SQLITE_INTERNAL;
+
+  CheckPartitionRotation();
+  auto res = pimpl_db_handler_->InsertValues(row.begin(), row.end(), row.size());
+  pimpl_db_handler_->NoteCommittedRows();
+  return res;
+}
+
+/// Rows are wrapped into BEGIN IMMEDIATE ... COMMIT, so the whole batch costs
+/// a single journal sync instead of one per row.
+int32_t DataLoader::InsertBatch(const std::vector<std::vector<std::string>> &rows,
+                                std::vector<int32_t> *row_results) {
+  return InsertRows(rows.size(), [this, &rows](std::size_t idx) {
+    return pimpl_db_handler_->InsertValues(rows[idx].begin(), rows[idx].end(),
+                                           rows[idx].size());
+  }, row_results);
+}
+
+int32_t DataLoader::InsertBatch(const std::vector<std::string_view> &values,
+                                std::size_t columns_count,
+                                std::vector<int32_t> *row_results) {
+  if (columns_count == 0 || values.size() % columns_count != 0) {
+    if (row_results)
+      row_results->clear();
+    return SQLITE_MISUSE;
+  }
+
+  return InsertRows(values.size() / columns_count,
+                    [this, &values, columns_count](std::size_t idx) {
+    auto begin = values.begin() + static_cast<std::ptrdiff_t>(idx * columns_count);
+    return pimpl_db_handler_->InsertValues(begin, begin + static_cast<std::ptrdiff_t>(
+                                               columns_count), columns_count);
+  }, row_results);
+}
+
+template <typename RowInserter>
+int32_t DataLoader::InsertRows(std::size_t rows_count, const RowInserter &insert_row,
+                               std::vector<int32_t> *row_results) {
+  if (rows_count == 0) {
+    if (row_results)
+      row_results->clear();
+    return SQLITE_OK;
+  }
+
+  // rows of a batch which never ran report its error, not success
+  auto res = IsDataBaseTableExist() ? SQLITE_OK : SQLITE_INTERNAL;
+  if (res == SQLITE_OK) {
+    CheckPartitionRotation();
+    res = BeginTransaction();
+  }
+  if (row_results)
+    row_results->assign(rows_count, res);
+  if (res != SQLITE_OK)
+    return res;
+
+  int32_t batch_res{SQLITE_OK};
+  for (std::size_t i = 0; i < rows_count; ++i) {
+    auto row_res = insert_row(i);
+    if (row_results)
+      (*row_results)[i] = row_res;
+    if (row_res != SQLITE_OK)
+      batch_res = row_res;
+  }
+
+  res = CommitTransaction();
+  if (res != SQLITE_OK) {
+    RollbackTransaction();
+    if (row_results)
+      row_results->assign(rows_count, res);
+    return res;
+  }
+
+  return batch_res;
+}
+
+int32_t DataLoader::BeginTransaction() {
+  auto stmt = pimpl_db_handler_->GetStatement("BEGIN IMMEDIATE;");
+  return stmt ? pimpl_db_handler_->RunStatement(stmt) : SQLITE_ERROR;
+}
+
+int32_t DataLoader::CommitTransaction() {
+  auto stmt = pimpl_db_handler_->GetStatement("COMMIT;");
+  auto res = stmt ? pimpl_db_handler_->RunStatement(stmt) : SQLITE_ERROR;
+  if (res == SQLITE_OK)
+    pimpl_db_handler_->NoteCommittedRows();
+  return res;
+}
+
+int32_t DataLoader::RollbackTransaction() {
+  auto stmt = pimpl_db_handler_->GetStatement("ROLLBACK;");
+  return stmt ? pimpl_db_handler_->RunStatement(stmt) : SQLITE_ERROR;
 }
 
 /// TODO implement IsSelectValValid(const std::string &val)
@@ -178,10 +496,269 @@ int32_t DataLoader::SelectFromTable(const std::initializer_list<std::string> &va
   if (!IsDataBaseTableExist())
     return SQLITE_INTERNAL;
 
-  std::string select_template = "SELECT %1% FROM %2%;";
-  auto sql_script = boost::str(boost::format{select_template} % init_list_to_string(val_lst) % 
-                              pimpl_db_handler_->db_table_name_);
-  return RunSqlScript(sql_script);
+  if (pimpl_db_handler_->result_cache_) {
+    std::shared_ptr<const ResultCache::Result> result;
+    return SelectFromTable(val_lst, result);
+  }
+
+  if (pimpl_db_handler_->read_pool_) {
+    auto cursor = OpenSelectCursor(val_lst);
+    while (cursor.Next()) {}
+    return cursor.GetResult();
+  }
+
+  auto &key = pimpl_db_handler_->scratch_key_;
+  key.assign("SELECT:");
+  key += pimpl_db_handler_->db_table_name_;
+  key += ':';
+  append_init_list(key, val_lst);
+  auto select_stmt = pimpl_db_handler_->FindCachedStatement(key);
+  if (!select_stmt) {
+    std::string select_template = "SELECT %1% FROM %2%;";
+    select_stmt = pimpl_db_handler_->PrepareCachedStatement(key,
+        boost::str(boost::format{select_template} %
+                   pimpl_db_handler_->GetProjection(val_lst, true) %
+                   pimpl_db_handler_->db_table_name_));
+    if (!select_stmt)
+      return SQLITE_ERROR;
+  }
+
+  return pimpl_db_handler_->RunStatement(select_stmt);
+}
+
+/// Cache hit runs no SQL, DDL seen by the schema catalog drops all results first.
+/// Selects run by the writer inside a transaction bypass the cache.
+int32_t DataLoader::SelectFromTable(const std::initializer_list<std::string> &val_lst,
+                                    std::shared_ptr<const ResultCache::Result> &result) {
+  result.reset();
+  if (val_lst.size() == 0)
+    return SQLITE_MISMATCH;
+
+  if (!IsDataBaseTableExist())
+    return SQLITE_INTERNAL;
+
+  auto &pimpl = *pimpl_db_handler_;
+  // selects may run concurrently on the read pool, the writer scratch is not used
+  std::string projection;
+  append_init_list(projection, val_lst);
+  // writer inside a transaction sees its uncommitted rows, which may be rolled back
+  auto is_writer_transaction = [&pimpl]() {
+    return !pimpl.read_pool_ && !sqlite3_get_autocommit(*pimpl.database_);
+  };
+  auto result_cache = is_writer_transaction() ? nullptr : pimpl.result_cache_.get();
+  uint64_t generation{0};
+  if (result_cache) {
+    auto ddl_count = pimpl.schema_catalog_.GetDdlCount();
+    if (pimpl.result_cache_ddl_count_.exchange(ddl_count, std::memory_order_acq_rel) !=
+        ddl_count)
+      result_cache->Clear();
+    result_cache->CheckDataVersion(false);
+    if ((result = result_cache->Find(pimpl.db_table_name_, projection)))
+      return SQLITE_OK;
+    generation = result_cache->GetGeneration();
+  }
+
+  auto select_result = std::make_shared<ResultCache::Result>();
+  select_result->columns_count = val_lst.size();
+  auto cursor = OpenSelectCursor(val_lst);
+  for (const auto &row : cursor)
+    for (int32_t i = 0; i < static_cast<int32_t>(select_result->columns_count); ++i)
+      select_result->values.emplace_back(row.GetText(i));
+  auto res = cursor.GetResult();
+  if (res != SQLITE_OK)
+    return res;
+
+  // commit of another connection during the select bumps the generation
+  if (result_cache && !is_writer_transaction() &&
+      result_cache->CheckDataVersion(true) == SQLITE_OK)
+    result_cache->Insert(pimpl.db_table_name_, projection, select_result, generation);
+  result = std::move(select_result);
+  return SQLITE_OK;
+}
+
+SelectCursor DataLoader::OpenSelectCursor(const std::initializer_list<std::string> &val_lst,
+                                          std::size_t page_size) {
+  if (val_lst.size() == 0)
+    return SelectCursor{SQLITE_MISMATCH};
+
+  if (!IsDataBaseTableExist())
+    return SelectCursor{SQLITE_INTERNAL};
+
+  if (pimpl_db_handler_->read_pool_)
+    return SelectCursor{pimpl_db_handler_->read_pool_->AcquireReader(),
+                        pimpl_db_handler_->db_table_name_,
+                        pimpl_db_handler_->GetProjection(val_lst, false), page_size};
+
+  return SelectCursor{*pimpl_db_handler_->database_, pimpl_db_handler_->db_table_name_,
+                      pimpl_db_handler_->GetProjection(val_lst, true), page_size};
+}
+
+/// Shared cache readers of the in-memory database get SQLITE_LOCKED while the writer
+/// holds the table, busy timeout does not cover it, so the pool is refused there.
+int32_t DataLoader::EnableReadPool(std::size_t readers_count) {
+  if (IsInMemoryUse())
+    return SQLITE_MISUSE;
+
+  auto res = RunSqlScript("PRAGMA journal_mode=WAL;");
+  if (res != SQLITE_OK)
+    return res;
+
+  auto read_pool = std::make_shared<ConnectionPool>(pimpl_db_handler_->partition_name_,
+                                                    readers_count);
+  std::string init_script;
+  if (pimpl_db_handler_->storage_profile_)
+    init_script = pimpl_db_handler_->storage_profile_->GetReaderScript();
+  read_pool->SetInitScript(init_script + GetPartitionsScript());
+  // reads moved off the writer must still count towards index usage
+  auto &query_stats = pimpl_db_handler_->query_stats_;
+  read_pool->SetInitializer([&query_stats](sqlite3 *reader) { query_stats.AttachReader(reader); });
+  res = read_pool->Open();
+  if (res == SQLITE_OK) {
+    pimpl_db_handler_->read_pool_ = std::move(read_pool);
+    pimpl_db_handler_->read_pool_size_ = readers_count;
+  }
+  return res;
+}
+
+ReadSnapshot DataLoader::OpenReadSnapshot() {
+  if (IsInMemoryUse())
+    return ReadSnapshot{SQLITE_MISUSE};
+
+  auto res = RunSqlScript("PRAGMA journal_mode=WAL;");
+  if (res != SQLITE_OK)
+    return ReadSnapshot{res};
+
+  std::string init_script;
+  if (pimpl_db_handler_->storage_profile_)
+    init_script = pimpl_db_handler_->storage_profile_->GetReaderScript();
+  return ReadSnapshot{pimpl_db_handler_->partition_name_, init_script + GetPartitionsScript(),
+                      pimpl_db_handler_->read_pool_};
+}
+
+void DataLoader::EnableResultCache(std::size_t memory_budget) {
+  auto &pimpl = *pimpl_db_handler_;
+  pimpl.result_cache_.reset();
+  if (!memory_budget)
+    return;
+
+  pimpl.result_cache_ = std::make_unique<ResultCache>(memory_budget);
+  pimpl.result_cache_->Attach(*pimpl.database_);
+  pimpl.result_cache_ddl_count_ = pimpl.schema_catalog_.GetDdlCount();
+}
+
+ResultCache::Metrics DataLoader::GetResultCacheMetrics() const {
+  return pimpl_db_handler_->result_cache_ ? pimpl_db_handler_->result_cache_->GetMetrics() :
+                                            ResultCache::Metrics{};
+}
+
+ConnectionPool::Metrics DataLoader::GetReadPoolMetrics() const {
+  return pimpl_db_handler_->read_pool_ ? pimpl_db_handler_->read_pool_->GetMetrics() :
+                                         ConnectionPool::Metrics{};
+}
+
+int32_t DataLoader::SetStorageProfile(const StorageProfile &profile) {
+  auto &pimpl = *pimpl_db_handler_;
+  if (!sqlite3_get_autocommit(*pimpl.database_))
+    return SQLITE_BUSY;
+
+  auto res = RunSqlScript(profile.GetWriterScript(IsInMemoryUse()));
+  if (res != SQLITE_OK)
+    return res;
+
+  pimpl.storage_profile_ = std::make_unique<StorageProfile>(profile);
+  pimpl.is_size_dirty_.store(true, std::memory_order_relaxed);
+  // readers pick the profile up on open
+  if (pimpl.read_pool_size_)
+    res = EnableReadPool(pimpl.read_pool_size_);
+  return res;
+}
+
+int32_t DataLoader::SetStorageProfile(const std::string &profile_name) {
+  StorageProfile profile;
+  if (!StorageProfile::FindProfile(profile_name, profile))
+    return SQLITE_NOTFOUND;
+  return SetStorageProfile(profile);
+}
+
+StorageProfile DataLoader::GetStorageProfile() const {
+  return pimpl_db_handler_->storage_profile_ ? *pimpl_db_handler_->storage_profile_ :
+                                               StorageProfile{};
+}
+
+int32_t DataLoader::AutoTuneStorageProfile(uint64_t sample_rows, std::vector<double> *seconds) {
+  auto durability_level = GetStorageProfile().GetDurabilityLevel();
+  std::vector<StorageProfile> candidates;
+  for (auto &profile : StorageProfile::GetProfiles())
+    if (profile.GetDurabilityLevel() >= durability_level)
+      candidates.emplace_back(std::move(profile));
+  return AutoTuneStorageProfile(candidates, sample_rows, seconds);
+}
+
+int32_t DataLoader::AutoTuneStorageProfile(const std::vector<StorageProfile> &candidates,
+                                           uint64_t sample_rows, std::vector<double> *seconds) {
+  const auto &pimpl = *pimpl_db_handler_;
+  if (IsInMemoryUse() || pimpl.db_table_columns_.empty() || candidates.empty())
+    return SQLITE_MISUSE;
+
+  std::size_t best{0};
+  auto res = StorageProfile::AutoTune(pimpl.partition_name_ + "_autotune",
+                                      pimpl.db_table_columns_, candidates, sample_rows,
+                                      best, seconds);
+  if (res != SQLITE_OK)
+    return res;
+  return SetStorageProfile(candidates[best]);
+}
+
+int32_t DataLoader::CreateSchemaTable(std::string_view table_name,
+                                      std::string_view struct_template,
+                                      const char *create_table_sql) {
+  pimpl_db_handler_->SetDataBaseTableName(std::string{table_name});
+  pimpl_db_handler_->db_table_struct_template_ = std::string{struct_template};
+  pimpl_db_handler_->db_table_columns_ =
+      struct_template_to_columns(pimpl_db_handler_->db_table_struct_template_);
+  pimpl_db_handler_->ClearStatementCache();
+  pimpl_db_handler_->UpdateEncodedColumns();
+  auto res = RunSqlScript(create_table_sql);
+  if (res == SQLITE_OK && !pimpl_db_handler_->index_manager_.GetIndexes().empty())
+    res = RunSqlScript(pimpl_db_handler_->index_manager_.GetCreateScript(
+        pimpl_db_handler_->db_table_name_));
+  if (pimpl_db_handler_->write_behind_)
+    pimpl_db_handler_->write_behind_->SetTable(pimpl_db_handler_->db_table_name_,
+                                               pimpl_db_handler_->db_table_columns_);
+  if (res == SQLITE_OK && !pimpl_db_handler_->partition_names_.empty())
+    res = SwitchPartition(pimpl_db_handler_->partition_name_,
+                          pimpl_db_handler_->partition_names_);
+  return res;
+}
+
+sqlite3_stmt *DataLoader::GetSchemaStatement(const char *sql_script) {
+  auto &cache = pimpl_db_handler_->schema_statement_cache_;
+  auto it = cache.find(sql_script);
+  pimpl_db_handler_->query_stats_.RecordStatementCacheLookup(it != cache.end());
+  if (it != cache.end())
+    return it->second;
+
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v3(*pimpl_db_handler_->database_, sql_script, -1,
+                                SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Statement preparation results in error: "
+              << sqlite3_errmsg(*pimpl_db_handler_->database_) << std::endl;
+    sqlite3_finalize(stmt);
+    return nullptr;
+  }
+
+  cache.emplace(sql_script, stmt);
+  return stmt;
+}
+
+int32_t DataLoader::RunSchemaStatement(sqlite3_stmt *stmt) {
+  auto res = pimpl_db_handler_->RunStatement(stmt);
+  if (res == SQLITE_OK)
+    pimpl_db_handler_->inserted_rows_.fetch_add(1, std::memory_order_relaxed);
+  pimpl_db_handler_->NoteCommittedRows();
+  return res;
 }
 
 bool DataLoader::IsInMemoryUse() const noexcept {
@@ -189,41 +766,391 @@ bool DataLoader::IsInMemoryUse() const noexcept {
 }
 
 bool DataLoader::IsDataBaseSizeLimitReached() const noexcept {
-  return DB_SIZE_LIMIT <= pimpl_db_handler_->GetDataBaseSize();
+  return pimpl_db_handler_->db_size_limit_ <= pimpl_db_handler_->GetDataBaseSize();
 }
 
-bool DataLoader::IsDataBaseTableExist(const std::string &table_name) {
-  if (!pimpl_db_handler_->is_data_table_exist_) {
-    std::string db_template = "SELECT COUNT(type) from sqlite_master WHERE type = 'table' AND name" 
-                              " = '%1%'";
-    std::string sql_script = boost::str(boost::format{db_template} % table_name);
-    return pimpl_db_handler_->is_data_table_exist_ = (RunSqlScript(sql_script) == SQLITE_OK);
+void DataLoader::SetDataBaseSizeLimit(uint64_t size_limit) noexcept {
+  pimpl_db_handler_->db_size_limit_ = size_limit;
+}
+
+std::size_t DataLoader::GetMemoryUsage() const noexcept {
+  std::size_t memory_usage{0};
+  for (auto op : {SQLITE_DBSTATUS_CACHE_USED, SQLITE_DBSTATUS_SCHEMA_USED,
+                  SQLITE_DBSTATUS_STMT_USED}) {
+    int current{0};
+    int highwater{0};
+    if (sqlite3_db_status(*pimpl_db_handler_->database_, op, &current, &highwater, 0) ==
+        SQLITE_OK)
+      memory_usage += static_cast<std::size_t>(current);
   }
-  // set to false after backup pimpl_db_handler_->is_data_table_exist_;
 
+  if (pimpl_db_handler_->result_cache_)
+    memory_usage += pimpl_db_handler_->result_cache_->GetMetrics().memory_usage;
+  return memory_usage;
+}
+
+uint64_t DataLoader::GetDataBaseSize() const noexcept {
+  return pimpl_db_handler_->GetDataBaseSize();
 }
 
-bool DataLoader::IsDataBaseTableExist(std::string &&table_name) {
-  if (!pimpl_db_handler_->is_data_table_exist_) {
-    std::string db_template = "SELECT COUNT(type) from sqlite_master WHERE type = 'table' AND name" 
-                              " = '%1%'";
-    std::string sql_script = boost::str(boost::format{db_template} % table_name);
-    return pimpl_db_handler_->is_data_table_exist_ = (RunSqlScript(sql_script) == SQLITE_OK);
+/// Partitions left by the previous run (db_name_1, db_name_2 ...) are picked up,
+/// the last one becomes the current partition.
+int32_t DataLoader::EnablePartitioning(std::chrono::seconds rotation_interval) {
+  if (IsInMemoryUse() || pimpl_db_handler_->balance_aggregate_ ||
+      pimpl_db_handler_->value_dictionary_)
+    return SQLITE_MISUSE;
+
+  auto &pimpl = *pimpl_db_handler_;
+  pimpl.is_partitioning_enabled_ = true;
+  pimpl.rotation_interval_ = rotation_interval;
+  pimpl.partition_start_time_ = std::chrono::steady_clock::now();
+
+  std::vector<std::string> partition_names{pimpl.partition_name_};
+  for (std::size_t idx = 1; IsFileExist(pimpl.db_name_ + "_" + std::to_string(idx)); ++idx)
+    partition_names.push_back(pimpl.db_name_ + "_" + std::to_string(idx));
+  if (partition_names.size() == 1)
+    return SQLITE_OK;
+
+  auto current_name = partition_names.back();
+  partition_names.pop_back();
+  return SwitchPartition(current_name, partition_names);
+}
+
+int32_t DataLoader::RotatePartition() {
+  if (IsInMemoryUse())
+    return SQLITE_MISUSE;
+
+  if (!sqlite3_get_autocommit(*pimpl_db_handler_->database_))
+    return SQLITE_BUSY;
+
+  auto partition_names = pimpl_db_handler_->partition_names_;
+  partition_names.push_back(pimpl_db_handler_->partition_name_);
+  return SwitchPartition(pimpl_db_handler_->db_name_ + "_" +
+                         std::to_string(partition_names.size()), partition_names);
+}
+
+/// Hot database is the shared in-memory one the loader writes to, warming it
+/// replaces the schema, so cached statements and the catalog are dropped.
+int32_t DataLoader::EnableWriteBehind(const std::string &disk_db_name,
+                                      const WriteBehind::Options &options) {
+  auto &pimpl = *pimpl_db_handler_;
+  if (!IsInMemoryUse() || pimpl.is_partitioning_enabled_ || pimpl.write_behind_ ||
+      pimpl.value_dictionary_)
+    return SQLITE_MISUSE;
+
+  auto write_behind = std::make_unique<WriteBehind>(disk_db_name, options);
+  pimpl.ClearStatementCache();
+  bool is_warmed{false};
+  auto res = write_behind->Open(pimpl.db_name_, *pimpl.database_, is_warmed);
+  if (is_warmed) {
+    pimpl.schema_catalog_.Invalidate();
+    pimpl.is_size_dirty_.store(true, std::memory_order_relaxed);
   }
-  // set to false after backup pimpl_db_handler_->is_data_table_exist_;
+  if (res != SQLITE_OK)
+    return res;
+
+  if (!pimpl.db_table_name_.empty())
+    write_behind->SetTable(pimpl.db_table_name_, pimpl.db_table_columns_);
+  write_behind->Start();
+  pimpl.write_behind_ = std::move(write_behind);
+  return SQLITE_OK;
 }
 
-bool DataLoader::IsDataBaseTableExist() {
-  if (!pimpl_db_handler_->is_data_table_exist_) {
-    std::string db_template = "SELECT COUNT(type) from sqlite_master WHERE type = 'table' AND name" 
-                              " = '%1%'";
-    std::string sql_script = boost::str(boost::format{db_template} % GetDataBaseTableName());
-    return pimpl_db_handler_->is_data_table_exist_ = (RunSqlScript(sql_script) == SQLITE_OK);
+int32_t DataLoader::FlushWriteBehind() {
+  return pimpl_db_handler_->write_behind_ ? pimpl_db_handler_->write_behind_->Flush() :
+                                            SQLITE_OK;
+}
+
+WriteBehind::Metrics DataLoader::GetWriteBehindMetrics() const noexcept {
+  return pimpl_db_handler_->write_behind_ ? pimpl_db_handler_->write_behind_->GetMetrics() :
+                                            WriteBehind::Metrics{};
+}
+
+std::size_t DataLoader::GetPartitionsCount() const noexcept {
+  return pimpl_db_handler_->partition_names_.size() + 1;
+}
+
+/// Older partitions are read through the <table>_partitions view; rowid is not
+/// unique across partitions, so the cursor is not paged.
+SelectCursor DataLoader::OpenPartitionsSelectCursor(
+    const std::initializer_list<std::string> &val_lst) {
+  if (val_lst.size() == 0)
+    return SelectCursor{SQLITE_MISMATCH};
+
+  if (!IsDataBaseTableExist())
+    return SelectCursor{SQLITE_INTERNAL};
+
+  auto table_name = pimpl_db_handler_->partition_names_.empty() ?
+      pimpl_db_handler_->db_table_name_ : pimpl_db_handler_->db_table_name_ + "_partitions";
+  if (pimpl_db_handler_->read_pool_)
+    return SelectCursor{pimpl_db_handler_->read_pool_->AcquireReader(), table_name,
+                        init_list_to_string(val_lst)};
+
+  return SelectCursor{*pimpl_db_handler_->database_, table_name, init_list_to_string(val_lst)};
+}
+
+/// Size is queried again only after a commit marked it stale, so every write
+/// checks the limit without a query of its own.
+bool DataLoader::CheckPartitionRotation() {
+  auto &pimpl = *pimpl_db_handler_;
+  if (!pimpl.is_partitioning_enabled_)
+    return false;
+
+  bool is_expired = pimpl.rotation_interval_.count() > 0 &&
+      std::chrono::steady_clock::now() - pimpl.partition_start_time_ >= pimpl.rotation_interval_;
+  if (!is_expired && !IsDataBaseSizeLimitReached())
+    return false;
+
+  return RotatePartition() == SQLITE_OK;
+}
+
+int32_t DataLoader::SwitchPartition(const std::string &partition_name,
+                                    const std::vector<std::string> &partition_names) {
+  auto &pimpl = *pimpl_db_handler_;
+  sqlite3 *database{nullptr};
+  auto res = pimpl.OpenDataBase(partition_name, &database);
+  if (res != SQLITE_OK) {
+    sqlite3_close(database);
+    return res;
   }
-  // set to false after backup pimpl_db_handler_->is_data_table_exist_;
+
+  pimpl.ClearStatementCache();
+  pimpl.read_pool_.reset();
+  sqlite3_close(*pimpl.database_);
+  *pimpl.database_ = database;
+  if (pimpl.result_cache_)
+    pimpl.result_cache_->Attach(database);
+  pimpl.partition_name_ = partition_name;
+  pimpl.partition_names_ = partition_names;
+  pimpl.partition_start_time_ = std::chrono::steady_clock::now();
+  pimpl.is_size_dirty_.store(true, std::memory_order_relaxed);
+
+  // page_size of the profile needs the new partition still empty
+  if (pimpl.storage_profile_)
+    RunSqlScript(pimpl.storage_profile_->GetWriterScript(false));
+  if (pimpl.read_pool_size_)
+    RunSqlScript("PRAGMA journal_mode=WAL;");
+  if (!pimpl.db_table_name_.empty() && !pimpl.db_table_struct_template_.empty()) {
+    std::string create_table_template = "CREATE TABLE IF NOT EXISTS %1% (%2%);";
+    res = RunSqlScript(boost::str(boost::format{create_table_template} % pimpl.db_table_name_ %
+                                  pimpl.db_table_struct_template_));
+    if (res == SQLITE_OK && !pimpl.index_manager_.GetIndexes().empty())
+      res = RunSqlScript(pimpl.index_manager_.GetCreateScript(pimpl.db_table_name_));
+  }
+  RunSqlScript(GetPartitionsScript());
+  if (pimpl.read_pool_size_)
+    res = EnableReadPool(pimpl.read_pool_size_);
+  return res;
+}
+
+/// ATTACH DATABASE 'db_1' AS partition_1; ... CREATE TEMP VIEW table_partitions AS
+/// SELECT * FROM main.table UNION ALL SELECT * FROM partition_1.table ...
+std::string DataLoader::GetPartitionsScript() const {
+  const auto &pimpl = *pimpl_db_handler_;
+  if (pimpl.partition_names_.empty() || pimpl.db_table_name_.empty())
+    return "";
+
+  // most recent partitions are attached first, up to the connection limit
+  auto attached_limit = static_cast<std::size_t>(
+      sqlite3_limit(*pimpl.database_, SQLITE_LIMIT_ATTACHED, -1));
+  std::string sql_script;
+  std::string view_script = "CREATE TEMP VIEW IF NOT EXISTS " + pimpl.db_table_name_ +
+                            "_partitions AS SELECT * FROM main." + pimpl.db_table_name_;
+  auto count = std::min(attached_limit, pimpl.partition_names_.size());
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto &name = pimpl.partition_names_[pimpl.partition_names_.size() - 1 - i];
+    auto alias = "partition_" + std::to_string(i);
+    sql_script += "ATTACH DATABASE '" + name + "' AS " + alias + ";";
+    view_script += " UNION ALL SELECT * FROM " + alias + "." + pimpl.db_table_name_;
+  }
+  return sql_script + view_script + ";";
+}
+
+int32_t DataLoader::EnableBalanceAggregate(const std::string &address_column,
+                                           const std::string &amount_column,
+                                           const BalanceAggregate::Options &options) {
+  auto &pimpl = *pimpl_db_handler_;
+  if (pimpl.is_partitioning_enabled_ || pimpl.db_table_name_.empty() ||
+      pimpl.value_dictionary_)
+    return SQLITE_MISUSE;
+
+  pimpl.balance_aggregate_.reset();
+  auto balance_aggregate = std::make_unique<BalanceAggregate>(options);
+  auto ddl_count = pimpl.schema_catalog_.GetDdlCount();
+  auto res = balance_aggregate->Attach(*pimpl.database_, pimpl.db_table_name_,
+                                       address_column, amount_column);
+  if (pimpl.schema_catalog_.GetDdlCount() != ddl_count)
+    pimpl.schema_catalog_.Invalidate();
+  if (res == SQLITE_OK)
+    pimpl.balance_aggregate_ = std::move(balance_aggregate);
+  return res;
+}
+
+int32_t DataLoader::GetBalance(const std::string &address, BalanceAggregate::Balance &balance) {
+  if (!pimpl_db_handler_->balance_aggregate_)
+    return SQLITE_MISUSE;
+  return pimpl_db_handler_->balance_aggregate_->GetBalance(address, balance);
+}
+
+int32_t DataLoader::VerifyBalanceAggregate(
+    std::vector<BalanceAggregate::Mismatch> &mismatches) {
+  if (!pimpl_db_handler_->balance_aggregate_)
+    return SQLITE_MISUSE;
+  return pimpl_db_handler_->balance_aggregate_->Verify(mismatches);
+}
+
+BalanceAggregate::Metrics DataLoader::GetBalanceAggregateMetrics() const noexcept {
+  return pimpl_db_handler_->balance_aggregate_ ?
+      pimpl_db_handler_->balance_aggregate_->GetMetrics() : BalanceAggregate::Metrics{};
+}
+
+/// Select statements are cached with the projection, so they are dropped as well.
+int32_t DataLoader::EnableDictionaryEncoding(const std::initializer_list<std::string> &columns,
+                                             const ValueDictionary::Options &options) {
+  auto &pimpl = *pimpl_db_handler_;
+  if (pimpl.is_partitioning_enabled_ || pimpl.write_behind_ || pimpl.balance_aggregate_ ||
+      pimpl.value_dictionary_ || pimpl.db_table_name_.empty() || columns.size() == 0)
+    return SQLITE_MISUSE;
+
+  for (const auto &column : columns)
+    if (std::find(pimpl.db_table_columns_.begin(), pimpl.db_table_columns_.end(), column) ==
+        pimpl.db_table_columns_.end())
+      return SQLITE_MISMATCH;
+
+  // TEXT columns promise text values, encoded ones are BLOB
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v2(*pimpl.database_,
+                                "SELECT name, type FROM pragma_table_info(?1);", -1, &stmt,
+                                nullptr);
+  if (res != SQLITE_OK)
+    return res;
+  sqlite3_bind_text(stmt, 1, pimpl.db_table_name_.c_str(), -1, SQLITE_STATIC);
+  bool is_text_encoded{false};
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW) {
+    auto name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    auto type = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+    is_text_encoded = is_text_encoded ||
+                      (name && std::find(columns.begin(), columns.end(), name) != columns.end() &&
+                       ValueDictionary::IsTextAffinity(type ? type : ""));
+  }
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_DONE)
+    return res;
+  if (is_text_encoded)
+    return SQLITE_MISMATCH;
+
+  auto value_dictionary = std::make_unique<ValueDictionary>(options);
+  auto ddl_count = pimpl.schema_catalog_.GetDdlCount();
+  res = value_dictionary->Attach(*pimpl.database_, pimpl.db_table_name_);
+  if (pimpl.schema_catalog_.GetDdlCount() != ddl_count)
+    pimpl.schema_catalog_.Invalidate();
+  if (res != SQLITE_OK)
+    return res;
+
+  pimpl.ClearStatementCache();
+  pimpl.value_dictionary_ = std::move(value_dictionary);
+  pimpl.encoded_table_name_ = pimpl.db_table_name_;
+  pimpl.encoded_column_names_.assign(columns.begin(), columns.end());
+  pimpl.UpdateEncodedColumns();
+  return SQLITE_OK;
+}
+
+ValueDictionary::Metrics DataLoader::GetDictionaryMetrics() const noexcept {
+  return pimpl_db_handler_->value_dictionary_ ?
+      pimpl_db_handler_->value_dictionary_->GetMetrics() : ValueDictionary::Metrics{};
+}
+
+int32_t DataLoader::AddDBTableIndex(const std::initializer_list<std::string> &columns,
+                                    bool is_unique) {
+  auto &pimpl = *pimpl_db_handler_;
+  if (columns.size() == 0)
+    return SQLITE_MISUSE;
+
+  pimpl.index_manager_.Declare(columns, is_unique);
+  if (pimpl.db_table_name_.empty() || !IsDataBaseTableExist())
+    return SQLITE_OK;
+  return RunSqlScript(pimpl.index_manager_.GetCreateScript(pimpl.db_table_name_));
+}
+
+int32_t DataLoader::BeginBulkLoad() {
+  auto &pimpl = *pimpl_db_handler_;
+  if (pimpl.index_manager_.IsBulkLoad())
+    return SQLITE_MISUSE;
+
+  auto drop_script = pimpl.index_manager_.GetDropScript(pimpl.db_table_name_);
+  auto res = (pimpl.db_table_name_.empty() || drop_script.empty()) ? SQLITE_OK :
+                                                                      RunSqlScript(drop_script);
+  if (res == SQLITE_OK)
+    pimpl.index_manager_.SetBulkLoad(true);
+  return res;
+}
+
+/// CREATE INDEX sorts the rows once, which is cheaper than a B-tree insert per row.
+int32_t DataLoader::EndBulkLoad() {
+  auto &pimpl = *pimpl_db_handler_;
+  if (!pimpl.index_manager_.IsBulkLoad())
+    return SQLITE_MISUSE;
+
+  pimpl.index_manager_.SetBulkLoad(false);
+  auto create_script = pimpl.index_manager_.GetCreateScript(pimpl.db_table_name_);
+  if (pimpl.db_table_name_.empty() || create_script.empty())
+    return SQLITE_OK;
+  return RunSqlScript(create_script);
+}
+
+int32_t DataLoader::GetIndexUsage(IndexManager::UsageStats &usage_stats) {
+  auto &pimpl = *pimpl_db_handler_;
+  return pimpl.index_manager_.CollectUsage(*pimpl.database_, pimpl.db_table_name_,
+                                           pimpl.query_stats_, usage_stats);
+}
+
+int32_t DataLoader::ExportTable(const std::string &file_path, ColumnarWriter::Report &report,
+                                const ColumnarWriter::Options &options) {
+  if (!IsDataBaseTableExist())
+    return SQLITE_INTERNAL;
+
+  ColumnarWriter writer{options};
+  auto &pimpl = *pimpl_db_handler_;
+  // dictionary encoded columns are exported decoded, the subquery stands for the table
+  auto table_name = pimpl.encoded_columns_.empty() ? pimpl.db_table_name_ :
+      "(SELECT " + pimpl.GetProjection(pimpl.db_table_columns_, !pimpl.read_pool_) +
+      " FROM " + pimpl.db_table_name_ + ")";
+  if (pimpl.read_pool_) {
+    auto lease = pimpl.read_pool_->AcquireReader();
+    return writer.Export(lease.Get(), table_name, file_path, report);
+  }
+  return writer.Export(*pimpl.database_, table_name, file_path, report);
+}
+
+bool DataLoader::IsDataBaseTableExist(const std::string &table_name) {
+  return pimpl_db_handler_->schema_catalog_.IsTableExist(table_name);
+}
+
+bool DataLoader::IsDataBaseTableExist() {
+  return IsDataBaseTableExist(pimpl_db_handler_->db_table_name_);
+}
+
+SchemaCatalog &DataLoader::GetSchemaCatalog() noexcept {
+  return pimpl_db_handler_->schema_catalog_;
+}
+
+QueryStats &DataLoader::GetQueryStats() noexcept {
+  return pimpl_db_handler_->query_stats_;
+}
+
+DataLoader::AllocationMetrics DataLoader::GetAllocationMetrics() const {
+  AllocationMetrics metrics{};
+  metrics.inserted_rows = pimpl_db_handler_->inserted_rows_.load(std::memory_order_relaxed);
+  metrics.pool_allocations = MemoryPool::GetInstance().GetStats().allocations;
+  return metrics;
 }
 
 DataLoader::~DataLoader() {
+  pimpl_db_handler_->write_behind_.reset();
+  pimpl_db_handler_->balance_aggregate_.reset();
+  pimpl_db_handler_->value_dictionary_.reset();
+  pimpl_db_handler_->result_cache_.reset();
+  pimpl_db_handler_->ClearStatementCache();
   sqlite3_close(*((pimpl_db_handler_->database_).get()));
 }
 
@@ -232,15 +1159,155 @@ void DataLoader::PimplDBHandler::SetDataBaseTableName(const std::string &db_tabl
     db_table_name_ = db_table_name;
 }
 
-int32_t DataLoader::PimplDBHandler::GetDataBaseSize() const noexcept {
+void DataLoader::PimplDBHandler::UpdateEncodedColumns() {
+  encoded_columns_.clear();
+  if (!value_dictionary_ || db_table_name_ != encoded_table_name_)
+    return;
+
+  for (const auto &column : db_table_columns_)
+    encoded_columns_.push_back(std::find(encoded_column_names_.begin(),
+                                         encoded_column_names_.end(), column) !=
+                               encoded_column_names_.end());
+}
+
+int32_t DataLoader::PimplDBHandler::OpenDataBase(const std::string &db_name,
+                                                 sqlite3 **database) {
+  auto res = sqlite3_open_v2(db_name.c_str(), database,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                             nullptr);
+  if (res == SQLITE_OK) {
+    sqlite3_commit_hook(*database, &PimplDBHandler::CommitHook, this);
+    schema_catalog_.Attach(*database);
+    query_stats_.Attach(*database);
+  }
+  return res;
+}
+
+/// Commit is visible to the readers once the connection is back in autocommit mode.
+void DataLoader::PimplDBHandler::FinishCommit() noexcept {
+  if (result_cache_ && sqlite3_get_autocommit(*database_))
+    result_cache_->OnCommitted();
+}
+
+int DataLoader::PimplDBHandler::CommitHook(void *pimpl_db_handler) {
+  auto pimpl = static_cast<PimplDBHandler *>(pimpl_db_handler);
+  pimpl->is_size_dirty_.store(true, std::memory_order_relaxed);
+  if (pimpl->result_cache_)
+    pimpl->result_cache_->OnCommit();
+  return 0;
+}
+
+/// page_count * page_size is exact for the in-memory database as well, WAL
+/// frames not checkpointed yet live in the -wal file.
+uint64_t DataLoader::PimplDBHandler::GetDataBaseSize() noexcept {
+  if (!is_size_dirty_.exchange(false, std::memory_order_relaxed))
+    return db_size_;
+
+  db_size_ = static_cast<uint64_t>(QueryInt64("PRAGMA page_count;")) *
+             static_cast<uint64_t>(QueryInt64("PRAGMA page_size;"));
   struct stat sb{};
-  if (stat(db_name_.c_str(), &sb) == -1) {
-    // throw exception here ??
-    std::cout << "Error occured while retrieving database size " 
-              << std::strerror(errno) << std::endl;
+  if (db_name_.find("memory") == std::string::npos &&
+      stat((partition_name_ + "-wal").c_str(), &sb) == 0)
+    db_size_ += sb.st_size;
+  return db_size_;
+}
+
+int64_t DataLoader::PimplDBHandler::QueryInt64(std::string_view sql_script) {
+  auto stmt = GetStatement(sql_script);
+  if (!stmt)
+    return 0;
+
+  int64_t res{0};
+  if (sqlite3_step(stmt) == SQLITE_ROW)
+    res = sqlite3_column_int64(stmt, 0);
+  sqlite3_reset(stmt);
+  return res;
+}
+
+sqlite3_stmt *DataLoader::PimplDBHandler::FindCachedStatement(const std::string &key) noexcept {
+  auto it = statement_cache_.find(key);
+  query_stats_.RecordStatementCacheLookup(it != statement_cache_.end());
+  return (it != statement_cache_.end()) ? it->second : nullptr;
+}
+
+sqlite3_stmt *DataLoader::PimplDBHandler::PrepareCachedStatement(const std::string &key,
+                                                                 const std::string &sql_script) {
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v3(*database_, sql_script.c_str(),
+                                static_cast<int>(sql_script.size()) + 1,
+                                SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Statement preparation results in error: " << sqlite3_errmsg(*database_)
+              << std::endl;
+    sqlite3_finalize(stmt);
+    return nullptr;
   }
 
-  return (sb.st_size / 1000) / 1000;
+  statement_cache_.emplace(key, stmt);
+  return stmt;
+}
+
+void DataLoader::PimplDBHandler::ClearStatementCache() noexcept {
+  for (auto &el : statement_cache_)
+    sqlite3_finalize(el.second);
+  statement_cache_.clear();
+  insert_stmt_ = nullptr;
+  for (auto &el : schema_statement_cache_)
+    sqlite3_finalize(el.second);
+  schema_statement_cache_.clear();
+}
+
+/// Current table insert statement is kept aside, so the per row path builds no key.
+sqlite3_stmt *DataLoader::PimplDBHandler::GetInsertStatement() {
+  if (insert_stmt_) {
+    query_stats_.RecordStatementCacheLookup(true);
+    return insert_stmt_;
+  }
+
+  std::string key = "INSERT:" + db_table_name_ + ":" + db_table_struct_template_;
+  insert_stmt_ = FindCachedStatement(key);
+  if (insert_stmt_)
+    return insert_stmt_;
+
+  std::string insert_template = "INSERT INTO %1% (%2%) VALUES (%3%);";
+  insert_stmt_ = PrepareCachedStatement(key, boost::str(boost::format{insert_template} %
+                                                        db_table_name_ %
+                                                        columns_to_string(db_table_columns_) %
+                                                        placeholders_to_string(
+                                                            db_table_columns_.size())));
+  return insert_stmt_;
+}
+
+/// Key is assembled in the scratch buffer, its capacity is kept between calls.
+sqlite3_stmt *DataLoader::PimplDBHandler::GetStatement(std::string_view sql_script) {
+  scratch_key_.assign(sql_script);
+  auto stmt = FindCachedStatement(scratch_key_);
+  return stmt ? stmt : PrepareCachedStatement(scratch_key_, scratch_key_);
+}
+
+/// last_insert_rowid is the last row of the committed transaction, rows are
+/// appended to the current table only.
+void DataLoader::PimplDBHandler::NoteCommittedRows() noexcept {
+  if (write_behind_ && sqlite3_get_autocommit(*database_))
+    write_behind_->NoteCommitted(sqlite3_last_insert_rowid(*database_));
+}
+
+int32_t DataLoader::PimplDBHandler::RunStatement(sqlite3_stmt *stmt) {
+  int32_t res{SQLITE_ROW};
+  while (res == SQLITE_ROW)
+    res = sqlite3_step(stmt);
+  FinishCommit();
+  if (res == SQLITE_DONE)
+    res = SQLITE_OK;
+  else
+    // throw exception here
+    std::cout << "Statement evaluation results in error: " << sqlite3_errmsg(*database_)
+              << std::endl;
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return res;
 }
 
 } // namespace client
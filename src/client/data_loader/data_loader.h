@@ -11,10 +11,29 @@ extern "C" {
 #include <sqlite3.h>
 }
 
+#include <chrono>
 #include <cstdint>
 #include <initializer_list>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "balance_aggregate/balance_aggregate.h"
+#include "columnar_snapshot/columnar_snapshot.h"
+#include "connection_pool/connection_pool.h"
+#include "handle_registry/handle_registry.h"
+#include "index_manager/index_manager.h"
+#include "memory_pool/memory_pool.h"
+#include "query_stats/query_stats.h"
+#include "read_snapshot/read_snapshot.h"
+#include "result_cache/result_cache.h"
+#include "schema_catalog/schema_catalog.h"
+#include "select_cursor/select_cursor.h"
+#include "storage_profile/storage_profile.h"
+#include "table_schema/table_schema.h"
+#include "value_dictionary/value_dictionary.h"
+#include "write_behind/write_behind.h"
 
 /// \namespace crypto_wallet.
 /// \brief Project namespace.
@@ -29,20 +48,30 @@ class DataLoader {
   /// \brief DataLoader destructor.
   ~DataLoader();
 
-  /// \brief Get instance of class DataLoader.
+  /// \brief Get instance of class DataLoader of the path, kept open till exit.
+  /// \details Instance is pinned in the registry: it is never evicted and the budgets
+  /// \details do not close it, GetRegistry().Acquire gives handles closed while idle.
   /// \param[in] path Path to the DB.
   /// \return Instance of class DataLoader.
   inline static DataLoader &GetDataLoaderInstance(std::string &&path) {
-    static DataLoader data_loader{path};
-    return data_loader;
+    return GetRegistry().AcquirePinned(path);
   }
 
-  /// \brief Get instance of class DataLoader.
+  /// \brief Get instance of class DataLoader of the path, kept open till exit.
+  /// \details Instance is pinned in the registry: it is never evicted and the budgets
+  /// \details do not close it, GetRegistry().Acquire gives handles closed while idle.
   /// \param[in] path Path to the DB.
   /// \return Instance of class DataLoader.
   inline static DataLoader &GetDataLoaderInstance(const std::string &path) {
-    static DataLoader data_loader{path};
-    return data_loader;
+    return GetRegistry().AcquirePinned(path);
+  }
+
+  /// \brief Get registry of the process DataLoader instances, use Acquire for
+  /// \brief wallets which may be closed while idle.
+  /// \return Registry.
+  inline static HandleRegistry<DataLoader> &GetRegistry() {
+    static HandleRegistry<DataLoader> registry{HandleRegistry<DataLoader>::Options{}};
+    return registry;
   }
 
   /// \brief Execute passed SQL script.
@@ -75,14 +104,161 @@ class DataLoader {
   /// \return Result of creation (Created or not and why).
   int32_t CreateDBTable(const std::string &table_name);
 
+  /// \brief Create table described by the schema and make it the current one.
+  /// \return Result of creation (Created or not and why).
+  template <typename Schema>
+  int32_t CreateDBTable() {
+    static constexpr auto struct_template = Schema::StructTemplate();
+    static constexpr auto create_table_sql = Schema::CreateTableSql();
+    return CreateSchemaTable(Schema::kName, struct_template.view(), create_table_sql.c_str());
+  }
+
+  /// \brief Insert native values into the table described by the schema.
+  /// \details Values count and types are checked against the schema at compile time.
+  /// \param[in] values Values in columns order.
+  /// \return Result of the insert.
+  template <typename Schema, typename... Values>
+  int32_t InsertIntoTable(const Values &...values) {
+    static constexpr auto insert_sql = Schema::InsertSql();
+    CheckPartitionRotation();
+    auto stmt = GetSchemaStatement(insert_sql.c_str());
+    if (!stmt)
+      return SQLITE_ERROR;
+    auto res = Schema::Bind(stmt, values...);
+    return (res == SQLITE_OK) ? RunSchemaStatement(stmt) : res;
+  }
+
   /// \brief Insert data into database.
   /// \param[in] val_lst List of values.
   int32_t InsertIntoTable(const std::initializer_list<std::string> &val_lst);
 
+  /// \brief Insert row into database.
+  /// \param[in] row Row values, one per table column.
+  /// \return Result of the insert.
+  int32_t InsertRow(const std::vector<std::string> &row);
+
+  /// \brief Insert rows in a single transaction.
+  /// \details Failed rows do not abort the batch, rows inserted successfully are
+  /// \details committed. Every row gets the error if the transaction cannot begin
+  /// \details (inside the caller transaction too) or commit.
+  /// \param[in] rows Rows to insert.
+  /// \param[out] row_results Result of the insert per row, may be nullptr.
+  /// \return SQLITE_OK if all rows were inserted, otherwise last row or transaction error.
+  int32_t InsertBatch(const std::vector<std::vector<std::string>> &rows,
+                      std::vector<int32_t> *row_results = nullptr);
+
+  /// \brief Insert rows in a single transaction, values are bound without copies.
+  /// \details Values must stay valid until the call returns.
+  /// \param[in] values Values of all rows one row after another.
+  /// \param[in] columns_count Number of values in a row.
+  /// \param[out] row_results Result of the insert per row, may be nullptr.
+  /// \return SQLITE_MISUSE if values do not form whole rows, otherwise as above.
+  int32_t InsertBatch(const std::vector<std::string_view> &values, std::size_t columns_count,
+                      std::vector<int32_t> *row_results = nullptr);
+
+  /// \brief Begin write transaction (BEGIN IMMEDIATE).
+  /// \return Result of beginning the transaction.
+  int32_t BeginTransaction();
+
+  /// \brief Commit current transaction.
+  /// \return Result of the commit.
+  int32_t CommitTransaction();
+
+  /// \brief Roll back current transaction.
+  /// \return Result of the rollback.
+  int32_t RollbackTransaction();
+
   /// \brief Select values for the passed columns.
+  /// \details Served from the result cache if it is enabled.
   /// \param[in] val_lst List of values.
   int32_t SelectFromTable(const std::initializer_list<std::string> &val_list);
 
+  /// \brief Select values for the passed columns into the result.
+  /// \details Repeated select of the same columns runs no SQL while the result cache
+  /// \details is enabled and the table was not written in between. Without the read
+  /// \details pool a select inside an open transaction bypasses the cache.
+  /// \param[in] val_lst List of columns.
+  /// \param[out] result Selected rows, shared with the cache.
+  /// \return Result of the select.
+  int32_t SelectFromTable(const std::initializer_list<std::string> &val_lst,
+                          std::shared_ptr<const ResultCache::Result> &result);
+
+  /// \brief Enable cache of the select results, invalidated by writes of this
+  /// \brief DataLoader and, within a few milliseconds, by commits of other connections.
+  /// \param[in] memory_budget Max bytes held by cached results, 0 disables the cache.
+  void EnableResultCache(std::size_t memory_budget);
+
+  /// \brief Get result cache counters.
+  /// \return Counters snapshot, all zero if the cache is not enabled.
+  ResultCache::Metrics GetResultCacheMetrics() const;
+
+  /// \brief Open cursor streaming values of the passed columns.
+  /// \param[in] val_lst List of columns.
+  /// \param[in] page_size Number of rows fetched per page, 0 to fetch in a single pass.
+  /// \return Cursor over the selected rows.
+  SelectCursor OpenSelectCursor(const std::initializer_list<std::string> &val_lst,
+                                std::size_t page_size = 0);
+
+  /// \brief Switch database to WAL mode and open pool of read-only connections.
+  /// \details Selects are served by the pool afterwards, the own connection of
+  /// \details DataLoader is left to the writer. Readers are traced by GetQueryStats.
+  /// \details SelectFromTable and OpenSelectCursor may then be called from several
+  /// \details threads at once, every other method stays on the writer thread.
+  /// \param[in] readers_count Number of read-only connections.
+  /// \return SQLITE_MISUSE for the in-memory database, otherwise result of opening
+  /// \return the pool.
+  int32_t EnableReadPool(std::size_t readers_count);
+
+  /// \brief Pin point-in-time view of the current partition for reads.
+  /// \details Switches database to WAL mode, the writer keeps committing while the
+  /// \details snapshot is held. Attached partitions are pinned at their first read.
+  /// \return Snapshot, not pinned (SQLITE_MISUSE) for the in-memory database.
+  ReadSnapshot OpenReadSnapshot();
+
+  /// \brief Get read pool contention metrics.
+  /// \return Metrics, all zero if the pool is not enabled.
+  ConnectionPool::Metrics GetReadPoolMetrics() const;
+
+  /// \brief Apply storage profile to the current connection, it is applied again to
+  /// \brief every partition and reader opened afterwards.
+  /// \details Must be called outside of transaction. page_size changes a database
+  /// \details without tables only, WAL is kept while the read pool is enabled.
+  /// \param[in] profile Storage profile.
+  /// \return SQLITE_BUSY inside transaction, otherwise result of the pragmas.
+  int32_t SetStorageProfile(const StorageProfile &profile);
+
+  /// \brief Apply named storage profile.
+  /// \param[in] profile_name "bulk-load", "balanced-oltp", "read-mostly" or "durable".
+  /// \return SQLITE_NOTFOUND if there is no such profile, otherwise result of applying it.
+  int32_t SetStorageProfile(const std::string &profile_name);
+
+  /// \brief Get applied storage profile.
+  /// \return Storage profile, SQLite defaults if none was applied.
+  StorageProfile GetStorageProfile() const;
+
+  /// \brief Run sample workload on the current table columns with every named
+  /// \brief profile in a scratch file next to the database and apply the fastest.
+  /// \details Only profiles at least as durable as the applied one are tried, so
+  /// \details tuning never trades committed data for speed.
+  /// \param[in] sample_rows Number of rows in the workload.
+  /// \param[out] seconds Workload time per tried StorageProfile::GetProfiles() entry,
+  /// \param[out] in their order, may be nullptr.
+  /// \return SQLITE_MISUSE if database is in memory or table columns are not set,
+  /// \return otherwise result of applying the fastest profile.
+  int32_t AutoTuneStorageProfile(uint64_t sample_rows = 50000,
+                                 std::vector<double> *seconds = nullptr);
+
+  /// \brief Run sample workload on the current table columns with every candidate
+  /// \brief in a scratch file next to the database and apply the fastest.
+  /// \details Candidates are taken as they are, less durable ones included.
+  /// \param[in] candidates Candidate profiles.
+  /// \param[in] sample_rows Number of rows in the workload.
+  /// \param[out] seconds Workload time per candidate, may be nullptr.
+  /// \return SQLITE_MISUSE if database is in memory, table columns are not set or
+  /// \return there are no candidates, otherwise result of applying the fastest profile.
+  int32_t AutoTuneStorageProfile(const std::vector<StorageProfile> &candidates,
+                                 uint64_t sample_rows, std::vector<double> *seconds);
+
   /// \brief Is current database used as in-memory database.
   /// \return Result of checking wether the current DB is in memory.
   bool IsInMemoryUse() const noexcept;
@@ -91,18 +267,174 @@ class DataLoader {
   /// \return State of the check if database size limit reached.
   bool IsDataBaseSizeLimitReached() const noexcept;
 
+  /// \brief Set database size limit.
+  /// \param[in] size_limit Size limit in bytes.
+  void SetDataBaseSizeLimit(uint64_t size_limit) noexcept;
+
+  /// \brief Get memory held by the writer connection page cache, schema and
+  /// \brief statements plus cached select results.
+  /// \return Memory usage in bytes.
+  std::size_t GetMemoryUsage() const noexcept;
+
+  /// \brief Get database size, refreshed from page_count * page_size plus WAL size
+  /// \brief after commits only.
+  /// \return Size of the current partition in bytes.
+  uint64_t GetDataBaseSize() const noexcept;
+
+  /// \brief Roll writes over to the new partition file (db_name_1, db_name_2 ...)
+  /// \brief once the size limit is reached or the rotation interval expires.
+  /// \param[in] rotation_interval Max partition age, 0 to rotate by size only.
+  /// \return Result of opening partitions left by the previous run.
+  int32_t EnablePartitioning(std::chrono::seconds rotation_interval = std::chrono::seconds{0});
+
+  /// \brief Start new partition right away, must be called outside of transaction.
+  /// \return Result of the rotation.
+  int32_t RotatePartition();
+
+  /// \brief Get number of partitions including the current one.
+  /// \return Number of partitions.
+  std::size_t GetPartitionsCount() const noexcept;
+
+  /// \brief Open cursor over the current table in all attached partitions.
+  /// \param[in] val_lst List of columns.
+  /// \return Cursor over the selected rows.
+  SelectCursor OpenPartitionsSelectCursor(const std::initializer_list<std::string> &val_lst);
+
+  /// \brief Enable tiered storage: writes land in the in-memory database, committed
+  /// \brief rows are flushed into the disk database in the background.
+  /// \details Hot database is warmed from the disk one if it has tables, so it is
+  /// \details enabled before tables are created. Only rows written with the insert
+  /// \details methods of the current table are flushed.
+  /// \param[in] disk_db_name Disk database path.
+  /// \param[in] options Write-behind options (crash window, batch sizes).
+  /// \return SQLITE_MISUSE if database is not in memory or partitioned, otherwise
+  /// \return result of opening the disk database.
+  int32_t EnableWriteBehind(const std::string &disk_db_name,
+                            const WriteBehind::Options &options = WriteBehind::Options{});
+
+  /// \brief Flush committed rows into the disk database synchronously.
+  /// \return Result of the flush, SQLITE_OK if write-behind is not enabled.
+  int32_t FlushWriteBehind();
+
+  /// \brief Get write-behind counters.
+  /// \return Counters snapshot.
+  WriteBehind::Metrics GetWriteBehindMetrics() const noexcept;
+
+  /// \brief Maintain per-address balances of the current table in <table>_balances,
+  /// \brief updated by triggers in the same transaction as every write.
+  /// \details Aggregate is built from the table the first time, must be enabled
+  /// \details outside of transaction and is not available with partitioning.
+  /// \param[in] address_column Address column.
+  /// \param[in] amount_column Amount column, integer amounts.
+  /// \param[in] options Cache limits.
+  /// \return SQLITE_MISUSE if partitioned or table is not set, otherwise result of the setup.
+  int32_t EnableBalanceAggregate(const std::string &address_column,
+                                 const std::string &amount_column,
+                                 const BalanceAggregate::Options &options =
+                                     BalanceAggregate::Options{});
+
+  /// \brief Get balance of the address, answered from the cache or by the primary key.
+  /// \param[in] address Address.
+  /// \param[out] balance Balance and number of transactions, zero for unknown address.
+  /// \return SQLITE_MISUSE if aggregate is not enabled, otherwise result of the lookup.
+  int32_t GetBalance(const std::string &address, BalanceAggregate::Balance &balance);
+
+  /// \brief Recompute balances from the table and diff them with the aggregate.
+  /// \param[out] mismatches Addresses whose aggregate or cached balance differs.
+  /// \return SQLITE_MISUSE if aggregate is not enabled, otherwise result of the check.
+  int32_t VerifyBalanceAggregate(std::vector<BalanceAggregate::Mismatch> &mismatches);
+
+  /// \brief Get balance cache counters.
+  /// \return Counters snapshot, all zero if aggregate is not enabled.
+  BalanceAggregate::Metrics GetBalanceAggregateMetrics() const noexcept;
+
+  /// \brief Store values of the passed columns of the current table as ids of the
+  /// \brief <table>_dictionary rows, selects, cursors and exports decode them.
+  /// \details Applies to the text inserts (InsertIntoTable, InsertRow, InsertBatch),
+  /// \details rows inserted before keep their values. Ids are stored as BLOB, so
+  /// \details columns of TEXT affinity (declared TEXT, CHAR or CLOB) are refused.
+  /// \details Must be enabled outside of transaction, not available with
+  /// \details partitioning, write-behind or balance aggregate.
+  /// \param[in] columns Encoded columns.
+  /// \param[in] options Cache limits.
+  /// \return SQLITE_MISUSE if not available or already enabled, SQLITE_MISMATCH if
+  /// \return table has no such column or it has TEXT affinity, otherwise result of
+  /// \return the setup.
+  int32_t EnableDictionaryEncoding(const std::initializer_list<std::string> &columns,
+                                   const ValueDictionary::Options &options =
+                                       ValueDictionary::Options{});
+
+  /// \brief Get dictionary cache counters.
+  /// \return Counters snapshot, all zero if encoding is not enabled.
+  ValueDictionary::Metrics GetDictionaryMetrics() const noexcept;
+
+  /// \brief Declare secondary index of the loader tables, created with every table
+  /// \brief created afterwards and on the current table right away.
+  /// \param[in] columns Indexed columns.
+  /// \param[in] is_unique Index is unique.
+  /// \return Result of creating the index on the current table.
+  int32_t AddDBTableIndex(const std::initializer_list<std::string> &columns,
+                          bool is_unique = false);
+
+  /// \brief Suspend maintenance of declared non-unique indexes, they are dropped
+  /// \brief until EndBulkLoad.
+  /// \return SQLITE_MISUSE if bulk load is in progress, otherwise result of the drop.
+  int32_t BeginBulkLoad();
+
+  /// \brief Build indexes suspended by BeginBulkLoad, one sorted build per index.
+  /// \return SQLITE_MISUSE if bulk load is not in progress, otherwise result of the build.
+  int32_t EndBulkLoad();
+
+  /// \brief Get index usage of the current table by the statements run on the
+  /// \brief writer connection and the read pool connections.
+  /// \param[out] usage_stats Index usage.
+  /// \return Result of explaining the statements.
+  int32_t GetIndexUsage(IndexManager::UsageStats &usage_stats);
+
+  /// \brief Export the current table into a columnar snapshot file.
+  /// \details Scans on a read pool connection if the pool is enabled.
+  /// \param[in] file_path Snapshot path.
+  /// \param[out] report Export results.
+  /// \param[in] options Export options.
+  /// \return SQLITE_INTERNAL if table does not exist, otherwise result of the export.
+  int32_t ExportTable(const std::string &file_path, ColumnarWriter::Report &report,
+                      const ColumnarWriter::Options &options = ColumnarWriter::Options{});
+
   /// \brief Check if table with passed name is already exist in db.
+  /// \details Answered from the schema catalog, runs no SQL unless DDL was run.
   /// \param[in] table_name Table name.
-  /// \return Result of the check if the table with specified name is already
   /// \return Status of the passed db table.
   bool IsDataBaseTableExist(const std::string &table_name);
-  bool IsDataBaseTableExist(std::string &&table_name);
 
   /// brief Check if current database table exist.
   /// \return Status of the passed db table.
   bool IsDataBaseTableExist();
 
+  /// \brief Get schema catalog of the current partition.
+  /// \return Schema catalog.
+  SchemaCatalog &GetSchemaCatalog() noexcept;
+
+  /// \struct AllocationMetrics data_loader.h.
+  /// \brief Allocation counters, pool allocations are process wide.
+  /// \details Allocations per inserted row are deltas of both counters taken around
+  /// \details the inserts; SQLite allocations are counted once MemoryPool::ConfigureSqlite
+  /// \details routed them into the pool.
+  struct AllocationMetrics {
+    uint64_t inserted_rows{0};
+    uint64_t pool_allocations{0};
+  };
+
+  /// \brief Get allocation counters.
+  /// \return Counters snapshot.
+  AllocationMetrics GetAllocationMetrics() const;
+
+  /// \brief Get SQL statistics of the writer and the read pool connections.
+  /// \return SQL statistics, kept across partition rotations.
+  QueryStats &GetQueryStats() noexcept;
+
  private:
+  friend class HandleRegistry<DataLoader>;
+
   /// \brief DataLoader constructor.
   /// \param[in] path Path.
   DataLoader(std::string &&path);
@@ -126,6 +458,48 @@ class DataLoader {
   /// \return DataLoader object.
   DataLoader &operator=(const DataLoader &data_loader) = delete;
 
+  /// \brief Rotate partition if partitioning is enabled and the limit is reached.
+  /// \return true if partition was rotated.
+  bool CheckPartitionRotation();
+
+  /// \brief Make the passed file the current partition.
+  /// \param[in] partition_name Partition file name.
+  /// \param[in] partition_names Older partitions.
+  /// \return Result of switching.
+  int32_t SwitchPartition(const std::string &partition_name,
+                          const std::vector<std::string> &partition_names);
+
+  /// \brief Get script attaching older partitions and creating their view.
+  /// \return SQL script, empty if there is a single partition.
+  std::string GetPartitionsScript() const;
+
+  /// \brief Insert rows in a single transaction, shared by the batch overloads.
+  /// \param[in] rows_count Number of rows.
+  /// \param[in] insert_row Callable inserting the row by index.
+  /// \param[out] row_results Result of the insert per row, may be nullptr.
+  /// \return Result of the commit or of the last failed row.
+  template <typename RowInserter>
+  int32_t InsertRows(std::size_t rows_count, const RowInserter &insert_row,
+                     std::vector<int32_t> *row_results);
+
+  /// \brief Create table from the schema generated script.
+  /// \param[in] table_name Table name.
+  /// \param[in] struct_template Columns definition.
+  /// \param[in] create_table_sql Create table script.
+  /// \return Result of creation.
+  int32_t CreateSchemaTable(std::string_view table_name, std::string_view struct_template,
+                            const char *create_table_sql);
+
+  /// \brief Get cached statement for the schema generated script.
+  /// \param[in] sql_script Script with static storage, its address is the cache key.
+  /// \return Prepared statement or nullptr if preparation failed.
+  sqlite3_stmt *GetSchemaStatement(const char *sql_script);
+
+  /// \brief Run statement with bound values and reset it.
+  /// \param[in] stmt Prepared statement.
+  /// \return Result of the statement evaluation.
+  int32_t RunSchemaStatement(sqlite3_stmt *stmt);
+
   struct PimplDBHandler;
   std::unique_ptr<PimplDBHandler> pimpl_db_handler_;
 };
@@ -7,31 +7,84 @@
 #include "data_loader_service.h"
 
 extern "C" {
+#include <fcntl.h>
+#include <pthread.h>
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 }
 
+#include <atomic>
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <cstdlib>
 #include <iostream>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 #include "boost/format.hpp"
 
+#include "mpsc_queue/mpsc_queue.h"
+
 namespace crypto_wallet {
 namespace client {
 
 #define DB_SIZE_LIMIT 1000 // MB
 
+namespace {
+  // ingest writer waits this long for the lock held by other connections
+  constexpr int32_t kIngestBusyTimeoutMs = 1000;
+  // attempts left for a failing batch once the pipeline is stopped
+  constexpr uint32_t kIngestStopRetries = 8;
+
+  // errors of the record itself, writing the batch again would not help
+  bool IsRecordError(int32_t res) {
+    auto primary = res & 0xff;
+    return primary == SQLITE_CONSTRAINT || primary == SQLITE_MISMATCH ||
+           primary == SQLITE_TOOBIG || primary == SQLITE_RANGE;
+  }
+}
+
 //std::unique_ptr<DataLoaderService> DataLoaderService::data_loader_;
 
+struct DataLoaderService::IngestPipeline {
+  /// \brief IngestPipeline constructor.
+  /// \param[in] queue_capacity Number of records the queue holds.
+  /// \param[in] batch_size Max number of records written in one transaction.
+  IngestPipeline(std::size_t queue_capacity, std::size_t batch_size)
+      : queue_{queue_capacity}, batch_size_{batch_size ? batch_size : 1} {}
+
+  MpscQueue<std::string> queue_;
+  std::size_t batch_size_{1000};
+  // own connection, a transaction of the writer thread never spans statements
+  // run on database_ by RunSqlScript or the backup
+  sqlite3 *database_{nullptr};
+  sqlite3_stmt *stmt_{nullptr};
+  std::thread writer_{};
+  std::atomic<bool> is_running_{false};
+  // producers which passed is_running_ check but have not pushed yet
+  std::atomic<uint32_t> pushing_count_{0};
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> failed_{0};
+  std::atomic<uint64_t> batches_{0};
+  std::atomic<uint64_t> retried_batches_{0};
+};
+
 DataLoaderService::DataLoaderService(std::string &&path) {
   SetDataBaseName(path);
-  if (SQLITE_OK != sqlite3_open(GetDataBaseName().c_str(), &database_))
+  // writers are tracked for the differential backup
+  if (SQLITE_OK != sqlite3_open_v2(GetDataBaseName().c_str(), &database_,
+                                   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                                   DatabaseBackup::RegisterChangeTrackingVfs()))
     // throw error becasuse connection was not set
     std::cout << "connection was not established" << std::endl;
+  else
+    query_stats_.Attach(database_);
   //if (*database_ != NULL)
     // throw error because database was not created
   //  std::cout << "database was not created" << std::endl;
@@ -39,22 +92,310 @@ DataLoaderService::DataLoaderService(std::string &&path) {
 
 DataLoaderService::DataLoaderService(const std::string &path) {
   SetDataBaseName(path);
-  if (SQLITE_OK != sqlite3_open(GetDataBaseName().c_str(), &database_))
+  // writers are tracked for the differential backup
+  if (SQLITE_OK != sqlite3_open_v2(GetDataBaseName().c_str(), &database_,
+                                   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                                   DatabaseBackup::RegisterChangeTrackingVfs()))
     // throw error becasuse connection was not set
     std::cout << "connection was not established" << std::endl;
+  else
+    query_stats_.Attach(database_);
   //if (*database_ != NULL)
     // throw error because database was not created
   //  std::cout << "database was not created" << std::endl;
 }
 
+DataLoaderService::~DataLoaderService() {
+  StopIngest();
+  database_backup_.reset();
+  sqlite3_close(database_);
+}
+
+void DataLoaderService::CreateDataBaseBackUp(const std::string &backup_path) {
+  if (!database_backup_)
+    database_backup_ = std::make_unique<DatabaseBackup>();
+  // backup thread inherits the mask, termination signals stay with the event loop
+  sigset_t previous_mask{};
+  pthread_sigmask(SIG_SETMASK, nullptr, &previous_mask);
+  BlockTerminationSignals();
+  auto res = database_backup_->Start(database_, backup_path, backup_options_);
+  pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+  if (res != SQLITE_OK)
+    // throw exception here
+    std::cout << "Backup is already running" << std::endl;
+}
+
+void DataLoaderService::CreateDataBaseBackUp(std::string &&backup_path) {
+  CreateDataBaseBackUp(static_cast<const std::string &>(backup_path));
+}
+
+void DataLoaderService::SetBackUpOptions(const DatabaseBackup::Options &backup_options) {
+  backup_options_ = backup_options;
+}
+
+void DataLoaderService::CancelDataBaseBackUp() noexcept {
+  if (database_backup_)
+    database_backup_->Cancel();
+}
+
+int32_t DataLoaderService::WaitDataBaseBackUp() {
+  return database_backup_ ? database_backup_->Wait() : SQLITE_OK;
+}
+
+DatabaseBackup::Progress DataLoaderService::GetBackUpProgress() const noexcept {
+  return database_backup_ ? database_backup_->GetProgress() : DatabaseBackup::Progress{};
+}
+
+/// Signals are blocked before the fork, so every thread started afterwards
+/// inherits the mask.
 void DataLoaderService::RunAsDaemon() {
+  if (ingest_pipeline_ || (database_backup_ && database_backup_->IsRunning())) {
+    // throw exception here
+    std::cout << "Daemon must be started before the ingest pipeline and backup" << std::endl;
+    return;
+  }
+
+  BlockTerminationSignals();
   Daemonize();
+  if (BindConnection() != 0)
+    return;
+  std::thread connection_thread{[this]() {
+    auto res = unix_connect_.Run();
+    if (res != 0)
+      std::cout << "Error occured while serving connection " << std::strerror(res) << std::endl;
+  }};
+  RunEventLoop();
+  StopConnection();
+  connection_thread.join();
+  StopIngest();
+}
 
-  while (true)
-    sleep(20);
+void DataLoaderService::BlockTerminationSignals() noexcept {
+  sigset_t signals{};
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGTERM);
+  sigaddset(&signals, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+}
+
+void DataLoaderService::SetMaintenanceOptions(const MaintenanceOptions &maintenance_options) {
+  maintenance_options_ = maintenance_options;
+}
+
+DataLoaderService::MaintenanceMetrics DataLoaderService::GetMaintenanceMetrics() const noexcept {
+  MaintenanceMetrics metrics{};
+  metrics.checkpoints = checkpoints_.load(std::memory_order_relaxed);
+  metrics.truncate_checkpoints = truncate_checkpoints_.load(std::memory_order_relaxed);
+  metrics.vacuums = vacuums_.load(std::memory_order_relaxed);
+  metrics.optimizations = optimizations_.load(std::memory_order_relaxed);
+  metrics.size_checks = size_checks_.load(std::memory_order_relaxed);
+  metrics.deferred_jobs = deferred_jobs_.load(std::memory_order_relaxed);
+  metrics.failed_jobs = failed_jobs_.load(std::memory_order_relaxed);
+  metrics.database_size = database_size_.load(std::memory_order_relaxed);
+  metrics.is_size_limit_reached = is_size_limit_reached_.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+std::size_t DataLoaderService::GetMemoryUsage() const noexcept {
+  std::size_t memory_usage{0};
+  for (auto op : {SQLITE_DBSTATUS_CACHE_USED, SQLITE_DBSTATUS_SCHEMA_USED,
+                  SQLITE_DBSTATUS_STMT_USED}) {
+    int current{0};
+    int highwater{0};
+    if (database_ && sqlite3_db_status(database_, op, &current, &highwater, 0) == SQLITE_OK)
+      memory_usage += static_cast<std::size_t>(current);
+  }
+  return memory_usage;
+}
+
+/// Maintenance connection has no busy timeout, so jobs never queue up behind the
+/// ingest writer; the loop thread sleeps in epoll_wait in between.
+int32_t DataLoaderService::RunEventLoop() {
+  auto res = event_loop_.Open();
+  if (res != 0)
+    return res;
+
+  res = sqlite3_open_v2(db_name_.c_str(), &maintenance_database_,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_URI,
+                        DatabaseBackup::RegisterChangeTrackingVfs());
+  if (res != SQLITE_OK) {
+    // throw error becasuse connection was not set
+    std::cout << "maintenance connection was not established: "
+              << sqlite3_errmsg(maintenance_database_) << std::endl;
+    sqlite3_close(maintenance_database_);
+    maintenance_database_ = nullptr;
+    return res;
+  }
+
+  const auto &options = maintenance_options_;
+  for (auto signal_number : {SIGTERM, SIGINT})
+    if (res == 0)
+      res = event_loop_.AddSignal(signal_number, [this]() { Shutdown(); });
+  std::pair<std::chrono::milliseconds, EventLoop::Handler> timers[] = {
+    {stats_report_interval_, [this]() { WriteStatsReport(); }},
+    {options.checkpoint_interval,
+     [this]() { RunCheckpoint(SQLITE_CHECKPOINT_PASSIVE, checkpoints_); }},
+    {options.truncate_checkpoint_interval,
+     [this]() { RunCheckpoint(SQLITE_CHECKPOINT_TRUNCATE, truncate_checkpoints_); }},
+    {options.incremental_vacuum_interval, [this]() { RunIncrementalVacuum(); }},
+    {options.optimize_interval,
+     [this]() { RunMaintenanceJob("PRAGMA optimize;", optimizations_); }},
+    {options.size_check_interval, [this]() { CheckDataBaseSize(); }}
+  };
+  for (auto &timer : timers)
+    if (res == 0 && timer.first.count() > 0)
+      res = event_loop_.AddTimer(timer.first, std::move(timer.second));
+
+  if (res == 0)
+    res = event_loop_.Run();
+  else
+    std::cout << "Event loop setup results in error: " << std::strerror(res) << std::endl;
+  sqlite3_close(maintenance_database_);
+  maintenance_database_ = nullptr;
+  return res;
+}
+
+void DataLoaderService::StopEventLoop() noexcept {
+  event_loop_.Stop();
+}
+
+void DataLoaderService::RunMaintenanceJob(const char *sql_script,
+                                          std::atomic<uint64_t> &counter) {
+  char *errMsg{nullptr};
+  auto res = sqlite3_exec(maintenance_database_, sql_script, NULL, 0, &errMsg);
+  if (res == SQLITE_OK) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+  } else if (res == SQLITE_BUSY || res == SQLITE_LOCKED) {
+    deferred_jobs_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    // throw exception here
+    std::cout << "Maintenance job " << sql_script << " results in error: "
+              << (errMsg ? errMsg : "") << std::endl;
+    failed_jobs_.fetch_add(1, std::memory_order_relaxed);
+  }
+  sqlite3_free(errMsg);
+}
+
+void DataLoaderService::RunCheckpoint(int32_t mode, std::atomic<uint64_t> &counter) {
+  int32_t log_frames{0};
+  int32_t checkpointed_frames{0};
+  auto res = sqlite3_wal_checkpoint_v2(maintenance_database_, nullptr, mode, &log_frames,
+                                       &checkpointed_frames);
+  // rollback journal database has no WAL, nothing to count
+  if (res == SQLITE_OK && log_frames < 0)
+    return;
+  if (res == SQLITE_OK)
+    counter.fetch_add(1, std::memory_order_relaxed);
+  else if (res == SQLITE_BUSY || res == SQLITE_LOCKED)
+    deferred_jobs_.fetch_add(1, std::memory_order_relaxed);
+  else
+    failed_jobs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Freelist is checked first, so the write lock is taken only when there are
+/// pages to give back (auto_vacuum=INCREMENTAL databases only).
+void DataLoaderService::RunIncrementalVacuum() {
+  int64_t freelist_count{0};
+  sqlite3_stmt *stmt{nullptr};
+  if (sqlite3_prepare_v2(maintenance_database_, "PRAGMA freelist_count;", -1, &stmt,
+                         nullptr) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW)
+    freelist_count = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  if (freelist_count == 0)
+    return;
+
+  auto sql_script = "PRAGMA incremental_vacuum(" +
+                    std::to_string(maintenance_options_.incremental_vacuum_pages) + ");";
+  RunMaintenanceJob(sql_script.c_str(), vacuums_);
+}
+
+void DataLoaderService::CheckDataBaseSize() {
+  auto size = GetDataBaseSize(maintenance_database_);
+  database_size_.store(size, std::memory_order_relaxed);
+  size_checks_.fetch_add(1, std::memory_order_relaxed);
+  bool is_reached = DB_SIZE_LIMIT <= size;
+  if (is_reached && !is_size_limit_reached_.load(std::memory_order_relaxed))
+    // throw exception here
+    std::cout << "Database size limit " << DB_SIZE_LIMIT << " MB is reached" << std::endl;
+  is_size_limit_reached_.store(is_reached, std::memory_order_relaxed);
+}
+
+/// Records already queued are written by the ingest writer before the WAL is
+/// truncated, the final checkpoint may wait for readers up to a second.
+void DataLoaderService::Shutdown() {
+  StopConnection();
+  if (ingest_pipeline_) {
+    auto &pipeline = *ingest_pipeline_;
+    auto target = pipeline.enqueued_.load(std::memory_order_acquire);
+    auto deadline = std::chrono::steady_clock::now() + kShutdownDrainTimeout;
+    uint64_t done{0};
+    while ((done = pipeline.written_.load(std::memory_order_acquire) +
+                   pipeline.failed_.load(std::memory_order_acquire)) < target &&
+           std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    if (done < target)
+      // throw exception here
+      std::cout << "Shutdown left " << target - done << " queued records unwritten"
+                << std::endl;
+  }
+
+  sqlite3_busy_timeout(maintenance_database_, 1000);
+  RunCheckpoint(SQLITE_CHECKPOINT_TRUNCATE, truncate_checkpoints_);
+  WriteStatsReport();
+  event_loop_.Stop();
+}
+
+void DataLoaderService::SetStatsReportPath(const std::string &stats_report_path) {
+  stats_report_path_ = stats_report_path;
+}
+
+void DataLoaderService::SetStatsReportInterval(std::chrono::seconds stats_report_interval)
+    noexcept {
+  stats_report_interval_ = std::max(stats_report_interval, std::chrono::seconds{1});
+}
+
+int32_t DataLoaderService::WriteStatsReport() const {
+  return stats_report_path_.empty() ? 0 : query_stats_.WriteReport(stats_report_path_);
 }
 
 void DataLoaderService::SetAndProcessConnection() {
+  if (BindConnection() != 0)
+    return;
+
+  auto res = unix_connect_.Run();
+  if (res != 0)
+    std::cout << "Error occured while serving connection " << std::strerror(res) << std::endl;
+}
+
+int32_t DataLoaderService::BindConnection() {
+  if (!ingest_pipeline_) {
+    auto res = StartIngest();
+    if (res != SQLITE_OK)
+      return res;
+  }
+
+  auto res = unix_connect_.Bind(socket_path_);
+  if (res != 0) {
+    // throw exception here
+    std::cout << "Error occured while binding socket " << std::strerror(res) << std::endl;
+    return res;
+  }
+
+  // record view points into the receive buffer, queue takes its own copy; while
+  // the queue is full the client is not read and socket buffers push back on it
+  unix_connect_.SetRecordHandler([this](std::string_view record) {
+    return QueueRecord(record);
+  });
+  return 0;
+}
+
+void DataLoaderService::StopConnection() noexcept {
+  unix_connect_.Stop();
+}
+
+void DataLoaderService::SetSocketPath(const std::string &socket_path) {
+  socket_path_ = socket_path;
 }
 
 void DataLoaderService::SetData(const std::string &data) {
@@ -91,8 +432,204 @@ void DataLoaderService::SetSqlScript(const std::string &sql_scrpt) {
   sql_script_ = boost::str(boost::format{sql_scrpt} % db_table_name_);
 }
 
+int32_t DataLoaderService::StartIngest(std::size_t queue_capacity, std::size_t batch_size) {
+  if (ingest_pipeline_)
+    return SQLITE_MISUSE;
+
+  auto ingest_pipeline = std::make_unique<IngestPipeline>(queue_capacity, batch_size);
+  // writers are tracked for the differential backup
+  auto res = sqlite3_open_v2(GetDataBaseName().c_str(), &ingest_pipeline->database_,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                             DatabaseBackup::RegisterChangeTrackingVfs());
+  if (res == SQLITE_OK)
+    res = sqlite3_prepare_v3(ingest_pipeline->database_, GetSqlScript().c_str(), -1,
+                             SQLITE_PREPARE_PERSISTENT, &ingest_pipeline->stmt_, nullptr);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Ingest statement preparation results in error: "
+              << sqlite3_errmsg(ingest_pipeline->database_) << std::endl;
+    sqlite3_finalize(ingest_pipeline->stmt_);
+    sqlite3_close(ingest_pipeline->database_);
+    return res;
+  }
+
+  query_stats_.AttachReader(ingest_pipeline->database_);
+  sqlite3_busy_timeout(ingest_pipeline->database_, kIngestBusyTimeoutMs);
+  // scripts run on the main connection wait for the batch being written
+  sqlite3_busy_timeout(database_, kIngestBusyTimeoutMs);
+  ingest_pipeline_ = std::move(ingest_pipeline);
+  ingest_pipeline_->is_running_.store(true, std::memory_order_release);
+  ingest_pipeline_->writer_ = std::thread{&DataLoaderService::RunIngestWriter, this};
+  return SQLITE_OK;
+}
+
+void DataLoaderService::StopIngest() {
+  if (!ingest_pipeline_)
+    return;
+
+  ingest_pipeline_->is_running_.store(false, std::memory_order_release);
+  if (ingest_pipeline_->writer_.joinable())
+    ingest_pipeline_->writer_.join();
+  sqlite3_finalize(ingest_pipeline_->stmt_);
+  sqlite3_close(ingest_pipeline_->database_);
+  ingest_pipeline_.reset();
+}
+
+bool DataLoaderService::TryPushData(std::string &&data) {
+  if (!ingest_pipeline_)
+    return false;
+
+  auto &pipeline = *ingest_pipeline_;
+  pipeline.pushing_count_.fetch_add(1, std::memory_order_acq_rel);
+  bool res = pipeline.is_running_.load(std::memory_order_acquire) &&
+             pipeline.queue_.TryPush(std::move(data));
+  pipeline.pushing_count_.fetch_sub(1, std::memory_order_acq_rel);
+  (res ? pipeline.enqueued_ : pipeline.rejected_).fetch_add(1, std::memory_order_relaxed);
+  return res;
+}
+
+/// Backpressure: producer spins, then yields, until the writer frees a slot.
+bool DataLoaderService::PushData(std::string &&data, std::chrono::microseconds timeout) {
+  if (!ingest_pipeline_)
+    return false;
+
+  auto &pipeline = *ingest_pipeline_;
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  pipeline.pushing_count_.fetch_add(1, std::memory_order_acq_rel);
+  bool res{false};
+  for (uint32_t attempt = 0; pipeline.is_running_.load(std::memory_order_acquire); ++attempt) {
+    if ((res = pipeline.queue_.TryPush(std::move(data))))
+      break;
+    if (std::chrono::steady_clock::now() >= deadline)
+      break;
+    if (attempt >= 64)
+      std::this_thread::yield();
+  }
+  pipeline.pushing_count_.fetch_sub(1, std::memory_order_acq_rel);
+  (res ? pipeline.enqueued_ : pipeline.rejected_).fetch_add(1, std::memory_order_relaxed);
+  return res;
+}
+
+/// Record not queued stays in the client buffer and is offered again, so it is
+/// not counted as rejected.
+bool DataLoaderService::QueueRecord(std::string_view record) {
+  auto &pipeline = *ingest_pipeline_;
+  pipeline.pushing_count_.fetch_add(1, std::memory_order_acq_rel);
+  bool res = pipeline.is_running_.load(std::memory_order_acquire) &&
+             pipeline.queue_.TryPush(std::string{record});
+  pipeline.pushing_count_.fetch_sub(1, std::memory_order_acq_rel);
+  if (res)
+    pipeline.enqueued_.fetch_add(1, std::memory_order_relaxed);
+  return res;
+}
+
+DataLoaderService::IngestMetrics DataLoaderService::GetIngestMetrics() const noexcept {
+  IngestMetrics metrics{};
+  if (ingest_pipeline_) {
+    metrics.enqueued = ingest_pipeline_->enqueued_.load(std::memory_order_relaxed);
+    metrics.rejected = ingest_pipeline_->rejected_.load(std::memory_order_relaxed);
+    metrics.written = ingest_pipeline_->written_.load(std::memory_order_relaxed);
+    metrics.failed = ingest_pipeline_->failed_.load(std::memory_order_relaxed);
+    metrics.batches = ingest_pipeline_->batches_.load(std::memory_order_relaxed);
+    metrics.retried_batches =
+        ingest_pipeline_->retried_batches_.load(std::memory_order_relaxed);
+  }
+  return metrics;
+}
+
+/// Records available right away are grouped into one transaction, the writer
+/// backs off while the queue is empty. Batch which fails to commit is written
+/// again after a pause until it succeeds, once the pipeline is stopped it gets
+/// a few more attempts before its records are counted as failed.
+void DataLoaderService::RunIngestWriter() {
+  // termination signals are left to the event loop thread
+  BlockTerminationSignals();
+
+  auto &pipeline = *ingest_pipeline_;
+  std::string record;
+  std::vector<std::string> batch;
+  uint32_t idle_rounds{0};
+  while (true) {
+    if (!pipeline.queue_.TryPop(record)) {
+      bool is_stopped = !pipeline.is_running_.load(std::memory_order_acquire) &&
+                        pipeline.pushing_count_.load(std::memory_order_acquire) == 0;
+      if (is_stopped && !pipeline.queue_.TryPop(record))
+        break;
+      if (!is_stopped) {
+        idle_rounds = std::min<uint32_t>(idle_rounds + 1, 10);
+        std::this_thread::sleep_for(std::chrono::microseconds{1 << idle_rounds});
+        continue;
+      }
+    }
+    idle_rounds = 0;
+
+    batch.clear();
+    do
+      batch.push_back(std::move(record));
+    while (batch.size() < pipeline.batch_size_ && pipeline.queue_.TryPop(record));
+
+    for (uint32_t attempt = 1; ; ++attempt) {
+      uint64_t batch_failed{0};
+      if (WriteIngestBatch(batch, batch_failed) == SQLITE_OK) {
+        pipeline.written_.fetch_add(batch.size() - batch_failed, std::memory_order_relaxed);
+        pipeline.failed_.fetch_add(batch_failed, std::memory_order_relaxed);
+        break;
+      }
+      if (!pipeline.is_running_.load(std::memory_order_acquire) &&
+          attempt >= kIngestStopRetries) {
+        pipeline.failed_.fetch_add(batch.size(), std::memory_order_relaxed);
+        break;
+      }
+      pipeline.retried_batches_.fetch_add(1, std::memory_order_relaxed);
+      std::this_thread::sleep_for(std::chrono::milliseconds{1 << std::min<uint32_t>(attempt, 10)});
+    }
+    pipeline.batches_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/// Records rejected by constraints are skipped, any other error rolls the whole
+/// batch back so it can be written again.
+int32_t DataLoaderService::WriteIngestBatch(const std::vector<std::string> &batch,
+                                            uint64_t &failed_count) {
+  failed_count = 0;
+  auto database = ingest_pipeline_->database_;
+  auto res = sqlite3_exec(database, "BEGIN IMMEDIATE;", NULL, 0, NULL);
+  auto stmt = ingest_pipeline_->stmt_;
+  for (std::size_t i = 0; res == SQLITE_OK && i < batch.size(); ++i) {
+    std::string_view fields{batch[i]};
+    int32_t idx{1};
+    while (true) {
+      auto pos = fields.find(kFieldSeparator);
+      auto field = fields.substr(0, pos);
+      sqlite3_bind_text(stmt, idx++, field.data(), static_cast<int>(field.size()),
+                        SQLITE_STATIC);
+      if (pos == std::string_view::npos)
+        break;
+      fields.remove_prefix(pos + 1);
+    }
+
+    res = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    if (res == SQLITE_DONE || IsRecordError(res)) {
+      failed_count += (res != SQLITE_DONE);
+      res = SQLITE_OK;
+    }
+  }
+  if (res == SQLITE_OK)
+    res = sqlite3_exec(database, "COMMIT;", NULL, 0, NULL);
+
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Ingest batch results in error: " << sqlite3_errmsg(database) << std::endl;
+    if (!sqlite3_get_autocommit(database))
+      sqlite3_exec(database, "ROLLBACK;", NULL, 0, NULL);
+  }
+  return res;
+}
+
 bool DataLoaderService::IsDataBaseSizeLimitReached() {
-  return DB_SIZE_LIMIT <= GetDataBaseSize();
+  return DB_SIZE_LIMIT <= GetDataBaseSize(database_);
 }
 
 void DataLoaderService::Daemonize() const noexcept {
@@ -123,18 +660,37 @@ void DataLoaderService::Daemonize() const noexcept {
 
   chdir("/");
 
-  for (auto i = sysconf(_SC_OPEN_MAX); i >= 0; --i)
-    close(i);
+  // database connection opened before keeps its descriptor, a closed standard
+  // descriptor would be reused and written to by std::cout
+  auto null_fd = open("/dev/null", O_RDWR);
+  if (null_fd < 0)
+    exit(EXIT_FAILURE);
+  for (auto fd : {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO})
+    dup2(null_fd, fd);
+  if (null_fd > STDERR_FILENO)
+    close(null_fd);
 }
 
-uint32_t DataLoaderService::GetDataBaseSize() {
+/// page_count * page_size plus the -wal file, file size alone is wrong in WAL
+/// mode and for the in-memory database.
+uint32_t DataLoaderService::GetDataBaseSize(sqlite3 *database) {
+  uint64_t page_count{0};
+  uint64_t page_size{0};
+  sqlite3_stmt *stmt{nullptr};
+  if (sqlite3_prepare_v2(database, "PRAGMA page_count;", -1, &stmt, nullptr) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW)
+    page_count = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  if (sqlite3_prepare_v2(database, "PRAGMA page_size;", -1, &stmt, nullptr) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW)
+    page_size = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+
+  uint64_t size = page_count * page_size;
   struct stat sb{};
-  if (stat(GetDataBaseName().c_str(), &sb) == -1) {
-    // throw exception here
-    std::cout << "Error occured while retrieving database size " 
-              << std::strerror(errno) << std::endl;
-  }
-  return (sb.st_size / 1000) / 1000;
+  if (stat((GetDataBaseName() + "-wal").c_str(), &sb) == 0)
+    size += sb.st_size;
+  return (size / 1000) / 1000;
 }
 
 } // namespace client
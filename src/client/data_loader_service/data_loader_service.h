@@ -11,11 +11,19 @@ extern "C" {
 #include <sqlite3.h>
 }
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
-//#include "socket_connection/unix_connection.h"
+#include "database_backup/database_backup.h"
+#include "event_loop/event_loop.h"
+#include "handle_registry/handle_registry.h"
+#include "query_stats/query_stats.h"
+#include "socket_connection/unix_connection.h"
 
 /// \namespace crypto_wallet.
 /// \brief Project namespace.
@@ -37,45 +45,226 @@ class DataLoaderService {
   //DataLoaderService &operator=(const DataLoaderService &data_loader_service) =
 //delete;
 
+  /// \brief Separator of the record fields.
+  static constexpr char kFieldSeparator = '\x1f';
+
   /// \brief DataLoaderService destructor.
-  ~DataLoaderService() {
-    sqlite3_close(database_);
-  } 
+  ~DataLoaderService();
 
-  /// \brief Get instance of class DataLoaderService..
+  /// \brief Get instance of class DataLoaderService of the path, kept open till exit.
+  /// \details Instance is pinned in the registry: it is never evicted and the budgets
+  /// \details do not close it, GetRegistry().Acquire gives handles closed while idle.
   /// \param[in] path Path to the DB.
   /// \return Instance of class DataLoaderService.
   inline static DataLoaderService &GetDataLoaderServiceInstance(std::string &&path) 
   {
-    static DataLoaderService data_loader{path};
-    return data_loader;
+    return GetRegistry().AcquirePinned(path);
   }
 
-  /// \brief Get instance of class DataLoaderService.
+  /// \brief Get instance of class DataLoaderService of the path, kept open till exit.
+  /// \details Instance is pinned in the registry: it is never evicted and the budgets
+  /// \details do not close it, GetRegistry().Acquire gives handles closed while idle.
   /// \param[in] path Path to the DB.
   /// \return Instance of class DataLoaderService.
   inline static DataLoaderService &GetDataLoaderServiceInstance(const std::string &path) 
   {
-    static DataLoaderService data_loader{path};
-    return data_loader;
+    return GetRegistry().AcquirePinned(path);
+  }
+
+  /// \brief Get registry of the process DataLoaderService instances.
+  /// \return Registry.
+  inline static HandleRegistry<DataLoaderService> &GetRegistry() {
+    static HandleRegistry<DataLoaderService> registry{
+        HandleRegistry<DataLoaderService>::Options{}};
+    return registry;
   }
 
+  /// \brief Get memory held by the database connection page cache, schema and
+  /// \brief statements.
+  /// \return Memory usage in bytes.
+  std::size_t GetMemoryUsage() const noexcept;
+
   /// \brief Creates current database's backup.
+  /// \details Backup runs on the background thread with the options set by
+  /// \details SetBackUpOptions, ingest keeps writing in between backup steps.
   /// \param[in] backup_pat Path to put backuped database.
   void CreateDataBaseBackUp(const std::string &backup_path);
   void CreateDataBaseBackUp(std::string &&backup_path);
 
+  /// \brief Set backup options.
+  /// \param[in] backup_options Backup options.
+  void SetBackUpOptions(const DatabaseBackup::Options &backup_options);
+
+  /// \brief Cancel running backup.
+  void CancelDataBaseBackUp() noexcept;
+
+  /// \brief Wait for the running backup to finish.
+  /// \return Result of the backup, SQLITE_OK if no backup was started.
+  int32_t WaitDataBaseBackUp();
+
+  /// \brief Get progress of the running or last backup.
+  /// \return Progress snapshot.
+  DatabaseBackup::Progress GetBackUpProgress() const noexcept;
+
   /// \brief Run service as a daemon.
+  /// \details Blocks SIGTERM and SIGINT, daemonizes, then serves the interprocess
+  /// \details connection on its own thread and runs the event loop until one of the
+  /// \details signals. Threads do not survive fork, so it refuses to start once the
+  /// \details ingest pipeline or a backup is running.
   void RunAsDaemon();
 
+  /// \brief Block SIGTERM and SIGINT in the calling thread.
+  /// \details Call from main before any thread is started, threads inherit the mask
+  /// \details and the signals reach only the event loop.
+  static void BlockTerminationSignals() noexcept;
+
+  /// \struct MaintenanceOptions data_loader_service.h.
+  /// \brief Periods of the background maintenance jobs.
+  /// \details Jobs run on their own connection without busy timeout, a job finding
+  /// \details the database locked is deferred to its next period instead of waiting.
+  struct MaintenanceOptions {
+    // copies WAL frames without waiting for readers or the writer
+    std::chrono::milliseconds checkpoint_interval{1000};
+    // resets the WAL file, needs the database free of readers and the writer
+    std::chrono::milliseconds truncate_checkpoint_interval{60000};
+    std::chrono::milliseconds incremental_vacuum_interval{30000};
+    // pages freed per vacuum run, bounds the time the write lock is held
+    uint32_t incremental_vacuum_pages{256};
+    // PRAGMA optimize, runs ANALYZE on tables whose statistics are stale
+    std::chrono::milliseconds optimize_interval{3600000};
+    std::chrono::milliseconds size_check_interval{10000};
+  };
+
+  /// \struct MaintenanceMetrics data_loader_service.h.
+  /// \brief Maintenance counters.
+  struct MaintenanceMetrics {
+    uint64_t checkpoints{0};
+    uint64_t truncate_checkpoints{0};
+    uint64_t vacuums{0};
+    uint64_t optimizations{0};
+    uint64_t size_checks{0};
+    uint64_t deferred_jobs{0};
+    uint64_t failed_jobs{0};
+    uint32_t database_size{0};
+    bool is_size_limit_reached{false};
+  };
+
+  /// \brief Set periods of the maintenance jobs, taken by the next RunEventLoop.
+  /// \param[in] maintenance_options Maintenance options.
+  void SetMaintenanceOptions(const MaintenanceOptions &maintenance_options);
+
+  /// \brief Get maintenance counters.
+  /// \return Counters snapshot.
+  MaintenanceMetrics GetMaintenanceMetrics() const noexcept;
+
+  /// \brief Run maintenance jobs and stats reports in the calling thread.
+  /// \details SIGTERM and SIGINT stop the interprocess connection, wait until queued
+  /// \details records are written, truncate the WAL and write the last stats report.
+  /// \details Both signals are blocked in the calling thread, threads started before
+  /// \details have to block them too, see BlockTerminationSignals. Queued records
+  /// \details are waited for at most kShutdownDrainTimeout.
+  /// \return 0 on success, errno or SQLite result if the loop was not started.
+  int32_t RunEventLoop();
+
+  /// \brief Stop the event loop without the final flush, safe to call from any thread.
+  void StopEventLoop() noexcept;
+
+  /// \brief Set path of the stats report file.
+  /// \param[in] stats_report_path File path, absolute since daemon changes directory.
+  void SetStatsReportPath(const std::string &stats_report_path);
+
+  /// \brief Get path of the stats report file.
+  /// \return File path.
+  std::string GetStatsReportPath() const noexcept {
+    return stats_report_path_;
+  }
+
+  /// \brief Set period of the stats report rewriting.
+  /// \param[in] stats_report_interval Period.
+  void SetStatsReportInterval(std::chrono::seconds stats_report_interval) noexcept;
+
+  /// \brief Write SQL statistics of the connection into the stats report file.
+  /// \return errno value, 0 on success.
+  int32_t WriteStatsReport() const;
+
+  /// \brief Get SQL statistics of the connection.
+  /// \return SQL statistics.
+  QueryStats &GetQueryStats() noexcept {
+    return query_stats_;
+  }
+
   /// \brief Set and look after the interprocess connection.
+  /// \details Serves clients on the Unix socket until StopConnection is called,
+  /// \details received records are queued into the ingest pipeline (started with
+  /// \details defaults if it is not running yet).
   void SetAndProcessConnection();
 
+  /// \brief Max time Shutdown waits for the queued records to be written.
+  static constexpr std::chrono::seconds kShutdownDrainTimeout{10};
+
+  /// \brief Stop serving the interprocess connection, safe to call from any thread.
+  void StopConnection() noexcept;
+
+  /// \brief Set Unix socket path.
+  /// \param[in] socket_path Socket path.
+  void SetSocketPath(const std::string &socket_path);
+
+  /// \brief Get Unix socket path.
+  /// \return Socket path.
+  std::string GetSocketPath() const noexcept {
+    return socket_path_;
+  }
+
+  /// \brief Get interprocess connection counters.
+  /// \return Counters snapshot.
+  socket_communication::UnixConnection::Metrics GetConnectionMetrics() const noexcept {
+    return unix_connect_.GetMetrics();
+  }
+
   /// \brief Set data.
   /// \param[in] data Data.
   void SetData(const std::string &data);
   void SetData(std::string &&data);
 
+  /// \struct IngestMetrics data_loader_service.h.
+  /// \brief Ingest pipeline counters.
+  struct IngestMetrics {
+    uint64_t enqueued{0};
+    uint64_t rejected{0};
+    uint64_t written{0};
+    uint64_t failed{0};
+    uint64_t batches{0};
+    uint64_t retried_batches{0};
+  };
+
+  /// \brief Start ingest pipeline writing queued records with the SQL script.
+  /// \details Fields of the record separated with kFieldSeparator are bound to
+  /// \details the parameters of the SQL script in order. Records are written
+  /// \details through a connection of the pipeline, closed by StopIngest.
+  /// \param[in] queue_capacity Number of records the queue holds.
+  /// \param[in] batch_size Max number of records written in one transaction.
+  /// \return Result of opening the connection and preparing the SQL script.
+  int32_t StartIngest(std::size_t queue_capacity = 65536, std::size_t batch_size = 1000);
+
+  /// \brief Stop ingest pipeline, queued records are written before it returns.
+  void StopIngest();
+
+  /// \brief Queue record for writing without blocking.
+  /// \param[in] data Record, left untouched if it was not queued.
+  /// \return false if the queue is full or pipeline is not running.
+  bool TryPushData(std::string &&data);
+
+  /// \brief Queue record for writing, wait while the queue is full.
+  /// \param[in] data Record, left untouched if it was not queued.
+  /// \param[in] timeout Max time to wait for the free slot.
+  /// \return false if timeout expired or pipeline is not running.
+  bool PushData(std::string &&data,
+                std::chrono::microseconds timeout = std::chrono::microseconds{1000});
+
+  /// \brief Get ingest pipeline counters.
+  /// \return Counters snapshot.
+  IngestMetrics GetIngestMetrics() const noexcept;
+
   /// \brief Get data.
   /// \return Data.
   inline std::string GetData() const noexcept {
@@ -132,6 +321,8 @@ class DataLoaderService {
   ///void CreateTable(std::string &&table_name);
 
  private:
+  friend class HandleRegistry<DataLoaderService>;
+
   /// \brief DataLoaderService constructor.
   /// \param[in] path Path.
   DataLoaderService(std::string &&path);
@@ -147,14 +338,75 @@ class DataLoaderService {
   DataLoaderService &operator=(DataLoaderService &&data_loader_service) =
 default;
 
-  /// \brief Daemonize process.
+  /// \brief Daemonize process, standard descriptors are redirected to /dev/null.
   void Daemonize() const noexcept;
+
+  /// \brief Queue record received from the interprocess connection.
+  /// \param[in] record Record.
+  /// \return false if the queue is full or pipeline is not running.
+  bool QueueRecord(std::string_view record);
+
+  /// \brief Start ingest pipeline and bind the interprocess connection.
+  /// \return 0 on success, otherwise errno or SQLite result.
+  int32_t BindConnection();
   
   /// \brief Evaluate database size.
+  /// \param[in] database Connection to the database.
   /// \return Database size.
-  uint32_t GetDataBaseSize();
+  uint32_t GetDataBaseSize(sqlite3 *database);
+
+  /// \brief Run one maintenance job on the maintenance connection.
+  /// \param[in] sql_script Job script.
+  /// \param[out] counter Counter of the done jobs.
+  void RunMaintenanceJob(const char *sql_script, std::atomic<uint64_t> &counter);
+
+  /// \brief Run WAL checkpoint on the maintenance connection.
+  /// \param[in] mode Checkpoint mode.
+  /// \param[out] counter Counter of the done checkpoints.
+  void RunCheckpoint(int32_t mode, std::atomic<uint64_t> &counter);
+
+  /// \brief Free up to incremental_vacuum_pages pages of the freelist.
+  void RunIncrementalVacuum();
+
+  /// \brief Evaluate database size and report crossing of the size limit.
+  void CheckDataBaseSize();
+
+  /// \brief Write queued records, truncate the WAL and stop the event loop.
+  void Shutdown();
+
+  /// \brief Drain ingest queue into database until pipeline is stopped.
+  void RunIngestWriter();
+
+  /// \brief Write ingest records in one transaction.
+  /// \param[in] batch Records.
+  /// \param[out] failed_count Number of records rejected by the database.
+  /// \return SQLITE_OK if committed, otherwise the batch is rolled back.
+  int32_t WriteIngestBatch(const std::vector<std::string> &batch, uint64_t &failed_count);
+
+  struct IngestPipeline;
+  std::unique_ptr<IngestPipeline> ingest_pipeline_;
+  DatabaseBackup::Options backup_options_{};
+  std::unique_ptr<DatabaseBackup> database_backup_;
+
+  QueryStats query_stats_{};
+  std::string stats_report_path_{"/tmp/crypto_wallet_data_loader.stats.json"};
+  std::chrono::seconds stats_report_interval_{20};
+
+  EventLoop event_loop_{};
+  MaintenanceOptions maintenance_options_{};
+  sqlite3 *maintenance_database_{nullptr};
+  std::atomic<uint64_t> checkpoints_{0};
+  std::atomic<uint64_t> truncate_checkpoints_{0};
+  std::atomic<uint64_t> vacuums_{0};
+  std::atomic<uint64_t> optimizations_{0};
+  std::atomic<uint64_t> size_checks_{0};
+  std::atomic<uint64_t> deferred_jobs_{0};
+  std::atomic<uint64_t> failed_jobs_{0};
+  std::atomic<uint32_t> database_size_{0};
+  std::atomic<bool> is_size_limit_reached_{false};
 
-  //socket_communication::UnixConnection unix_connect_{};
+  socket_communication::UnixConnection unix_connect_{};
+  std::string socket_path_{"/tmp/crypto_wallet_data_loader.sock"};
   std::string data_{};
   std::string db_name_{};
   sqlite3 *database_{nullptr};
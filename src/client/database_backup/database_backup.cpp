@@ -0,0 +1,748 @@
+/// \file database_backup.cpp
+/// \brief Source file containing class DatabaseBackup methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "database_backup.h"
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace crypto_wallet {
+namespace client {
+
+namespace {
+  constexpr char kTrackingVfsName[] = "crypto_wallet_change_tracking";
+  // WAL file header and frame header sizes, frame header starts with the big-endian
+  // page number and the database size, the latter is set on commit frames only
+  constexpr sqlite3_int64 kWalHeaderSize = 32;
+  constexpr int kWalFrameHeaderSize = 24;
+  constexpr int kReaderBusyTimeoutMs = 1000;
+  constexpr std::chrono::milliseconds kRetryPause{1};
+  constexpr char kUndoMagic[8] = {'c', 'w', 'u', 'n', 'd', 'o', '0', '1'};
+
+  uint32_t ReadBigEndian32(const unsigned char *data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+  }
+
+  // FNV-1a over 8 byte words, pages are always multiple of 8 bytes.
+  uint64_t HashPage(const char *data, std::size_t size) {
+    uint64_t hash{14695981039346656037ULL};
+    for (std::size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word{0};
+      std::memcpy(&word, data + i, sizeof(word));
+      hash = (hash ^ word) * 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  std::string QueryText(sqlite3 *database, const char *sql_script) {
+    std::string res;
+    sqlite3_stmt *stmt{nullptr};
+    if (sqlite3_prepare_v2(database, sql_script, -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0))
+      res = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    sqlite3_finalize(stmt);
+    return res;
+  }
+
+  bool ReadFull(int32_t fd, char *data, std::size_t size, off_t offset) {
+    while (size > 0) {
+      auto res = pread(fd, data, size, offset);
+      if (res <= 0)
+        return false;
+      data += res;
+      size -= res;
+      offset += res;
+    }
+    return true;
+  }
+
+  bool WriteFull(int32_t fd, const char *data, std::size_t size, off_t offset) {
+    while (size > 0) {
+      auto res = pwrite(fd, data, size, offset);
+      if (res <= 0)
+        return false;
+      data += res;
+      size -= res;
+      offset += res;
+    }
+    return true;
+  }
+
+  bool SyncDirectory(const std::string &path) {
+    auto slash = path.rfind('/');
+    auto directory = (slash == std::string::npos) ? std::string{"."} : path.substr(0, slash + 1);
+    auto fd = open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+    auto res = fsync(fd);
+    close(fd);
+    return res == 0;
+  }
+
+  // Pages committed to the database by connections opened through the tracking VFS.
+  struct TrackedDatabase {
+    std::mutex mutex;
+    std::unordered_set<uint32_t> committed_pages;
+    // WAL frames of the write transaction in progress
+    std::unordered_set<uint32_t> pending_pages;
+    uint32_t wal_files_count{0};
+    // commit frame is written, the WAL write lock is not released yet
+    bool is_committing{false};
+  };
+
+  std::mutex tracked_databases_mutex;
+  // entries are never erased, pointers to them stay valid
+  std::unordered_map<std::string, TrackedDatabase> tracked_databases;
+
+  TrackedDatabase *FindTrackedDatabase(const std::string &path, bool is_created) {
+    std::lock_guard<std::mutex> lock{tracked_databases_mutex};
+    if (is_created)
+      return &tracked_databases.try_emplace(path).first->second;
+    auto it = tracked_databases.find(path);
+    return (it != tracked_databases.end()) ? &it->second : nullptr;
+  }
+
+  sqlite3_vfs *base_vfs{nullptr};
+  sqlite3_vfs tracking_vfs{};
+
+  // File of the tracking VFS, the file of the default VFS follows it in memory.
+  struct TrackingFile {
+    sqlite3_file base;
+    TrackedDatabase *tracked_database;
+    bool is_wal;
+
+    sqlite3_file *GetBaseFile() noexcept {
+      return reinterpret_cast<sqlite3_file *>(this + 1);
+    }
+  };
+
+  sqlite3_file *GetBaseFile(sqlite3_file *file) {
+    return reinterpret_cast<TrackingFile *>(file)->GetBaseFile();
+  }
+
+  int TrackingClose(sqlite3_file *file) {
+    auto tracking_file = reinterpret_cast<TrackingFile *>(file);
+    auto base_file = tracking_file->GetBaseFile();
+    auto res = base_file->pMethods->xClose(base_file);
+    if (tracking_file->tracked_database && tracking_file->is_wal) {
+      std::lock_guard<std::mutex> lock{tracking_file->tracked_database->mutex};
+      --tracking_file->tracked_database->wal_files_count;
+    }
+    return res;
+  }
+
+  int TrackingRead(sqlite3_file *file, void *buffer, int amount, sqlite3_int64 offset) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xRead(base_file, buffer, amount, offset);
+  }
+
+  /// Rollback journal mode writes whole pages of committing transactions to the
+  /// database file. In WAL mode the database file gets only checkpointed pages,
+  /// pages are taken from WAL frame headers and become committed with the commit frame.
+  int TrackingWrite(sqlite3_file *file, const void *buffer, int amount, sqlite3_int64 offset) {
+    auto tracking_file = reinterpret_cast<TrackingFile *>(file);
+    auto base_file = tracking_file->GetBaseFile();
+    auto res = base_file->pMethods->xWrite(base_file, buffer, amount, offset);
+    auto tracked_database = tracking_file->tracked_database;
+    if (res != SQLITE_OK || !tracked_database)
+      return res;
+
+    std::lock_guard<std::mutex> lock{tracked_database->mutex};
+    if (tracking_file->is_wal) {
+      if (amount != kWalFrameHeaderSize || offset < kWalHeaderSize)
+        return res;
+      auto frame_header = static_cast<const unsigned char *>(buffer);
+      tracked_database->pending_pages.insert(ReadBigEndian32(frame_header));
+      if (ReadBigEndian32(frame_header + 4) != 0) {
+        tracked_database->committed_pages.insert(tracked_database->pending_pages.begin(),
+                                                 tracked_database->pending_pages.end());
+        tracked_database->pending_pages.clear();
+        tracked_database->is_committing = true;
+      }
+    } else if (tracked_database->wal_files_count == 0 && amount > 0 && offset % amount == 0) {
+      tracked_database->committed_pages.insert(static_cast<uint32_t>(offset / amount + 1));
+    }
+    return res;
+  }
+
+  int TrackingTruncate(sqlite3_file *file, sqlite3_int64 size) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xTruncate(base_file, size);
+  }
+
+  int TrackingSync(sqlite3_file *file, int flags) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xSync(base_file, flags);
+  }
+
+  int TrackingFileSize(sqlite3_file *file, sqlite3_int64 *size) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xFileSize(base_file, size);
+  }
+
+  int TrackingLock(sqlite3_file *file, int lock) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xLock(base_file, lock);
+  }
+
+  int TrackingUnlock(sqlite3_file *file, int lock) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xUnlock(base_file, lock);
+  }
+
+  int TrackingCheckReservedLock(sqlite3_file *file, int *is_reserved) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xCheckReservedLock(base_file, is_reserved);
+  }
+
+  int TrackingFileControl(sqlite3_file *file, int op, void *arg) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xFileControl(base_file, op, arg);
+  }
+
+  int TrackingSectorSize(sqlite3_file *file) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xSectorSize(base_file);
+  }
+
+  int TrackingDeviceCharacteristics(sqlite3_file *file) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xDeviceCharacteristics(base_file);
+  }
+
+  int TrackingShmMap(sqlite3_file *file, int region, int region_size, int is_extended,
+                     void volatile **memory) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xShmMap(base_file, region, region_size, is_extended, memory);
+  }
+
+  /// Release of the WAL write lock, slot 0, ends the commit: the new WAL index
+  /// header is visible to readers by then.
+  int TrackingShmLock(sqlite3_file *file, int offset, int count, int flags) {
+    auto tracking_file = reinterpret_cast<TrackingFile *>(file);
+    auto base_file = tracking_file->GetBaseFile();
+    auto res = base_file->pMethods->xShmLock(base_file, offset, count, flags);
+    auto tracked_database = tracking_file->tracked_database;
+    if (res == SQLITE_OK && tracked_database && offset == 0 && (flags & SQLITE_SHM_UNLOCK)) {
+      std::lock_guard<std::mutex> lock{tracked_database->mutex};
+      tracked_database->is_committing = false;
+    }
+    return res;
+  }
+
+  void TrackingShmBarrier(sqlite3_file *file) {
+    auto base_file = GetBaseFile(file);
+    base_file->pMethods->xShmBarrier(base_file);
+  }
+
+  int TrackingShmUnmap(sqlite3_file *file, int is_deleted) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xShmUnmap(base_file, is_deleted);
+  }
+
+  int TrackingFetch(sqlite3_file *file, sqlite3_int64 offset, int amount, void **memory) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xFetch(base_file, offset, amount, memory);
+  }
+
+  int TrackingUnfetch(sqlite3_file *file, sqlite3_int64 offset, void *memory) {
+    auto base_file = GetBaseFile(file);
+    return base_file->pMethods->xUnfetch(base_file, offset, memory);
+  }
+
+  const sqlite3_io_methods kTrackingMethods{
+    3, TrackingClose, TrackingRead, TrackingWrite, TrackingTruncate, TrackingSync,
+    TrackingFileSize, TrackingLock, TrackingUnlock, TrackingCheckReservedLock,
+    TrackingFileControl, TrackingSectorSize, TrackingDeviceCharacteristics, TrackingShmMap,
+    TrackingShmLock, TrackingShmBarrier, TrackingShmUnmap, TrackingFetch, TrackingUnfetch};
+
+  int TrackingOpen(sqlite3_vfs *, const char *name, sqlite3_file *file, int flags,
+                   int *out_flags) {
+    auto tracking_file = reinterpret_cast<TrackingFile *>(file);
+    tracking_file->base.pMethods = nullptr;
+    tracking_file->tracked_database = nullptr;
+    tracking_file->is_wal = (flags & SQLITE_OPEN_WAL) != 0;
+    auto base_file = tracking_file->GetBaseFile();
+    auto res = base_vfs->xOpen(base_vfs, name, base_file, flags, out_flags);
+    // SQLite closes the file whenever methods are set, even if open failed
+    if (!base_file->pMethods)
+      return res;
+    tracking_file->base.pMethods = &kTrackingMethods;
+    if (res != SQLITE_OK || !name || !(flags & (SQLITE_OPEN_MAIN_DB | SQLITE_OPEN_WAL)))
+      return res;
+
+    std::string path{name};
+    if (tracking_file->is_wal)
+      path.resize(path.size() - std::strlen("-wal"));
+    tracking_file->tracked_database = FindTrackedDatabase(path, true);
+    if (tracking_file->is_wal) {
+      std::lock_guard<std::mutex> lock{tracking_file->tracked_database->mutex};
+      ++tracking_file->tracked_database->wal_files_count;
+    }
+    return res;
+  }
+
+  /// Header of the undo file is followed by records of the page offset, the hash
+  /// and the original page; a torn record at the end was not applied to the backup.
+  struct UndoHeader {
+    char magic[sizeof(kUndoMagic)];
+    uint64_t page_size;
+    uint64_t backup_size;
+  };
+
+  std::string GetUndoPath(const std::string &backup_path) {
+    return backup_path + "-undo";
+  }
+
+  /// Backup gets its original pages back and the undo file is removed, a missing or
+  /// torn header means the backup was not overwritten yet.
+  int32_t RollBackBackup(const std::string &backup_path) {
+    auto undo_path = GetUndoPath(backup_path);
+    auto undo_fd = open(undo_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (undo_fd < 0)
+      return (errno == ENOENT) ? SQLITE_OK : SQLITE_CANTOPEN;
+
+    int32_t res{SQLITE_OK};
+    UndoHeader header{};
+    if (ReadFull(undo_fd, reinterpret_cast<char *>(&header), sizeof(header), 0) &&
+        std::memcmp(header.magic, kUndoMagic, sizeof(kUndoMagic)) == 0 && header.page_size > 0) {
+      auto backup_fd = open(backup_path.c_str(), O_RDWR | O_CLOEXEC);
+      std::vector<char> page(header.page_size);
+      off_t offset = sizeof(header);
+      uint64_t record[2]{};
+      while (backup_fd >= 0 &&
+             ReadFull(undo_fd, reinterpret_cast<char *>(record), sizeof(record), offset) &&
+             ReadFull(undo_fd, page.data(), page.size(), offset + sizeof(record)) &&
+             record[1] == (HashPage(page.data(), page.size()) ^ record[0])) {
+        if (!WriteFull(backup_fd, page.data(), page.size(), record[0])) {
+          res = SQLITE_IOERR;
+          break;
+        }
+        offset += sizeof(record) + page.size();
+      }
+      if (backup_fd < 0 || ftruncate(backup_fd, header.backup_size) < 0 || fsync(backup_fd) < 0)
+        res = SQLITE_IOERR;
+      if (backup_fd >= 0)
+        close(backup_fd);
+    }
+    close(undo_fd);
+    // undo file stays for the next attempt if the backup could not be restored
+    if (res == SQLITE_OK && (unlink(undo_path.c_str()) < 0 || !SyncDirectory(undo_path)))
+      res = SQLITE_IOERR;
+    return res;
+  }
+
+  // Undo file of the pass, originals are saved once per page.
+  class UndoJournal {
+   public:
+    UndoJournal(const std::string &backup_path, int32_t backup_fd, uint64_t page_size,
+                off_t backup_size)
+      : path_{GetUndoPath(backup_path)}, backup_fd_{backup_fd}, page_size_{page_size},
+        backup_size_{backup_size}, page_(page_size) {}
+
+    ~UndoJournal() {
+      if (fd_ >= 0)
+        close(fd_);
+    }
+
+    UndoJournal(const UndoJournal &undo_journal) = delete;
+    UndoJournal &operator=(const UndoJournal &undo_journal) = delete;
+
+    /// Originals are durable before the caller overwrites the pages.
+    int32_t Save(const std::vector<uint32_t> &pages) {
+      bool is_saved{false};
+      for (auto page_number : pages) {
+        off_t offset = (page_number - 1) * page_size_;
+        if (offset >= backup_size_ || !saved_pages_.insert(page_number).second)
+          continue;
+        if (fd_ < 0 && Create() != SQLITE_OK)
+          return SQLITE_IOERR;
+        // tail of the last page beyond the backup is cut off on roll back
+        std::fill(page_.begin(), page_.end(), 0);
+        if (pread(backup_fd_, page_.data(), page_.size(), offset) < 0)
+          return SQLITE_IOERR;
+        uint64_t record[2]{static_cast<uint64_t>(offset),
+                           HashPage(page_.data(), page_.size()) ^ static_cast<uint64_t>(offset)};
+        if (!WriteFull(fd_, reinterpret_cast<const char *>(record), sizeof(record), size_) ||
+            !WriteFull(fd_, page_.data(), page_.size(), size_ + sizeof(record)))
+          return SQLITE_IOERR;
+        size_ += sizeof(record) + page_.size();
+        is_saved = true;
+      }
+      return (is_saved && fsync(fd_) < 0) ? SQLITE_IOERR : SQLITE_OK;
+    }
+
+   private:
+    int32_t Create() {
+      fd_ = open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      UndoHeader header{};
+      std::memcpy(header.magic, kUndoMagic, sizeof(kUndoMagic));
+      header.page_size = page_size_;
+      header.backup_size = backup_size_;
+      if (fd_ < 0 || !WriteFull(fd_, reinterpret_cast<const char *>(&header), sizeof(header), 0) ||
+          fsync(fd_) < 0 || !SyncDirectory(path_))
+        return SQLITE_IOERR;
+      size_ = sizeof(header);
+      return SQLITE_OK;
+    }
+
+    std::string path_;
+    int32_t backup_fd_;
+    uint64_t page_size_;
+    off_t backup_size_;
+    std::vector<char> page_;
+    std::unordered_set<uint32_t> saved_pages_{};
+    int32_t fd_{-1};
+    off_t size_{0};
+  };
+}
+
+const char *DatabaseBackup::RegisterChangeTrackingVfs() {
+  static const bool is_registered = []() {
+    base_vfs = sqlite3_vfs_find(nullptr);
+    if (!base_vfs)
+      return false;
+    tracking_vfs = *base_vfs;
+    tracking_vfs.szOsFile = sizeof(TrackingFile) + base_vfs->szOsFile;
+    tracking_vfs.zName = kTrackingVfsName;
+    tracking_vfs.pNext = nullptr;
+    tracking_vfs.xOpen = TrackingOpen;
+    return sqlite3_vfs_register(&tracking_vfs, 0) == SQLITE_OK;
+  }();
+  return is_registered ? kTrackingVfsName : nullptr;
+}
+
+DatabaseBackup::~DatabaseBackup() {
+  Cancel();
+  Wait();
+}
+
+int32_t DatabaseBackup::Start(sqlite3 *database, const std::string &backup_path,
+                              const Options &options) {
+  if (IsRunning())
+    return SQLITE_BUSY;
+  Wait();
+
+  database_ = database;
+  backup_path_ = backup_path;
+  options_ = options;
+  if (options_.pages_per_step <= 0)
+    options_.pages_per_step = -1;
+  is_cancelled_.store(false, std::memory_order_release);
+  total_pages_ = done_pages_ = copied_pages_ = 0;
+  restarts_ = 0;
+  is_running_.store(true, std::memory_order_release);
+  worker_ = std::thread{[this]() {
+    result_ = options_.is_differential ? RunDifferentialBackup() : RunFullBackup();
+    is_running_.store(false, std::memory_order_release);
+  }};
+  return SQLITE_OK;
+}
+
+void DatabaseBackup::Cancel() noexcept {
+  is_cancelled_.store(true, std::memory_order_release);
+}
+
+int32_t DatabaseBackup::Wait() {
+  if (worker_.joinable())
+    worker_.join();
+  return result_;
+}
+
+DatabaseBackup::Progress DatabaseBackup::GetProgress() const noexcept {
+  Progress progress{};
+  progress.total_pages = total_pages_.load(std::memory_order_relaxed);
+  progress.done_pages = done_pages_.load(std::memory_order_relaxed);
+  progress.copied_pages = copied_pages_.load(std::memory_order_relaxed);
+  progress.restarts = restarts_.load(std::memory_order_relaxed);
+  return progress;
+}
+
+/// Source is locked only inside sqlite3_backup_step, writers proceed while
+/// the thread pauses between steps.
+int32_t DatabaseBackup::RunFullBackup() {
+  // destination rolls back to the previous backup if this one fails too
+  auto res = RollBackBackup(backup_path_);
+  if (res != SQLITE_OK)
+    return res;
+
+  sqlite3 *backup_db{nullptr};
+  res = sqlite3_open_v2(backup_path_.c_str(), &backup_db,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                             nullptr);
+  if (res != SQLITE_OK) {
+    sqlite3_close(backup_db);
+    return res;
+  }
+
+  auto backup = sqlite3_backup_init(backup_db, "main", database_, "main");
+  if (!backup) {
+    res = sqlite3_errcode(backup_db);
+    // throw exception here
+    std::cout << "Backup initialization results in error: " << sqlite3_errmsg(backup_db)
+              << std::endl;
+    sqlite3_close(backup_db);
+    return res;
+  }
+
+  while (true) {
+    res = sqlite3_backup_step(backup, options_.pages_per_step);
+    total_pages_.store(sqlite3_backup_pagecount(backup), std::memory_order_relaxed);
+    done_pages_.store(sqlite3_backup_pagecount(backup) - sqlite3_backup_remaining(backup),
+                      std::memory_order_relaxed);
+    copied_pages_.store(done_pages_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    ReportProgress();
+
+    if (res == SQLITE_DONE) {
+      res = SQLITE_OK;
+      break;
+    }
+    if (res != SQLITE_OK && res != SQLITE_BUSY && res != SQLITE_LOCKED)
+      break;
+    if (is_cancelled_.load(std::memory_order_acquire)) {
+      res = SQLITE_INTERRUPT;
+      break;
+    }
+    std::this_thread::sleep_for(options_.step_pause);
+  }
+
+  // unfinished backup rolls the destination back
+  sqlite3_backup_finish(backup);
+  sqlite3_close(backup_db);
+  if (backup_path_ == synced_path_)
+    synced_path_.clear();
+  return res;
+}
+
+/// Every step opens a read transaction on the source, takes the pages committed
+/// since the previous step and copies the next of them into the backup; a page
+/// committed again after it was copied is copied again. The pass ends with the
+/// step which copies all pages left, the backup then holds the snapshot of that
+/// step. In WAL mode the step proceeds only if no commit is in flight and a passive
+/// checkpoint leaves the WAL fully backfilled, the database file holds the snapshot
+/// of the step then and checkpoints cannot go beyond it until the step ends.
+int32_t DatabaseBackup::RunDifferentialBackup() {
+  const char *source_path = sqlite3_db_filename(database_, "main");
+  auto tracked_database = (source_path && *source_path) ?
+                          FindTrackedDatabase(source_path, false) : nullptr;
+  // commits of the connections opened otherwise are not tracked
+  if (!tracked_database)
+    return RunFullBackup();
+
+  auto res = RollBackBackup(backup_path_);
+  if (res != SQLITE_OK)
+    return res;
+
+  sqlite3 *reader{nullptr};
+  sqlite3 *checkpointer{nullptr};
+  sqlite3_file *source_file{nullptr};
+  res = sqlite3_open_v2(source_path, &reader, SQLITE_OPEN_READONLY, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_open_v2(source_path, &checkpointer, SQLITE_OPEN_READWRITE, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_file_control(reader, "main", SQLITE_FCNTL_FILE_POINTER, &source_file);
+  // shared lock waits for the commit in progress in rollback journal mode
+  sqlite3_busy_timeout(reader, kReaderBusyTimeoutMs);
+  auto backup_fd = open(backup_path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  struct stat backup_sb{};
+  if (res == SQLITE_OK && (!source_file || !source_file->pMethods || backup_fd < 0 ||
+                           fstat(backup_fd, &backup_sb) < 0))
+    res = SQLITE_CANTOPEN;
+  if (res != SQLITE_OK) {
+    sqlite3_close(reader);
+    sqlite3_close(checkpointer);
+    if (backup_fd >= 0)
+      close(backup_fd);
+    return res;
+  }
+
+  // backup changed by someone else is copied in full
+  bool is_synced = synced_source_ == source_path && synced_path_ == backup_path_ &&
+                   synced_size_ == backup_sb.st_size &&
+                   synced_mtime_.tv_sec == backup_sb.st_mtim.tv_sec &&
+                   synced_mtime_.tv_nsec == backup_sb.st_mtim.tv_nsec;
+  uint64_t page_size{0};
+  uint64_t page_count{0};
+  // pages from sweep_page on are copied by the full pass
+  uint64_t sweep_page = is_synced ? std::numeric_limits<uint64_t>::max() : 1;
+  std::set<uint32_t> pending_pages;
+  // pages taken from the tracker go back there if the pass fails
+  std::unordered_set<uint32_t> taken_pages;
+  std::unique_ptr<UndoJournal> undo_journal;
+  std::vector<char> page;
+  std::vector<uint32_t> step_pages;
+  uint32_t retries{0};
+  while (res == SQLITE_OK) {
+    if (is_cancelled_.load(std::memory_order_acquire)) {
+      res = SQLITE_INTERRUPT;
+      break;
+    }
+
+    bool is_consistent =
+      sqlite3_exec(reader, "BEGIN; SELECT count(*) FROM sqlite_master;", NULL, 0, NULL) ==
+      SQLITE_OK;
+    bool is_wal = QueryText(reader, "PRAGMA journal_mode;") == "wal";
+    auto step_page_size = std::stoull("0" + QueryText(reader, "PRAGMA page_size;"));
+    auto step_page_count = std::stoull("0" + QueryText(reader, "PRAGMA page_count;"));
+    if (is_consistent) {
+      std::lock_guard<std::mutex> lock{tracked_database->mutex};
+      is_consistent = !is_wal || !tracked_database->is_committing;
+      for (auto page_number : tracked_database->committed_pages) {
+        if (is_synced)
+          taken_pages.insert(page_number);
+        if (page_number < sweep_page)
+          pending_pages.insert(page_number);
+      }
+      tracked_database->committed_pages.clear();
+    }
+    if (is_consistent && is_wal) {
+      int log_frames{-1};
+      int checkpointed_frames{-1};
+      // read opens the WAL of the checkpointer if the database switched to it
+      sqlite3_exec(checkpointer, "SELECT count(*) FROM sqlite_master;", NULL, 0, NULL);
+      is_consistent = sqlite3_wal_checkpoint_v2(checkpointer, "main", SQLITE_CHECKPOINT_PASSIVE,
+                                                &log_frames, &checkpointed_frames) == SQLITE_OK &&
+                      log_frames >= 0 && log_frames == checkpointed_frames;
+    }
+    if (!is_consistent || step_page_size == 0) {
+      sqlite3_exec(reader, "ROLLBACK;", NULL, 0, NULL);
+      restarts_.fetch_add(1, std::memory_order_relaxed);
+      ReportProgress();
+      if (++retries > options_.max_restarts) {
+        res = SQLITE_BUSY;
+        break;
+      }
+      // commit in flight needs its thread scheduled to complete
+      std::this_thread::sleep_for(std::max(options_.step_pause, kRetryPause));
+      continue;
+    }
+    retries = 0;
+
+    if (!undo_journal) {
+      page_size = step_page_size;
+      // previous backup of another page size has no page in common with the source
+      if (page_size != synced_page_size_ && sweep_page != 1) {
+        is_synced = false;
+        sweep_page = 1;
+        pending_pages.clear();
+        taken_pages.clear();
+      }
+      page.resize(page_size);
+      undo_journal = std::make_unique<UndoJournal>(backup_path_, backup_fd, page_size,
+                                                   backup_sb.st_size);
+    } else if (step_page_size != page_size) {
+      sqlite3_exec(reader, "COMMIT;", NULL, 0, NULL);
+      res = SQLITE_BUSY;
+      break;
+    }
+
+    page_count = step_page_count;
+    pending_pages.erase(pending_pages.upper_bound(static_cast<uint32_t>(page_count)),
+                        pending_pages.end());
+    // once the pass copied as many pages as the database has, pages still committed
+    // faster than copied are taken by a single step; it holds back checkpoints in
+    // WAL mode and commits in rollback journal mode
+    auto step_size = (options_.pages_per_step < 0 ||
+                      copied_pages_.load(std::memory_order_relaxed) >= page_count) ?
+                     std::numeric_limits<std::size_t>::max() :
+                     static_cast<std::size_t>(options_.pages_per_step);
+    step_pages.clear();
+    while (!pending_pages.empty() && step_pages.size() < step_size) {
+      step_pages.push_back(*pending_pages.begin());
+      pending_pages.erase(pending_pages.begin());
+    }
+    while (sweep_page <= page_count && step_pages.size() < step_size)
+      step_pages.push_back(static_cast<uint32_t>(sweep_page++));
+
+    res = undo_journal->Save(step_pages);
+    for (auto page_number : step_pages) {
+      if (res != SQLITE_OK)
+        break;
+      off_t offset = (page_number - 1) * page_size;
+      res = source_file->pMethods->xRead(source_file, page.data(), page_size, offset);
+      if (res == SQLITE_OK && !WriteFull(backup_fd, page.data(), page_size, offset))
+        res = SQLITE_IOERR;
+    }
+    sqlite3_exec(reader, "COMMIT;", NULL, 0, NULL);
+
+    copied_pages_.fetch_add(step_pages.size(), std::memory_order_relaxed);
+    total_pages_.store(page_count, std::memory_order_relaxed);
+    auto left_pages = pending_pages.size() + ((sweep_page <= page_count) ?
+                                              page_count - sweep_page + 1 : 0);
+    done_pages_.store(page_count - std::min<uint64_t>(left_pages, page_count),
+                      std::memory_order_relaxed);
+    ReportProgress();
+    if (res != SQLITE_OK || left_pages == 0)
+      break;
+    // pages committed faster than the pass copies them
+    if (copied_pages_.load(std::memory_order_relaxed) >
+        (options_.max_restarts + 1ULL) * std::max<uint64_t>(page_count, 1)) {
+      res = SQLITE_BUSY;
+      break;
+    }
+    std::this_thread::sleep_for(options_.step_pause);
+  }
+  sqlite3_close(reader);
+  sqlite3_close(checkpointer);
+
+  struct stat synced_sb{};
+  if (res == SQLITE_OK &&
+      (ftruncate(backup_fd, page_count * page_size) < 0 || fsync(backup_fd) < 0 ||
+       fstat(backup_fd, &synced_sb) < 0))
+    res = SQLITE_IOERR;
+  undo_journal.reset();
+  close(backup_fd);
+  // removal of the undo file commits the pass
+  auto undo_res = (res == SQLITE_OK) ?
+                  ((unlink(GetUndoPath(backup_path_).c_str()) < 0 && errno != ENOENT) ||
+                   !SyncDirectory(backup_path_) ? SQLITE_IOERR : SQLITE_OK) :
+                  RollBackBackup(backup_path_);
+
+  if (res != SQLITE_OK || undo_res != SQLITE_OK) {
+    {
+      std::lock_guard<std::mutex> lock{tracked_database->mutex};
+      tracked_database->committed_pages.insert(taken_pages.begin(), taken_pages.end());
+    }
+    // restored backup is the synced one again
+    if (is_synced && undo_res == SQLITE_OK && stat(backup_path_.c_str(), &synced_sb) == 0) {
+      synced_size_ = synced_sb.st_size;
+      synced_mtime_ = synced_sb.st_mtim;
+    } else {
+      synced_path_.clear();
+    }
+    return (res != SQLITE_OK) ? res : undo_res;
+  }
+  synced_source_ = source_path;
+  synced_path_ = backup_path_;
+  synced_page_size_ = page_size;
+  synced_size_ = synced_sb.st_size;
+  synced_mtime_ = synced_sb.st_mtim;
+  return res;
+}
+
+void DatabaseBackup::ReportProgress() {
+  if (options_.progress_handler)
+    options_.progress_handler(GetProgress());
+}
+
+} // namespace client
+} // namespace crypt_wallet
@@ -0,0 +1,145 @@
+/// \file database_backup.h
+/// \brief Class running online backup of the database in background.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_DATABASE_BACKUP_H_
+#define CRYPTO_WALLET_CLIENT_DATABASE_BACKUP_H_
+
+extern "C" {
+#include <sqlite3.h>
+#include <sys/types.h>
+}
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <thread>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class DatabaseBackup database_backup.h.
+/// \brief Class copying database a few pages per step on a background thread.
+/// \details Full mode runs sqlite3_backup_step. Differential mode patches the
+/// \details previous backup in place with the pages committed since it was taken.
+/// \details Page numbers come from the change tracking VFS, so every connection
+/// \details writing the database must be opened through it; a database nobody
+/// \details opened so falls back to the full mode. Pages are read through the file
+/// \details handle of a read-only SQLite connection under its read transaction, in
+/// \details WAL mode only once the WAL is checkpointed up to that transaction;
+/// \details a step which cannot read so is retried, max_restarts bounds retries in
+/// \details a row and the pages copied by one pass to max_restarts + 1 database sizes.
+/// \details Original pages of the backup go to "<backup>-undo" before being
+/// \details overwritten, an interrupted pass is rolled back from it.
+class DatabaseBackup {
+ public:
+  /// \struct Progress database_backup.h.
+  /// \brief Backup progress.
+  struct Progress {
+    uint64_t total_pages{0};
+    uint64_t done_pages{0};
+    uint64_t copied_pages{0};
+    uint32_t restarts{0};
+  };
+
+  /// \brief Progress handler, called after every step from the backup thread.
+  /// \param[in] progress Backup progress.
+  using ProgressHandler = std::function<void(const Progress &progress)>;
+
+  /// \struct Options database_backup.h.
+  /// \brief Backup options.
+  struct Options {
+    int32_t pages_per_step{64};
+    std::chrono::milliseconds step_pause{10};
+    bool is_differential{false};
+    uint32_t max_restarts{16};
+    ProgressHandler progress_handler{};
+  };
+
+  /// \brief DatabaseBackup constructor.
+  DatabaseBackup() = default;
+
+  /// \brief DatabaseBackup destructor, cancels running backup.
+  ~DatabaseBackup();
+
+  /// \brief Class DatabaseBackup copy constructor.
+  /// \param[in] database_backup Class DatabaseBackup object.
+  DatabaseBackup(const DatabaseBackup &database_backup) = delete;
+
+  /// \brief Class DatabaseBackup copy assignment.
+  /// \param[in] database_backup Class DatabaseBackup object.
+  /// \return DatabaseBackup object.
+  DatabaseBackup &operator=(const DatabaseBackup &database_backup) = delete;
+
+  /// \brief Register the VFS recording pages committed to databases opened through it.
+  /// \return Name of the VFS for sqlite3_open_v2, nullptr if registration failed.
+  static const char *RegisterChangeTrackingVfs();
+
+  /// \brief Start backup on the background thread.
+  /// \param[in] database Source connection, writes made through it while backup
+  /// \param[in] database runs are picked up by the full mode without restart.
+  /// \param[in] backup_path Destination path.
+  /// \param[in] options Backup options.
+  /// \return SQLITE_OK if started, SQLITE_BUSY if previous backup still runs.
+  int32_t Start(sqlite3 *database, const std::string &backup_path, const Options &options);
+
+  /// \brief Request backup cancellation, destination keeps the previous backup.
+  void Cancel() noexcept;
+
+  /// \brief Wait for the backup to finish.
+  /// \return Result of the backup.
+  int32_t Wait();
+
+  /// \brief Check if backup is running.
+  /// \return Result of the check.
+  inline bool IsRunning() const noexcept {
+    return is_running_.load(std::memory_order_acquire);
+  }
+
+  /// \brief Get backup progress.
+  /// \return Progress snapshot.
+  Progress GetProgress() const noexcept;
+
+ private:
+  /// \brief Copy all pages with sqlite3_backup_step.
+  /// \return Result of the backup.
+  int32_t RunFullBackup();
+
+  /// \brief Copy pages committed since the previous backup, all pages if there is none.
+  /// \return Result of the backup.
+  int32_t RunDifferentialBackup();
+
+  /// \brief Publish progress and call the handler.
+  void ReportProgress();
+
+  sqlite3 *database_{nullptr};
+  std::string backup_path_{};
+  Options options_{};
+  std::thread worker_{};
+  std::atomic<bool> is_running_{false};
+  std::atomic<bool> is_cancelled_{false};
+  std::atomic<uint64_t> total_pages_{0};
+  std::atomic<uint64_t> done_pages_{0};
+  std::atomic<uint64_t> copied_pages_{0};
+  std::atomic<uint32_t> restarts_{0};
+  int32_t result_{SQLITE_OK};
+  // source and destination of the last differential backup, pages committed since
+  // then are tracked while the file keeps the size and modification time it was left with
+  std::string synced_source_{};
+  std::string synced_path_{};
+  uint64_t synced_page_size_{0};
+  off_t synced_size_{0};
+  struct timespec synced_mtime_{};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_DATABASE_BACKUP_H_
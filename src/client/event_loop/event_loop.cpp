@@ -0,0 +1,165 @@
+/// \file event_loop.cpp
+/// \brief Source file containing class EventLoop methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "event_loop.h"
+
+extern "C" {
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <utility>
+
+namespace crypto_wallet {
+namespace client {
+
+namespace {
+  constexpr int32_t kMaxEvents = 16;
+}
+
+EventLoop::~EventLoop() {
+  Close();
+}
+
+int32_t EventLoop::Open() {
+  Close();
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || stop_fd_ < 0) {
+    auto res = errno;
+    Close();
+    return res;
+  }
+  sigemptyset(&signals_);
+  return Watch(stop_fd_);
+}
+
+int32_t EventLoop::AddTimer(std::chrono::milliseconds interval, Handler handler) {
+  if (epoll_fd_ < 0)
+    return EBADF;
+  if (interval.count() <= 0)
+    return EINVAL;
+
+  auto timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timer_fd < 0)
+    return errno;
+  itimerspec spec{};
+  spec.it_interval.tv_sec = interval.count() / 1000;
+  spec.it_interval.tv_nsec = (interval.count() % 1000) * 1000000;
+  spec.it_value = spec.it_interval;
+  auto res = (timerfd_settime(timer_fd, 0, &spec, nullptr) < 0) ? errno : Watch(timer_fd);
+  if (res != 0) {
+    close(timer_fd);
+    return res;
+  }
+  timer_handlers_.emplace(timer_fd, std::move(handler));
+  return 0;
+}
+
+/// All signals share one signalfd, its mask is extended on every call.
+int32_t EventLoop::AddSignal(int32_t signal_number, Handler handler) {
+  if (epoll_fd_ < 0)
+    return EBADF;
+
+  sigset_t signals = signals_;
+  if (sigaddset(&signals, signal_number) < 0)
+    return errno;
+  sigset_t previous_mask{};
+  auto res = pthread_sigmask(SIG_BLOCK, &signals, &previous_mask);
+  if (res != 0)
+    return res;
+  if (!is_mask_changed_) {
+    previous_mask_ = previous_mask;
+    is_mask_changed_ = true;
+  }
+
+  auto signal_fd = signalfd(signal_fd_, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (signal_fd < 0)
+    return errno;
+  if (signal_fd_ < 0) {
+    signal_fd_ = signal_fd;
+    res = Watch(signal_fd_);
+    if (res != 0)
+      return res;
+  }
+  signals_ = signals;
+  signal_handlers_[signal_number] = std::move(handler);
+  return 0;
+}
+
+int32_t EventLoop::Run() {
+  if (epoll_fd_ < 0)
+    return EBADF;
+
+  epoll_event events[kMaxEvents];
+  while (true) {
+    auto count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      return errno;
+    }
+
+    for (int32_t i = 0; i < count; ++i) {
+      auto fd = events[i].data.fd;
+      if (fd == stop_fd_) {
+        uint64_t value{0};
+        if (read(stop_fd_, &value, sizeof(value)) < 0) {}
+        return 0;
+      }
+
+      if (fd == signal_fd_) {
+        signalfd_siginfo info{};
+        while (read(signal_fd_, &info, sizeof(info)) == sizeof(info)) {
+          auto it = signal_handlers_.find(static_cast<int32_t>(info.ssi_signo));
+          if (it != signal_handlers_.end() && it->second)
+            it->second();
+        }
+        continue;
+      }
+
+      uint64_t expirations{0};
+      auto it = timer_handlers_.find(fd);
+      if (read(fd, &expirations, sizeof(expirations)) == sizeof(expirations) &&
+          it != timer_handlers_.end() && it->second)
+        it->second();
+    }
+  }
+}
+
+void EventLoop::Stop() noexcept {
+  uint64_t value{1};
+  if (stop_fd_ >= 0 && write(stop_fd_, &value, sizeof(value)) < 0) {}
+}
+
+int32_t EventLoop::Watch(int32_t fd) {
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  return (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) ? errno : 0;
+}
+
+void EventLoop::Close() noexcept {
+  for (auto &timer : timer_handlers_)
+    close(timer.first);
+  timer_handlers_.clear();
+  signal_handlers_.clear();
+  for (auto fd : {signal_fd_, stop_fd_, epoll_fd_})
+    if (fd >= 0)
+      close(fd);
+  signal_fd_ = stop_fd_ = epoll_fd_ = -1;
+  if (is_mask_changed_)
+    pthread_sigmask(SIG_SETMASK, &previous_mask_, nullptr);
+  is_mask_changed_ = false;
+}
+
+} // namespace client
+} // namespace crypto_wallet
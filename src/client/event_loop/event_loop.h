@@ -0,0 +1,96 @@
+/// \file event_loop.h
+/// \brief Class dispatching timers and signals with epoll.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_EVENT_LOOP_H_
+#define CRYPTO_WALLET_CLIENT_EVENT_LOOP_H_
+
+extern "C" {
+#include <signal.h>
+}
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class EventLoop event_loop.h.
+/// \brief Single threaded loop running handlers of periodic timers (timerfd) and
+/// \brief signals (signalfd), sleeping in epoll_wait in between.
+/// \details Signals added to the loop are blocked in the calling thread, threads
+/// \details started afterwards inherit the mask; threads started earlier have to
+/// \details block them on their own or the signal may be delivered to them instead.
+class EventLoop {
+ public:
+  /// \brief Event handler.
+  using Handler = std::function<void()>;
+
+  /// \brief EventLoop constructor.
+  EventLoop() = default;
+
+  /// \brief EventLoop destructor, closes descriptors and restores the signal mask.
+  ~EventLoop();
+
+  /// \brief Class EventLoop copy constructor.
+  /// \param[in] event_loop Class EventLoop object.
+  EventLoop(const EventLoop &event_loop) = delete;
+
+  /// \brief Class EventLoop copy assignment.
+  /// \param[in] event_loop Class EventLoop object.
+  /// \return EventLoop object.
+  EventLoop &operator=(const EventLoop &event_loop) = delete;
+
+  /// \brief Create epoll and stop descriptors.
+  /// \return 0 on success, errno otherwise.
+  int32_t Open();
+
+  /// \brief Add periodic timer, first expiration is one interval away.
+  /// \details Expirations missed while a handler ran are coalesced into one call.
+  /// \param[in] interval Timer period.
+  /// \param[in] handler Handler.
+  /// \return 0 on success, errno otherwise.
+  int32_t AddTimer(std::chrono::milliseconds interval, Handler handler);
+
+  /// \brief Block the signal and handle it in the loop.
+  /// \param[in] signal_number Signal number.
+  /// \param[in] handler Handler.
+  /// \return 0 on success, errno otherwise.
+  int32_t AddSignal(int32_t signal_number, Handler handler);
+
+  /// \brief Dispatch events until Stop is called.
+  /// \return 0 on success, errno otherwise.
+  int32_t Run();
+
+  /// \brief Wake up and stop the loop, safe to call from any thread and handlers.
+  void Stop() noexcept;
+
+ private:
+  /// \brief Close all descriptors.
+  void Close() noexcept;
+
+  /// \brief Register descriptor with epoll.
+  /// \param[in] fd Descriptor.
+  /// \return 0 on success, errno otherwise.
+  int32_t Watch(int32_t fd);
+
+  int32_t epoll_fd_{-1};
+  int32_t stop_fd_{-1};
+  int32_t signal_fd_{-1};
+  sigset_t signals_{};
+  sigset_t previous_mask_{};
+  bool is_mask_changed_{false};
+  std::unordered_map<int32_t, Handler> timer_handlers_{};
+  std::unordered_map<int32_t, Handler> signal_handlers_{};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_EVENT_LOOP_H_
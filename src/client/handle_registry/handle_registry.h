@@ -0,0 +1,253 @@
+/// \file handle_registry.h
+/// \brief Class keeping database handles per path under an open handles budget.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_HANDLE_REGISTRY_H_
+#define CRYPTO_WALLET_CLIENT_HANDLE_REGISTRY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class HandleRegistry handle_registry.h.
+/// \brief Registry opening one handle per database path on first use and closing
+/// \brief least recently used idle handles to stay within the budgets.
+/// \details Handle is idle when nobody but the registry holds it, pinned handles
+/// \details are never closed. Handle is opened outside of the registry lock, so a
+/// \details cold open delays callers of the same path only. Handle type provides
+/// \details constructor from the path (the registry is its friend) and
+/// \details GetMemoryUsage(). Registry is thread safe, handles are not: memory usage
+/// \details is measured only while the registry alone holds the handle, a handle in
+/// \details use is counted with its last measured usage.
+template <typename Handle>
+class HandleRegistry {
+ public:
+  /// \brief Handle initializer, run after every open and reopen of the path.
+  /// \param[in] handle Opened handle.
+  /// \param[in] path Database path.
+  using Initializer = std::function<void(Handle &handle, const std::string &path)>;
+
+  /// \struct Options handle_registry.h.
+  /// \brief Registry budgets.
+  struct Options {
+    // every handle keeps the database, -wal and -shm files open
+    std::size_t max_open_handles{256};
+    std::size_t memory_budget{std::size_t{256} << 20};
+  };
+
+  /// \struct Metrics handle_registry.h.
+  /// \brief Registry counters.
+  struct Metrics {
+    uint64_t hits{0};
+    uint64_t opens{0};
+    uint64_t reopens{0};
+    uint64_t evictions{0};
+    std::size_t open_handles{0};
+    std::size_t pinned_handles{0};
+    std::size_t memory_usage{0};
+    uint64_t open_ns_total{0};
+    uint64_t open_ns_max{0};
+  };
+
+  /// \brief HandleRegistry constructor.
+  /// \param[in] options Registry budgets.
+  explicit HandleRegistry(const Options &options) : options_{options} {}
+
+  /// \brief Class HandleRegistry copy constructor.
+  /// \param[in] handle_registry Class HandleRegistry object.
+  HandleRegistry(const HandleRegistry &handle_registry) = delete;
+
+  /// \brief Class HandleRegistry copy assignment.
+  /// \param[in] handle_registry Class HandleRegistry object.
+  /// \return HandleRegistry object.
+  HandleRegistry &operator=(const HandleRegistry &handle_registry) = delete;
+
+  /// \brief Set registry budgets, applied on the next open.
+  /// \param[in] options Registry budgets.
+  void SetOptions(const Options &options) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    options_ = options;
+  }
+
+  /// \brief Set handle initializer.
+  /// \param[in] initializer Handle initializer.
+  void SetInitializer(Initializer initializer) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    initializer_ = std::move(initializer);
+  }
+
+  /// \brief Get handle of the path, open it if it is not open.
+  /// \param[in] path Database path.
+  /// \return Handle, kept open while it is held.
+  std::shared_ptr<Handle> Acquire(const std::string &path) {
+    return AcquireHandle(path, false);
+  }
+
+  /// \brief Get handle of the path, it stays open until the registry is destroyed.
+  /// \param[in] path Database path.
+  /// \return Handle.
+  Handle &AcquirePinned(const std::string &path) {
+    return *AcquireHandle(path, true);
+  }
+
+  /// \brief Get registry counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto metrics = metrics_;
+    metrics.open_handles = lru_.size();
+    metrics.pinned_handles = static_cast<std::size_t>(std::count_if(
+        entries_.begin(), entries_.end(), [](const auto &entry) { return entry.second.is_pinned; }));
+    return metrics;
+  }
+
+ private:
+  /// \struct Entry handle_registry.h.
+  /// \brief Registered path.
+  struct Entry {
+    std::shared_ptr<Handle> handle{};
+    bool is_pinned{false};
+    bool is_opening{false};
+    // measured at open and whenever the handle is idle at an eviction
+    std::size_t memory_usage{0};
+    typename std::list<std::string>::iterator lru_pos{};
+  };
+
+  /// \brief Find or open the handle.
+  /// \details Exception of the handle constructor or the initializer is passed on,
+  /// \details the path is left unregistered.
+  /// \param[in] path Database path.
+  /// \param[in] is_pinned Handle is pinned.
+  /// \return Handle.
+  std::shared_ptr<Handle> AcquireHandle(const std::string &path, bool is_pinned) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    auto it = entries_.find(path);
+    while (it != entries_.end() && it->second.is_opening) {
+      opened_condition_.wait(lock);
+      it = entries_.find(path);
+    }
+    if (it != entries_.end()) {
+      auto &entry = it->second;
+      entry.is_pinned = entry.is_pinned || is_pinned;
+      lru_.splice(lru_.begin(), lru_, entry.lru_pos);
+      ++metrics_.hits;
+      return entry.handle;
+    }
+
+    entries_.try_emplace(path).first->second.is_opening = true;
+    auto evicted = EvictIdle();
+    auto initializer = initializer_;
+    lock.unlock();
+    evicted.clear();
+
+    auto begin = std::chrono::steady_clock::now();
+    std::shared_ptr<Handle> handle;
+    try {
+      handle.reset(new Handle{path});
+      if (initializer)
+        initializer(*handle, path);
+    } catch (...) {
+      // waiters of the path retry the open themselves
+      lock.lock();
+      entries_.erase(path);
+      opened_condition_.notify_all();
+      throw;
+    }
+    auto open_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count());
+    auto memory_usage = handle->GetMemoryUsage();
+
+    lock.lock();
+    auto &entry = entries_.find(path)->second;
+    entry.handle = handle;
+    entry.memory_usage = memory_usage;
+    entry.is_pinned = is_pinned;
+    entry.is_opening = false;
+    lru_.push_front(path);
+    entry.lru_pos = lru_.begin();
+    ++metrics_.opens;
+    if (!opened_paths_.insert(path).second)
+      ++metrics_.reopens;
+    metrics_.open_ns_total += open_ns;
+    metrics_.open_ns_max = std::max(metrics_.open_ns_max, open_ns);
+    opened_condition_.notify_all();
+    return handle;
+  }
+
+  /// \brief Check the handle is held by the registry only, so it may be closed or
+  /// \brief measured.
+  /// \details Pinned handles are given out by reference and are never idle.
+  /// \param[in] entry Registered path.
+  /// \return Handle is idle.
+  static bool IsIdle(const Entry &entry) noexcept {
+    if (entry.is_pinned || entry.handle.use_count() > 1)
+      return false;
+    // pairs with the release of the last holder, its use of the handle is complete
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+
+  /// \brief Drop least recently used idle handles until a new one fits the budgets.
+  /// \details Handles are returned to be closed after the lock is released.
+  /// \return Evicted handles.
+  std::vector<std::shared_ptr<Handle>> EvictIdle() {
+    std::size_t memory_usage{0};
+    for (const auto &path : lru_) {
+      auto &entry = entries_.find(path)->second;
+      if (IsIdle(entry))
+        entry.memory_usage = entry.handle->GetMemoryUsage();
+      memory_usage += entry.memory_usage;
+    }
+
+    std::vector<std::shared_ptr<Handle>> evicted;
+    for (auto it = lru_.end(); it != lru_.begin() &&
+                               (lru_.size() >= options_.max_open_handles ||
+                                memory_usage > options_.memory_budget);) {
+      --it;
+      auto entry_it = entries_.find(*it);
+      auto &entry = entry_it->second;
+      if (!IsIdle(entry))
+        continue;
+      memory_usage -= std::min(memory_usage, entry.memory_usage);
+      evicted.push_back(std::move(entry.handle));
+      entries_.erase(entry_it);
+      it = lru_.erase(it);
+      ++metrics_.evictions;
+    }
+    metrics_.memory_usage = memory_usage;
+    return evicted;
+  }
+
+  Options options_;
+  Initializer initializer_{};
+  mutable std::mutex mutex_{};
+  std::condition_variable opened_condition_{};
+  std::unordered_map<std::string, Entry> entries_{};
+  // most recently used first, paths being opened are not listed
+  std::list<std::string> lru_{};
+  std::unordered_set<std::string> opened_paths_{};
+  Metrics metrics_{};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_HANDLE_REGISTRY_H_
@@ -0,0 +1,164 @@
+/// \file index_manager.cpp
+/// \brief Source file containing class IndexManager methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "index_manager.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+  bool is_keyword(const std::string &token, const char *keyword) {
+    std::size_t i{0};
+    for (; i < token.size() && keyword[i]; ++i)
+      if (std::toupper(static_cast<unsigned char>(token[i])) != keyword[i])
+        return false;
+    return i == token.size() && !keyword[i];
+  }
+
+  // Table written by INSERT, REPLACE, UPDATE or DELETE, empty for other statements.
+  std::string get_written_table(const std::string &shape) {
+    std::istringstream stream{shape};
+    std::vector<std::string> tokens;
+    std::string token;
+    while (stream >> token && tokens.size() < 6)
+      tokens.push_back(token);
+    if (tokens.empty())
+      return "";
+
+    std::size_t idx{tokens.size()};
+    if (is_keyword(tokens[0], "INSERT") || is_keyword(tokens[0], "REPLACE")) {
+      for (std::size_t i = 1; i + 1 < tokens.size(); ++i)
+        if (is_keyword(tokens[i], "INTO")) {
+          idx = i + 1;
+          break;
+        }
+    } else if (is_keyword(tokens[0], "UPDATE")) {
+      idx = (tokens.size() > 3 && is_keyword(tokens[1], "OR")) ? 3 : 1;
+    } else if (is_keyword(tokens[0], "DELETE") && tokens.size() > 2 &&
+               is_keyword(tokens[1], "FROM")) {
+      idx = 2;
+    }
+    if (idx >= tokens.size())
+      return "";
+
+    auto name = tokens[idx].substr(0, tokens[idx].find('('));
+    if (name.compare(0, 5, "main.") == 0)
+      name.erase(0, 5);
+    name.erase(std::remove(name.begin(), name.end(), '"'), name.end());
+    return name;
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+void IndexManager::Declare(const std::vector<std::string> &columns, bool is_unique) {
+  auto it = std::find_if(indexes_.begin(), indexes_.end(),
+                         [&columns](const IndexDefinition &index) {
+                           return index.columns == columns;
+                         });
+  if (it != indexes_.end())
+    it->is_unique = is_unique;
+  else
+    indexes_.push_back(IndexDefinition{columns, is_unique});
+}
+
+std::string IndexManager::GetCreateScript(const std::string &table_name) const {
+  std::string sql_script;
+  for (const auto &index : indexes_) {
+    if (is_bulk_load_ && !index.is_unique)
+      continue;
+    sql_script += std::string{"CREATE "} + (index.is_unique ? "UNIQUE " : "") +
+                  "INDEX IF NOT EXISTS " + GetIndexName(table_name, index.columns) + " ON " +
+                  table_name + " (";
+    for (std::size_t i = 0; i < index.columns.size(); ++i)
+      sql_script += (i ? ", " : "") + index.columns[i];
+    sql_script += ");";
+  }
+  return sql_script;
+}
+
+std::string IndexManager::GetDropScript(const std::string &table_name) const {
+  std::string sql_script;
+  for (const auto &index : indexes_)
+    if (!index.is_unique)
+      sql_script += "DROP INDEX IF EXISTS " + GetIndexName(table_name, index.columns) + ";";
+  return sql_script;
+}
+
+std::string IndexManager::GetIndexName(const std::string &table_name,
+                                       const std::vector<std::string> &columns) {
+  std::string name{table_name};
+  for (const auto &column : columns)
+    name += "_" + column;
+  return name + "_idx";
+}
+
+/// Plans are explained for the statement shapes, literals of the shape are '?' so
+/// the plan is the one of the prepared statement.
+int32_t IndexManager::CollectUsage(sqlite3 *database, const std::string &table_name,
+                                   const QueryStats &query_stats,
+                                   UsageStats &usage_stats) const {
+  usage_stats = UsageStats{};
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v2(database, "SELECT name FROM sqlite_master WHERE "
+                                "type = 'index' AND tbl_name = ?1 ORDER BY name;",
+                                -1, &stmt, nullptr);
+  if (res != SQLITE_OK)
+    return res;
+  sqlite3_bind_text(stmt, 1, table_name.c_str(), -1, SQLITE_STATIC);
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW) {
+    IndexUsage index_usage;
+    index_usage.name = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    for (const auto &index : indexes_)
+      index_usage.is_declared |= GetIndexName(table_name, index.columns) == index_usage.name;
+    usage_stats.indexes.push_back(std::move(index_usage));
+  }
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_DONE)
+    return res;
+
+  const std::string scan_prefix{"SCAN " + table_name};
+  std::vector<bool> is_used(usage_stats.indexes.size());
+  for (const auto &statement : query_stats.GetStatementCounts()) {
+    const auto &shape = statement.first;
+    if (!statement.second || shape.find(table_name) == std::string::npos ||
+        is_keyword(shape.substr(0, 7), "EXPLAIN"))
+      continue;
+    if (get_written_table(shape) == table_name)
+      usage_stats.writes += statement.second;
+
+    if (sqlite3_prepare_v2(database, ("EXPLAIN QUERY PLAN " + shape).c_str(), -1, &stmt,
+                           nullptr) != SQLITE_OK) {
+      sqlite3_finalize(stmt);
+      continue;
+    }
+    std::fill(is_used.begin(), is_used.end(), false);
+    bool is_full_scan{false};
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      auto text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+      std::string detail{text ? text : ""};
+      auto pos = detail.find("INDEX ");
+      if (pos != std::string::npos) {
+        auto name = detail.substr(pos + 6, detail.find(' ', pos + 6) - pos - 6);
+        for (std::size_t i = 0; i < usage_stats.indexes.size(); ++i)
+          is_used[i] = is_used[i] || usage_stats.indexes[i].name == name;
+      } else if (detail.compare(0, scan_prefix.size(), scan_prefix) == 0 &&
+                 (detail.size() == scan_prefix.size() || detail[scan_prefix.size()] == ' ')) {
+        is_full_scan = true;
+      }
+    }
+    sqlite3_finalize(stmt);
+    for (std::size_t i = 0; i < is_used.size(); ++i)
+      usage_stats.indexes[i].uses += is_used[i] ? statement.second : 0;
+    usage_stats.full_scans += is_full_scan ? statement.second : 0;
+  }
+  return SQLITE_OK;
+}
+
+} // namespace client
+} // namespace crypto_wallet
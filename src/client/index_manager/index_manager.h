@@ -0,0 +1,112 @@
+/// \file index_manager.h
+/// \brief Class managing secondary indexes of the loader table.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_INDEX_MANAGER_H_
+#define CRYPTO_WALLET_CLIENT_INDEX_MANAGER_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "query_stats/query_stats.h"
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class IndexManager index_manager.h.
+/// \brief Declared secondary indexes, their bulk load suspension and usage.
+/// \details Indexes are declared by columns, named <table>_<column>[_<column>...]_idx
+/// \details and created on every table the loader creates. During bulk load the
+/// \details non-unique ones are dropped and built once afterwards; unique indexes
+/// \details keep checking rows and stay.
+class IndexManager {
+ public:
+  /// \struct IndexDefinition index_manager.h.
+  /// \brief Declared index.
+  struct IndexDefinition {
+    std::vector<std::string> columns{};
+    bool is_unique{false};
+  };
+
+  /// \struct IndexUsage index_manager.h.
+  /// \brief Number of statement executions whose plan uses the index.
+  struct IndexUsage {
+    std::string name{};
+    bool is_declared{false};
+    uint64_t uses{0};
+  };
+
+  /// \struct UsageStats index_manager.h.
+  /// \brief Index usage of the table.
+  /// \details Index with no uses while writes is not zero only slows the writes down.
+  struct UsageStats {
+    std::vector<IndexUsage> indexes{};
+    // executions of statements scanning the whole table
+    uint64_t full_scans{0};
+    // executions of INSERT, UPDATE, DELETE and REPLACE on the table
+    uint64_t writes{0};
+  };
+
+  /// \brief Declare index, replaces the declaration with the same columns.
+  /// \param[in] columns Indexed columns.
+  /// \param[in] is_unique Index is unique.
+  void Declare(const std::vector<std::string> &columns, bool is_unique);
+
+  /// \brief Get declared indexes.
+  /// \return Declared indexes.
+  inline const std::vector<IndexDefinition> &GetIndexes() const noexcept { return indexes_; }
+
+  /// \brief Get SQL creating declared indexes of the table, the ones suspended by
+  /// \brief bulk load are left out.
+  /// \param[in] table_name Table name.
+  /// \return SQL script.
+  std::string GetCreateScript(const std::string &table_name) const;
+
+  /// \brief Get SQL dropping declared non-unique indexes of the table.
+  /// \param[in] table_name Table name.
+  /// \return SQL script.
+  std::string GetDropScript(const std::string &table_name) const;
+
+  /// \brief Suspend or resume maintenance of non-unique indexes.
+  /// \param[in] is_bulk_load Bulk load is in progress.
+  inline void SetBulkLoad(bool is_bulk_load) noexcept { is_bulk_load_ = is_bulk_load; }
+
+  /// \brief Check if bulk load is in progress.
+  /// \return Bulk load state.
+  inline bool IsBulkLoad() const noexcept { return is_bulk_load_; }
+
+  /// \brief Get index name.
+  /// \param[in] table_name Table name.
+  /// \param[in] columns Indexed columns.
+  /// \return Index name.
+  static std::string GetIndexName(const std::string &table_name,
+                                  const std::vector<std::string> &columns);
+
+  /// \brief Explain query plans of the traced statements and count index uses.
+  /// \details Only statements run on the traced connection are counted.
+  /// \param[in] database Connection.
+  /// \param[in] table_name Table name.
+  /// \param[in] query_stats Statistics of the connection.
+  /// \param[out] usage_stats Index usage of the table.
+  /// \return Result of reading the table indexes.
+  int32_t CollectUsage(sqlite3 *database, const std::string &table_name,
+                       const QueryStats &query_stats, UsageStats &usage_stats) const;
+
+ private:
+  std::vector<IndexDefinition> indexes_{};
+  bool is_bulk_load_{false};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_INDEX_MANAGER_H_
@@ -0,0 +1,339 @@
+/// \file memory_pool.cpp
+/// \brief Source file containing class MemoryPool methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "memory_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace crypto_wallet {
+namespace client {
+
+namespace {
+  constexpr uint32_t kLargeClass = 0xffffffff;
+  constexpr std::size_t kSlabSize = 64 * 1024;
+  constexpr uint32_t kMaxBatch = 64;
+
+  /// Block header, usable memory starts right after it.
+  struct BlockHeader {
+    uint32_t size_class;
+    uint32_t reserved;
+    uint64_t size;
+  };
+  static_assert(sizeof(BlockHeader) == MemoryPool::kHeaderSize, "header keeps 16 bytes alignment");
+
+  inline BlockHeader *get_header(const void *ptr) {
+    return reinterpret_cast<BlockHeader *>(const_cast<char *>(static_cast<const char *>(ptr)) -
+                                           MemoryPool::kHeaderSize);
+  }
+
+  // single writer counters, other threads only read them
+  inline void increment(std::atomic<uint64_t> &counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void *sqlite_malloc(int size) {
+    return MemoryPool::GetInstance().Allocate(static_cast<std::size_t>(size));
+  }
+
+  void sqlite_free(void *ptr) {
+    MemoryPool::GetInstance().Deallocate(ptr);
+  }
+
+  void *sqlite_realloc(void *ptr, int size) {
+    return MemoryPool::GetInstance().Reallocate(ptr, static_cast<std::size_t>(size));
+  }
+
+  int sqlite_size(void *ptr) {
+    return static_cast<int>(MemoryPool::GetInstance().GetSize(ptr));
+  }
+
+  int sqlite_roundup(int size) {
+    return static_cast<int>(MemoryPool::GetRoundedSize(static_cast<std::size_t>(size)));
+  }
+
+  int sqlite_init(void *) {
+    return SQLITE_OK;
+  }
+
+  void sqlite_shutdown(void *) {}
+}
+
+struct MemoryPool::ThreadCache {
+  std::array<FreeBlock *, kSizeClassCount> heads{};
+  std::array<uint32_t, kSizeClassCount> counts{};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> deallocations{0};
+  std::atomic<uint64_t> system_allocations{0};
+};
+
+/// Thread cache is handed back to the pool when the thread exits, memory freed
+/// by SQLite after that goes straight to the central lists.
+struct ThreadCacheHolder {
+  ~ThreadCacheHolder() {
+    if (thread_cache)
+      MemoryPool::GetInstance().RetireThreadCache(thread_cache);
+    thread_cache = nullptr;
+  }
+
+  MemoryPool::ThreadCache *thread_cache{nullptr};
+};
+
+namespace {
+  thread_local bool is_thread_cache_retired{false};
+}
+
+MemoryPool &MemoryPool::GetInstance() {
+  static MemoryPool *memory_pool = new MemoryPool{};
+  return *memory_pool;
+}
+
+int32_t MemoryPool::ConfigureSqlite(const SqliteOptions &options) {
+  static const sqlite3_mem_methods kMemMethods{sqlite_malloc, sqlite_free, sqlite_realloc,
+                                               sqlite_size, sqlite_roundup, sqlite_init,
+                                               sqlite_shutdown, nullptr};
+  int32_t res{SQLITE_OK};
+  if (options.is_malloc_pooled)
+    res = sqlite3_config(SQLITE_CONFIG_MALLOC, &kMemMethods);
+
+  if (res == SQLITE_OK && options.page_cache_pages > 0) {
+    int header_size{0};
+    res = sqlite3_config(SQLITE_CONFIG_PCACHE_HDRSZ, &header_size);
+    auto slot_size = (options.page_size + header_size + 7) & ~7;
+    // page cache lives as long as the process, SQLite keeps pointers into it
+    auto page_cache = res == SQLITE_OK ? std::malloc(static_cast<std::size_t>(slot_size) *
+                                                     options.page_cache_pages) : nullptr;
+    if (res == SQLITE_OK)
+      res = page_cache ? sqlite3_config(SQLITE_CONFIG_PAGECACHE, page_cache, slot_size,
+                                        options.page_cache_pages) : SQLITE_NOMEM;
+  }
+
+  if (res == SQLITE_OK && options.lookaside_slots > 0)
+    res = sqlite3_config(SQLITE_CONFIG_LOOKASIDE, options.lookaside_slot_size,
+                         options.lookaside_slots);
+  return res;
+}
+
+/// 16 bytes steps up to 128, then four classes per power of two up to 32768.
+uint32_t MemoryPool::GetSizeClass(std::size_t size) noexcept {
+  if (size <= 128)
+    return size ? static_cast<uint32_t>((size + 15) / 16 - 1) : 0;
+  auto msb = static_cast<uint32_t>(63 - __builtin_clzll(size - 1));
+  auto base = std::size_t{1} << msb;
+  auto sub_class = static_cast<uint32_t>((size - base - 1) / (base / 4));
+  return 8 + (msb - 7) * 4 + sub_class;
+}
+
+std::size_t MemoryPool::GetClassBlockSize(uint32_t size_class) noexcept {
+  if (size_class < 8)
+    return 16 * (size_class + 1) + kHeaderSize;
+  auto step = size_class - 8;
+  auto base = std::size_t{1} << (7 + step / 4);
+  return base + (step % 4 + 1) * (base / 4) + kHeaderSize;
+}
+
+std::size_t MemoryPool::GetRoundedSize(std::size_t size) noexcept {
+  if (size > kMaxPooledSize)
+    return (size + 7) & ~std::size_t{7};
+  return GetClassBlockSize(GetSizeClass(size)) - kHeaderSize;
+}
+
+MemoryPool::ThreadCache *MemoryPool::GetThreadCache() {
+  if (is_thread_cache_retired)
+    return nullptr;
+  thread_local ThreadCacheHolder holder;
+  if (!holder.thread_cache) {
+    holder.thread_cache = new ThreadCache{};
+    std::lock_guard<std::mutex> lock{registry_mutex_};
+    thread_caches_.push_back(holder.thread_cache);
+  }
+  return holder.thread_cache;
+}
+
+void MemoryPool::RetireThreadCache(ThreadCache *thread_cache) {
+  is_thread_cache_retired = true;
+  for (uint32_t size_class = 0; size_class < kSizeClassCount; ++size_class) {
+    auto head = thread_cache->heads[size_class];
+    if (!head)
+      continue;
+    auto tail = head;
+    while (tail->next)
+      tail = tail->next;
+    ReturnBlocks(size_class, head, tail);
+  }
+
+  std::lock_guard<std::mutex> lock{registry_mutex_};
+  retired_stats_.allocations += thread_cache->allocations.load(std::memory_order_relaxed);
+  retired_stats_.deallocations += thread_cache->deallocations.load(std::memory_order_relaxed);
+  retired_stats_.system_allocations +=
+      thread_cache->system_allocations.load(std::memory_order_relaxed);
+  thread_caches_.erase(std::remove(thread_caches_.begin(), thread_caches_.end(), thread_cache),
+                       thread_caches_.end());
+  delete thread_cache;
+}
+
+uint32_t MemoryPool::FetchBlocks(uint32_t size_class, uint32_t count, FreeBlock *&head) {
+  auto block_size = GetClassBlockSize(size_class);
+  auto &central_list = central_lists_[size_class];
+  std::lock_guard<std::mutex> lock{central_list.mutex};
+  uint32_t fetched{0};
+  while (fetched < count && central_list.head) {
+    auto block = central_list.head;
+    central_list.head = block->next;
+    block->next = head;
+    head = block;
+    ++fetched;
+  }
+
+  while (fetched < count) {
+    if (central_list.slab_cursor + block_size > central_list.slab_end) {
+      auto slab_size = std::max(kSlabSize, block_size * 8);
+      auto slab = static_cast<char *>(std::malloc(slab_size));
+      if (!slab)
+        break;
+      slab_bytes_.fetch_add(slab_size, std::memory_order_relaxed);
+      central_list.slab_cursor = slab;
+      central_list.slab_end = slab + slab_size;
+    }
+    auto block = reinterpret_cast<FreeBlock *>(central_list.slab_cursor);
+    central_list.slab_cursor += block_size;
+    block->next = head;
+    head = block;
+    ++fetched;
+  }
+  return fetched;
+}
+
+void MemoryPool::ReturnBlocks(uint32_t size_class, FreeBlock *head, FreeBlock *tail) {
+  auto &central_list = central_lists_[size_class];
+  std::lock_guard<std::mutex> lock{central_list.mutex};
+  tail->next = central_list.head;
+  central_list.head = head;
+}
+
+void *MemoryPool::Allocate(std::size_t size) noexcept {
+  auto thread_cache = GetThreadCache();
+  if (size > kMaxPooledSize) {
+    auto header = static_cast<BlockHeader *>(std::malloc(size + kHeaderSize));
+    if (!header)
+      return nullptr;
+    header->size_class = kLargeClass;
+    header->size = size;
+    if (thread_cache) {
+      increment(thread_cache->allocations);
+      increment(thread_cache->system_allocations);
+    } else {
+      orphan_allocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<char *>(header) + kHeaderSize;
+  }
+
+  auto size_class = GetSizeClass(size);
+  FreeBlock *block{nullptr};
+  if (thread_cache) {
+    auto &head = thread_cache->heads[size_class];
+    if (!head) {
+      auto batch = static_cast<uint32_t>(std::clamp<std::size_t>(
+          kSlabSize / 4 / GetClassBlockSize(size_class), 1, kMaxBatch));
+      thread_cache->counts[size_class] += FetchBlocks(size_class, batch, head);
+    }
+    block = head;
+    if (block) {
+      head = block->next;
+      --thread_cache->counts[size_class];
+      increment(thread_cache->allocations);
+    }
+  } else if (FetchBlocks(size_class, 1, block)) {
+    orphan_allocations_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!block)
+    return nullptr;
+
+  auto header = reinterpret_cast<BlockHeader *>(block);
+  header->size_class = size_class;
+  header->size = GetClassBlockSize(size_class) - kHeaderSize;
+  return reinterpret_cast<char *>(header) + kHeaderSize;
+}
+
+void MemoryPool::Deallocate(void *ptr) noexcept {
+  if (!ptr)
+    return;
+
+  auto header = get_header(ptr);
+  auto thread_cache = GetThreadCache();
+  if (thread_cache)
+    increment(thread_cache->deallocations);
+  else
+    orphan_deallocations_.fetch_add(1, std::memory_order_relaxed);
+  if (header->size_class == kLargeClass) {
+    std::free(header);
+    return;
+  }
+
+  auto size_class = header->size_class;
+  auto block = reinterpret_cast<FreeBlock *>(header);
+  if (!thread_cache) {
+    block->next = nullptr;
+    ReturnBlocks(size_class, block, block);
+    return;
+  }
+
+  auto &head = thread_cache->heads[size_class];
+  block->next = head;
+  head = block;
+  auto batch = static_cast<uint32_t>(std::clamp<std::size_t>(
+      kSlabSize / 4 / GetClassBlockSize(size_class), 1, kMaxBatch));
+  if (++thread_cache->counts[size_class] < 2 * batch)
+    return;
+
+  // keep one batch, hand the other one to the threads allocating this class
+  auto tail = head;
+  for (uint32_t i = 1; i < batch; ++i)
+    tail = tail->next;
+  auto returned_head = head;
+  head = tail->next;
+  thread_cache->counts[size_class] -= batch;
+  ReturnBlocks(size_class, returned_head, tail);
+}
+
+void *MemoryPool::Reallocate(void *ptr, std::size_t size) noexcept {
+  if (!ptr)
+    return Allocate(size);
+
+  auto usable_size = GetSize(ptr);
+  if (size <= usable_size && (size > kMaxPooledSize || GetSizeClass(size) ==
+                                                       get_header(ptr)->size_class))
+    return ptr;
+
+  auto new_ptr = Allocate(size);
+  if (!new_ptr)
+    return nullptr;
+  std::memcpy(new_ptr, ptr, std::min(size, usable_size));
+  Deallocate(ptr);
+  return new_ptr;
+}
+
+std::size_t MemoryPool::GetSize(const void *ptr) const noexcept {
+  return ptr ? static_cast<std::size_t>(get_header(ptr)->size) : 0;
+}
+
+MemoryPool::Stats MemoryPool::GetStats() const {
+  std::lock_guard<std::mutex> lock{registry_mutex_};
+  auto stats = retired_stats_;
+  for (const auto thread_cache : thread_caches_) {
+    stats.allocations += thread_cache->allocations.load(std::memory_order_relaxed);
+    stats.deallocations += thread_cache->deallocations.load(std::memory_order_relaxed);
+    stats.system_allocations += thread_cache->system_allocations.load(std::memory_order_relaxed);
+  }
+  stats.allocations += orphan_allocations_.load(std::memory_order_relaxed);
+  stats.deallocations += orphan_deallocations_.load(std::memory_order_relaxed);
+  stats.slab_bytes = slab_bytes_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace client
+} // namespace crypt_wallet
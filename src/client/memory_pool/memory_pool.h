@@ -0,0 +1,192 @@
+/// \file memory_pool.h
+/// \brief Class pooling small heap allocations for SQLite and the loader.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_MEMORY_POOL_H_
+#define CRYPTO_WALLET_CLIENT_MEMORY_POOL_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class MemoryPool memory_pool.h.
+/// \brief Size class pool allocator with per-thread caches.
+/// \details Blocks up to kMaxPooledSize are carved from slabs and reused through
+/// \details lock-free per-thread free lists; threads exchange blocks with the
+/// \details central lists in batches. Larger blocks go to the system allocator.
+/// \details Slabs are never returned to the system.
+class MemoryPool {
+ public:
+  static constexpr std::size_t kHeaderSize = 16;
+  static constexpr std::size_t kMaxPooledSize = 32768;
+  static constexpr uint32_t kSizeClassCount = 40;
+
+  /// \struct Stats memory_pool.h.
+  /// \brief Pool counters, allocations are cumulative.
+  struct Stats {
+    uint64_t allocations{0};
+    uint64_t deallocations{0};
+    uint64_t system_allocations{0};
+    uint64_t slab_bytes{0};
+  };
+
+  /// \struct SqliteOptions memory_pool.h.
+  /// \brief SQLite memory configuration.
+  struct SqliteOptions {
+    // route sqlite3_malloc through the pool (SQLITE_CONFIG_MALLOC)
+    bool is_malloc_pooled{true};
+    // preallocated page cache slots (SQLITE_CONFIG_PAGECACHE), 0 disables it
+    int32_t page_cache_pages{0};
+    int32_t page_size{4096};
+    // default lookaside (SQLITE_CONFIG_LOOKASIDE), no-op if built with OMIT_LOOKASIDE
+    int32_t lookaside_slot_size{128};
+    int32_t lookaside_slots{0};
+  };
+
+  /// \brief Get process wide pool, it is never destroyed since SQLite may free
+  /// \brief memory during static destruction.
+  /// \return Pool.
+  static MemoryPool &GetInstance();
+
+  /// \brief Configure SQLite memory subsystems to use the pool.
+  /// \details Must be called before any connection is opened, SQLite refuses
+  /// \details configuration once it is initialized.
+  /// \param[in] options SQLite memory configuration.
+  /// \return Result of the configuration, SQLITE_MISUSE if SQLite is initialized.
+  static int32_t ConfigureSqlite(const SqliteOptions &options);
+
+  /// \brief Allocate block.
+  /// \param[in] size Size in bytes.
+  /// \return 16 bytes aligned block or nullptr.
+  void *Allocate(std::size_t size) noexcept;
+
+  /// \brief Release block.
+  /// \param[in] ptr Block returned by Allocate, may be nullptr.
+  void Deallocate(void *ptr) noexcept;
+
+  /// \brief Resize block, keeps it when the size class fits.
+  /// \param[in] ptr Block returned by Allocate.
+  /// \param[in] size New size in bytes.
+  /// \return Resized block or nullptr, ptr stays valid on failure.
+  void *Reallocate(void *ptr, std::size_t size) noexcept;
+
+  /// \brief Get usable size of the block.
+  /// \param[in] ptr Block returned by Allocate.
+  /// \return Usable size in bytes.
+  std::size_t GetSize(const void *ptr) const noexcept;
+
+  /// \brief Get size Allocate rounds the request up to.
+  /// \param[in] size Size in bytes.
+  /// \return Usable size in bytes.
+  static std::size_t GetRoundedSize(std::size_t size) noexcept;
+
+  /// \brief Get pool counters, summed over all threads.
+  /// \return Counters snapshot.
+  Stats GetStats() const;
+
+  /// \struct FreeBlock memory_pool.h.
+  /// \brief Free list node placed into the released block.
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  /// \struct ThreadCache memory_pool.h.
+  /// \brief Per-thread free lists and counters.
+  struct ThreadCache;
+
+ private:
+  /// \brief MemoryPool constructor.
+  MemoryPool() = default;
+
+  /// \struct CentralList memory_pool.h.
+  /// \brief Shared free list of the size class.
+  struct CentralList {
+    std::mutex mutex{};
+    FreeBlock *head{nullptr};
+    char *slab_cursor{nullptr};
+    char *slab_end{nullptr};
+  };
+
+  /// \brief Get size class of the request.
+  static uint32_t GetSizeClass(std::size_t size) noexcept;
+
+  /// \brief Get block size of the size class, header included.
+  static std::size_t GetClassBlockSize(uint32_t size_class) noexcept;
+
+  /// \brief Move up to count blocks of the size class from the central list.
+  /// \return Number of moved blocks.
+  uint32_t FetchBlocks(uint32_t size_class, uint32_t count, FreeBlock *&head);
+
+  /// \brief Return the list of blocks to the central list.
+  void ReturnBlocks(uint32_t size_class, FreeBlock *head, FreeBlock *tail);
+
+  /// \brief Get cache of the calling thread, nullptr after the thread cache is gone.
+  ThreadCache *GetThreadCache();
+
+  /// \brief Unregister thread cache, blocks and counters are handed to the pool.
+  void RetireThreadCache(ThreadCache *thread_cache);
+
+  friend struct ThreadCacheHolder;
+
+  std::array<CentralList, kSizeClassCount> central_lists_{};
+  mutable std::mutex registry_mutex_{};
+  std::vector<ThreadCache *> thread_caches_{};
+  Stats retired_stats_{};
+  std::atomic<uint64_t> slab_bytes_{0};
+  std::atomic<uint64_t> orphan_allocations_{0};
+  std::atomic<uint64_t> orphan_deallocations_{0};
+};
+
+/// \class PoolAllocator memory_pool.h.
+/// \brief Standard allocator adapter over MemoryPool for containers and strings.
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+  T *allocate(std::size_t count) {
+    auto ptr = MemoryPool::GetInstance().Allocate(count * sizeof(T));
+    if (!ptr)
+      throw std::bad_alloc{};
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, std::size_t) noexcept {
+    MemoryPool::GetInstance().Deallocate(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U> &) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const PoolAllocator<U> &) const noexcept {
+    return false;
+  }
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_MEMORY_POOL_H_
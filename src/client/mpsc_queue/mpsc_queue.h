@@ -0,0 +1,111 @@
+/// \file mpsc_queue.h
+/// \brief Bounded lock-free multi-producer single-consumer queue.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_MPSC_QUEUE_H_
+#define CRYPTO_WALLET_CLIENT_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class MpscQueue mpsc_queue.h.
+/// \brief Bounded lock-free queue, any number of producers and a single consumer.
+/// \details Every cell carries a sequence number telling whether it is free for
+/// \details the producer or ready for the consumer, so neither side takes a lock
+/// \details and a full queue is reported instead of blocking.
+template <typename T>
+class MpscQueue {
+ public:
+  /// \brief MpscQueue constructor.
+  /// \param[in] capacity Queue capacity, rounded up to the power of two.
+  explicit MpscQueue(std::size_t capacity) {
+    std::size_t size{2};
+    while (size < capacity)
+      size <<= 1;
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (std::size_t i = 0; i < size; ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  /// \brief Class MpscQueue copy constructor.
+  /// \param[in] mpsc_queue Class MpscQueue object.
+  MpscQueue(const MpscQueue &mpsc_queue) = delete;
+
+  /// \brief Class MpscQueue copy assignment.
+  /// \param[in] mpsc_queue Class MpscQueue object.
+  /// \return MpscQueue object.
+  MpscQueue &operator=(const MpscQueue &mpsc_queue) = delete;
+
+  /// \brief Push value, safe to call from any thread.
+  /// \param[in] value Value, left untouched if the queue is full.
+  /// \return false if the queue is full.
+  bool TryPush(T &&value) {
+    Cell *cell{nullptr};
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      auto seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// \brief Pop value, must be called from the single consumer thread.
+  /// \param[out] value Popped value.
+  /// \return false if the queue is empty.
+  bool TryPop(T &value) {
+    auto &cell = cells_[dequeue_pos_ & mask_];
+    auto seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeue_pos_ + 1) < 0)
+      return false;
+
+    value = std::move(cell.value);
+    cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+    ++dequeue_pos_;
+    return true;
+  }
+
+  /// \brief Get queue capacity.
+  /// \return Queue capacity.
+  inline std::size_t GetCapacity() const noexcept {
+    return mask_ + 1;
+  }
+
+ private:
+  struct alignas(64) Cell {
+    std::atomic<std::size_t> sequence{0};
+    T value{};
+  };
+
+  std::unique_ptr<Cell[]> cells_{};
+  std::size_t mask_{0};
+  alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+  alignas(64) std::size_t dequeue_pos_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_MPSC_QUEUE_H_
@@ -0,0 +1,365 @@
+/// \file query_stats.cpp
+/// \brief Source file containing classes LatencyHistogram and QueryStats methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "query_stats.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+  using crypto_wallet::client::QueryStats;
+
+  // Traced statement state, kept per thread so the trace callback takes no locks.
+  struct TracedStatement {
+    const QueryStats *owner{nullptr};
+    QueryStats::StatementStats *stats{nullptr};
+    std::string sql_script{};
+    std::chrono::steady_clock::time_point start{};
+    uint64_t rows{0};
+    uint64_t bytes{0};
+  };
+
+  // Statements finalized long ago are dropped once the map grows beyond this size.
+  constexpr std::size_t kMaxTracedStatements = 1024;
+
+  // statements run by destructors of statics after thread exit are not traced
+  thread_local bool is_trace_state_retired{false};
+
+  struct TraceState {
+    ~TraceState() { is_trace_state_retired = true; }
+
+    std::unordered_map<sqlite3_stmt *, TracedStatement> traced_statements{};
+    sqlite3_stmt *last_statement{nullptr};
+    TracedStatement *last_traced_statement{nullptr};
+    std::string shape{};
+  };
+
+  thread_local TraceState trace_state;
+
+  TracedStatement *GetTracedStatement(sqlite3_stmt *statement) {
+    if (is_trace_state_retired)
+      return nullptr;
+    if (statement == trace_state.last_statement)
+      return trace_state.last_traced_statement;
+    if (trace_state.traced_statements.size() >= kMaxTracedStatements)
+      trace_state.traced_statements.clear();
+    trace_state.last_statement = statement;
+    trace_state.last_traced_statement = &trace_state.traced_statements[statement];
+    return trace_state.last_traced_statement;
+  }
+
+  bool IsIdentifierChar(char ch) {
+    return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_' || ch == '$';
+  }
+
+  void AppendJsonString(std::ostringstream &json, std::string_view str) {
+    json << '"';
+    for (auto ch : str) {
+      if (ch == '"' || ch == '\\') {
+        json << '\\' << ch;
+      } else if (static_cast<unsigned char>(ch) < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+        json << escaped;
+      } else {
+        json << ch;
+      }
+    }
+    json << '"';
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t value) noexcept {
+  if (value < kSubBucketCount)
+    return static_cast<uint32_t>(value);
+  auto msb = static_cast<uint32_t>(63 - __builtin_clzll(value));
+  auto sub_bucket = static_cast<uint32_t>(value >> (msb - kSubBucketBits)) & (kSubBucketCount - 1);
+  return (msb - kSubBucketBits + 1) * kSubBucketCount + sub_bucket;
+}
+
+uint64_t LatencyHistogram::GetBucketHighestValue(uint32_t index) noexcept {
+  if (index < kSubBucketCount)
+    return index;
+  auto shift = index / kSubBucketCount - 1;
+  auto lowest = static_cast<uint64_t>(kSubBucketCount + index % kSubBucketCount) << shift;
+  return lowest + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::Record(uint64_t value) noexcept {
+  buckets_[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  auto max = max_.load(std::memory_order_relaxed);
+  while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const noexcept {
+  uint64_t total{0};
+  for (const auto &bucket : buckets_)
+    total += bucket.load(std::memory_order_relaxed);
+  if (!total)
+    return 0;
+
+  auto rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+  rank = rank ? rank : 1;
+  uint64_t seen{0};
+  for (uint32_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank)
+      return std::min(GetBucketHighestValue(i), GetMax());
+  }
+  return GetMax();
+}
+
+void QueryStats::Attach(sqlite3 *database) {
+  database_.store(database, std::memory_order_release);
+  InstallTracer(database);
+}
+
+void QueryStats::AttachReader(sqlite3 *database) {
+  InstallTracer(database);
+}
+
+void QueryStats::InstallTracer(sqlite3 *database) {
+  uint32_t mask = SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE;
+  if (is_rows_traced_.load(std::memory_order_relaxed))
+    mask |= SQLITE_TRACE_ROW;
+  sqlite3_trace_v2(database, mask, Trace, this);
+}
+
+void QueryStats::SetRowsTraced(bool is_rows_traced) {
+  is_rows_traced_.store(is_rows_traced, std::memory_order_relaxed);
+  if (auto database = database_.load(std::memory_order_acquire))
+    Attach(database);
+}
+
+/// 'text', numbers and x'blob' become '?', whitespace runs become single space.
+void QueryStats::NormalizeSql(std::string_view sql_script, std::string &shape) {
+  shape.clear();
+  std::size_t i{0};
+  while (i < sql_script.size()) {
+    char ch = sql_script[i];
+    char prev = shape.empty() ? ' ' : shape.back();
+    if (std::isspace(static_cast<unsigned char>(ch))) {
+      while (i < sql_script.size() && std::isspace(static_cast<unsigned char>(sql_script[i])))
+        ++i;
+      if (!shape.empty())
+        shape += ' ';
+    } else if (ch == '\'') {
+      if ((prev == 'x' || prev == 'X') &&
+          (shape.size() < 2 || !IsIdentifierChar(shape[shape.size() - 2])))
+        shape.pop_back();
+      for (++i; i < sql_script.size(); ++i) {
+        if (sql_script[i] == '\'') {
+          if (i + 1 < sql_script.size() && sql_script[i + 1] == '\'')
+            ++i;
+          else
+            break;
+        }
+      }
+      ++i;
+      shape += '?';
+    } else if (std::isdigit(static_cast<unsigned char>(ch)) && !IsIdentifierChar(prev) &&
+               prev != '?' && prev != ':' && prev != '@') {
+      while (i < sql_script.size() &&
+             (std::isalnum(static_cast<unsigned char>(sql_script[i])) || sql_script[i] == '.'))
+        ++i;
+      shape += '?';
+    } else {
+      shape += ch;
+      ++i;
+    }
+  }
+  while (!shape.empty() && shape.back() == ' ')
+    shape.pop_back();
+}
+
+std::vector<std::pair<std::string, uint64_t>> QueryStats::GetStatementCounts() const {
+  std::vector<std::pair<std::string, uint64_t>> counts;
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  counts.reserve(statements_.size());
+  for (const auto &statement : statements_)
+    counts.emplace_back(statement.first, statement.second->latency.GetCount());
+  return counts;
+}
+
+QueryStats::StatementStats &QueryStats::GetStatementStats(const std::string &shape) {
+  {
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+    auto it = statements_.find(shape);
+    if (it != statements_.end())
+      return *it->second;
+  }
+  std::unique_lock<std::shared_mutex> lock{mutex_};
+  auto &stats = statements_[shape];
+  if (!stats)
+    stats = std::make_unique<StatementStats>();
+  return *stats;
+}
+
+/// Profile event own duration has millisecond resolution only, latency is measured
+/// from the statement start event instead.
+int QueryStats::Trace(uint32_t event, void *query_stats, void *stmt, void *value) {
+  auto self = static_cast<QueryStats *>(query_stats);
+  auto statement = static_cast<sqlite3_stmt *>(stmt);
+  auto traced_statement = GetTracedStatement(statement);
+  if (!traced_statement)
+    return 0;
+  auto &traced = *traced_statement;
+  if (event == SQLITE_TRACE_STMT) {
+    // trigger programs report "-- trigger" text while the statement runs
+    auto sql_script = static_cast<const char *>(value);
+    if (!sql_script || std::strncmp(sql_script, "--", 2) != 0) {
+      traced.start = std::chrono::steady_clock::now();
+      traced.rows = 0;
+      traced.bytes = 0;
+    }
+    return 0;
+  }
+
+  if (event == SQLITE_TRACE_ROW) {
+    ++traced.rows;
+    // bytes of text and blob columns, sqlite3_column_bytes would convert numbers
+    auto count = sqlite3_column_count(statement);
+    for (int i = 0; i < count; ++i) {
+      auto type = sqlite3_column_type(statement, i);
+      traced.bytes += (type == SQLITE_TEXT || type == SQLITE_BLOB)
+                          ? static_cast<uint64_t>(sqlite3_column_bytes(statement, i))
+                          : (type == SQLITE_NULL ? 0 : 8);
+    }
+    return 0;
+  }
+
+  if (event == SQLITE_TRACE_PROFILE) {
+    // statement address may be reused by another SQL text, the shape is checked
+    auto sql_script = sqlite3_sql(statement);
+    sql_script = sql_script ? sql_script : "";
+    if (!traced.stats || traced.owner != self || traced.sql_script != sql_script) {
+      auto &shape = trace_state.shape;
+      NormalizeSql(sql_script, shape);
+      traced.owner = self;
+      traced.stats = &self->GetStatementStats(shape);
+      traced.sql_script = sql_script;
+    }
+
+    auto elapsed = static_cast<uint64_t>(*static_cast<sqlite3_int64 *>(value));
+    if (traced.start != std::chrono::steady_clock::time_point{})
+      elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - traced.start).count());
+    traced.stats->latency.Record(elapsed);
+    traced.stats->rows.fetch_add(traced.rows, std::memory_order_relaxed);
+    traced.stats->bytes.fetch_add(traced.bytes, std::memory_order_relaxed);
+    traced.start = std::chrono::steady_clock::time_point{};
+    traced.rows = 0;
+    traced.bytes = 0;
+  }
+  return 0;
+}
+
+QueryStats::MemoryStats QueryStats::SampleMemoryStats() const noexcept {
+  MemoryStats stats{};
+  sqlite3_int64 highwater{0};
+  sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &stats.memory_used, &stats.memory_highwater, 0);
+  sqlite3_status64(SQLITE_STATUS_MALLOC_COUNT, &stats.malloc_count, &highwater, 0);
+  sqlite3_status64(SQLITE_STATUS_PAGECACHE_USED, &stats.pagecache_used, &highwater, 0);
+  sqlite3_status64(SQLITE_STATUS_PAGECACHE_OVERFLOW, &stats.pagecache_overflow, &highwater, 0);
+
+  auto database = database_.load(std::memory_order_acquire);
+  if (!database)
+    return stats;
+  int value_highwater{0};
+  sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_USED, &stats.cache_used, &value_highwater, 0);
+  sqlite3_db_status(database, SQLITE_DBSTATUS_SCHEMA_USED, &stats.schema_used, &value_highwater,
+                    0);
+  sqlite3_db_status(database, SQLITE_DBSTATUS_STMT_USED, &stats.stmt_used, &value_highwater, 0);
+  sqlite3_db_status(database, SQLITE_DBSTATUS_LOOKASIDE_USED, &stats.lookaside_used,
+                    &value_highwater, 0);
+  sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_HIT, &stats.cache_hit, &value_highwater, 0);
+  sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_MISS, &stats.cache_miss, &value_highwater,
+                    0);
+  sqlite3_db_status(database, SQLITE_DBSTATUS_CACHE_WRITE, &stats.cache_write, &value_highwater,
+                    0);
+  return stats;
+}
+
+std::string QueryStats::GetReport() const {
+  auto memory = SampleMemoryStats();
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  uint64_t total_rows{0};
+  for (const auto &statement : statements_)
+    total_rows += statement.second->rows.load(std::memory_order_relaxed);
+
+  std::ostringstream json;
+  json << "{\n  \"rows\": " << total_rows
+       << ",\n  \"statement_cache\": {\"hits\": "
+       << statement_cache_hits_.load(std::memory_order_relaxed)
+       << ", \"misses\": " << statement_cache_misses_.load(std::memory_order_relaxed) << "}"
+       << ",\n  \"memory\": {\"memory_used\": " << memory.memory_used
+       << ", \"memory_highwater\": " << memory.memory_highwater
+       << ", \"malloc_count\": " << memory.malloc_count
+       << ", \"pagecache_used\": " << memory.pagecache_used
+       << ", \"pagecache_overflow\": " << memory.pagecache_overflow
+       << ", \"cache_used\": " << memory.cache_used
+       << ", \"schema_used\": " << memory.schema_used
+       << ", \"stmt_used\": " << memory.stmt_used
+       << ", \"lookaside_used\": " << memory.lookaside_used << "}"
+       << ",\n  \"page_cache\": {\"hits\": " << memory.cache_hit
+       << ", \"misses\": " << memory.cache_miss << ", \"writes\": " << memory.cache_write << "}"
+       << ",\n  \"statements\": [";
+  bool is_first{true};
+  for (const auto &[shape, stats] : statements_) {
+    const auto &latency = stats->latency;
+    auto count = latency.GetCount();
+    json << (is_first ? "\n    {\"sql\": " : ",\n    {\"sql\": ");
+    AppendJsonString(json, shape);
+    json << ", \"count\": " << count
+         << ", \"rows\": " << stats->rows.load(std::memory_order_relaxed)
+         << ", \"bytes\": " << stats->bytes.load(std::memory_order_relaxed)
+         << ", \"total_ns\": " << latency.GetSum()
+         << ", \"mean_ns\": " << (count ? latency.GetSum() / count : 0)
+         << ", \"p50_ns\": " << latency.GetValueAtPercentile(50)
+         << ", \"p90_ns\": " << latency.GetValueAtPercentile(90)
+         << ", \"p99_ns\": " << latency.GetValueAtPercentile(99)
+         << ", \"p999_ns\": " << latency.GetValueAtPercentile(99.9)
+         << ", \"max_ns\": " << latency.GetMax() << "}";
+    is_first = false;
+  }
+  json << "\n  ]\n}\n";
+  return json.str();
+}
+
+int32_t QueryStats::WriteReport(const std::string &report_path) const {
+  auto report = GetReport();
+  auto tmp_path = report_path + ".tmp";
+  auto file = std::fopen(tmp_path.c_str(), "w");
+  if (!file)
+    return errno;
+
+  bool is_written = std::fwrite(report.data(), 1, report.size(), file) == report.size();
+  int32_t res = is_written ? 0 : errno;
+  if (std::fclose(file) != 0 && !res)
+    res = errno;
+  if (!res && std::rename(tmp_path.c_str(), report_path.c_str()) != 0)
+    res = errno;
+  if (res)
+    std::remove(tmp_path.c_str());
+  return res;
+}
+
+} // namespace client
+} // namespace crypt_wallet
@@ -0,0 +1,197 @@
+/// \file query_stats.h
+/// \brief Classes collecting SQL statement statistics.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_QUERY_STATS_H_
+#define CRYPTO_WALLET_CLIENT_QUERY_STATS_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class LatencyHistogram query_stats.h.
+/// \brief Lock-free log-linear histogram of nanosecond latencies.
+/// \details Values below 16 get own buckets, above every power of two is split
+/// \details into 16 sub-buckets, so the relative error is below 6.25%.
+class LatencyHistogram {
+ public:
+  static constexpr uint32_t kSubBucketBits = 4;
+  static constexpr uint32_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr uint32_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+  /// \brief Record value.
+  /// \param[in] value Latency in nanoseconds.
+  void Record(uint64_t value) noexcept;
+
+  /// \brief Get value at percentile.
+  /// \param[in] percentile Percentile in range [0, 100].
+  /// \return Highest value equivalent to the bucket holding the percentile.
+  uint64_t GetValueAtPercentile(double percentile) const noexcept;
+
+  /// \brief Get number of recorded values.
+  /// \return Number of values.
+  inline uint64_t GetCount() const noexcept {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Get sum of recorded values.
+  /// \return Sum of values.
+  inline uint64_t GetSum() const noexcept {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Get max recorded value.
+  /// \return Max value.
+  inline uint64_t GetMax() const noexcept {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Get bucket of the value.
+  /// \param[in] value Value.
+  /// \return Bucket index.
+  static uint32_t GetBucketIndex(uint64_t value) noexcept;
+
+  /// \brief Get highest value equivalent to the bucket.
+  /// \param[in] index Bucket index.
+  /// \return Highest value of the bucket.
+  static uint64_t GetBucketHighestValue(uint32_t index) noexcept;
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+/// \class QueryStats query_stats.h.
+/// \brief SQL statistics of the connection collected with sqlite3_trace_v2.
+/// \details Statements are grouped by shape, SQL text with literals replaced by
+/// \details '?', each shape keeps latency histogram, rows and result bytes. Latency
+/// \details is measured from the first step to the reset of the statement, rows and
+/// \details bytes stay zero unless SetRowsTraced enables them.
+class QueryStats {
+ public:
+  /// \struct StatementStats query_stats.h.
+  /// \brief Statistics of the statement shape.
+  struct StatementStats {
+    LatencyHistogram latency{};
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> bytes{0};
+  };
+
+  /// \struct MemoryStats query_stats.h.
+  /// \brief SQLite process and connection memory counters.
+  struct MemoryStats {
+    sqlite3_int64 memory_used{0};
+    sqlite3_int64 memory_highwater{0};
+    sqlite3_int64 malloc_count{0};
+    sqlite3_int64 pagecache_used{0};
+    sqlite3_int64 pagecache_overflow{0};
+    int32_t cache_used{0};
+    int32_t schema_used{0};
+    int32_t stmt_used{0};
+    int32_t lookaside_used{0};
+    int32_t cache_hit{0};
+    int32_t cache_miss{0};
+    int32_t cache_write{0};
+  };
+
+  /// \brief QueryStats constructor.
+  QueryStats() = default;
+
+  /// \brief Class QueryStats copy constructor.
+  /// \param[in] query_stats Class QueryStats object.
+  QueryStats(const QueryStats &query_stats) = delete;
+
+  /// \brief Class QueryStats copy assignment.
+  /// \param[in] query_stats Class QueryStats object.
+  /// \return QueryStats object.
+  QueryStats &operator=(const QueryStats &query_stats) = delete;
+
+  /// \brief Collect statistics of the connection, installs the tracer.
+  /// \details Statistics gathered on the previous connection are kept.
+  /// \param[in] database Connection.
+  void Attach(sqlite3 *database);
+
+  /// \brief Collect statistics of the read-only connection too, installs the tracer.
+  /// \details Statements of every reader count into the same shapes, memory
+  /// \details counters stay with the attached connection. Reader must be closed
+  /// \details before QueryStats is destroyed, row tracing is taken as set now.
+  /// \param[in] database Read-only connection.
+  void AttachReader(sqlite3 *database);
+
+  /// \brief Enable or disable per row tracing counting rows and result bytes.
+  /// \details Row events cost a callback per result row, scans get slower with them.
+  /// \param[in] is_rows_traced Rows are traced, disabled by default.
+  void SetRowsTraced(bool is_rows_traced);
+
+  /// \brief Count lookup in the prepared statement cache.
+  /// \param[in] is_hit Lookup found the statement.
+  inline void RecordStatementCacheLookup(bool is_hit) noexcept {
+    (is_hit ? statement_cache_hits_ : statement_cache_misses_)
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Sample SQLite memory counters of the process and the connection.
+  /// \return Counters snapshot.
+  MemoryStats SampleMemoryStats() const noexcept;
+
+  /// \brief Get number of executions of every statement shape.
+  /// \return Shapes and their execution counts.
+  std::vector<std::pair<std::string, uint64_t>> GetStatementCounts() const;
+
+  /// \brief Get statement shape statistics as JSON.
+  /// \return JSON document.
+  std::string GetReport() const;
+
+  /// \brief Write report into the file, replaced atomically.
+  /// \param[in] report_path File path.
+  /// \return errno value, 0 on success.
+  int32_t WriteReport(const std::string &report_path) const;
+
+  /// \brief Replace literals in the SQL text with '?'.
+  /// \param[in] sql_script SQL text.
+  /// \param[out] shape Statement shape.
+  static void NormalizeSql(std::string_view sql_script, std::string &shape);
+
+ private:
+  /// \brief Find or add statistics of the statement shape.
+  StatementStats &GetStatementStats(const std::string &shape);
+
+  /// \brief Tracer callback.
+  static int Trace(uint32_t event, void *query_stats, void *stmt, void *value);
+
+  /// \brief Install the tracer on the connection.
+  /// \param[in] database Connection.
+  void InstallTracer(sqlite3 *database);
+
+  std::atomic<sqlite3 *> database_{nullptr};
+  std::atomic<bool> is_rows_traced_{false};
+  std::unordered_map<std::string, std::unique_ptr<StatementStats>> statements_{};
+  mutable std::shared_mutex mutex_{};
+  std::atomic<uint64_t> statement_cache_hits_{0};
+  std::atomic<uint64_t> statement_cache_misses_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_QUERY_STATS_H_
@@ -0,0 +1,137 @@
+/// \file read_snapshot.cpp
+/// \brief Source file containing class ReadSnapshot methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "read_snapshot.h"
+
+#include <iostream>
+#include <utility>
+
+namespace crypto_wallet {
+namespace client {
+
+ReadSnapshot::ReadSnapshot(int32_t result) noexcept : result_{result} {}
+
+/// Read transaction starts with the first read after BEGIN, so the schema is
+/// read right away to fix the point in time at the constructor call.
+ReadSnapshot::ReadSnapshot(const std::string &db_name, const std::string &init_script,
+                           std::shared_ptr<ConnectionPool> read_pool)
+    : state_{std::make_unique<State>()} {
+  auto &state = *state_;
+  state.read_pool_ = std::move(read_pool);
+  result_ = sqlite3_open_v2(db_name.c_str(), &state.database_,
+                            SQLITE_OPEN_READONLY | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX,
+                            nullptr);
+  if (result_ == SQLITE_OK) {
+    sqlite3_busy_timeout(state.database_, 1000);
+    if (!init_script.empty())
+      result_ = sqlite3_exec(state.database_, init_script.c_str(), NULL, 0, NULL);
+  }
+
+  // read lock of the rollback journal database would stall the writer
+  bool is_wal{false};
+  if (result_ == SQLITE_OK)
+    result_ = RunQuery(state.database_, "PRAGMA journal_mode;", [&is_wal](const auto &row) {
+      is_wal = row.GetText(0) == "wal";
+    });
+  if (result_ == SQLITE_OK && !is_wal)
+    result_ = SQLITE_MISUSE;
+
+  if (result_ == SQLITE_OK)
+    result_ = sqlite3_exec(state.database_, "BEGIN; SELECT count(*) FROM sqlite_schema;", NULL,
+                           0, NULL);
+#ifdef SQLITE_ENABLE_SNAPSHOT
+  if (result_ == SQLITE_OK)
+    result_ = sqlite3_snapshot_get(state.database_, "main", &state.snapshot_);
+#endif
+
+  if (result_ != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Snapshot was not pinned: " << sqlite3_errstr(result_) << std::endl;
+    Release();
+  }
+}
+
+ReadSnapshot::~ReadSnapshot() {
+  Release();
+}
+
+ReadSnapshot::ReadSnapshot(ReadSnapshot &&read_snapshot) noexcept
+    : state_{std::move(read_snapshot.state_)}, result_{read_snapshot.result_} {
+  read_snapshot.result_ = SQLITE_MISUSE;
+}
+
+ReadSnapshot &ReadSnapshot::operator=(ReadSnapshot &&read_snapshot) noexcept {
+  if (this != &read_snapshot) {
+    Release();
+    state_ = std::move(read_snapshot.state_);
+    result_ = read_snapshot.result_;
+    read_snapshot.result_ = SQLITE_MISUSE;
+  }
+  return *this;
+}
+
+int32_t ReadSnapshot::Query(const std::string &sql_script, const RowHandler &row_handler) {
+  if (!state_)
+    return SQLITE_MISUSE;
+
+  auto &state = *state_;
+#ifdef SQLITE_ENABLE_SNAPSHOT
+  if (state.read_pool_) {
+    std::shared_lock<std::shared_mutex> lock{state.mutex_};
+    if (!state.database_)
+      return SQLITE_MISUSE;
+    auto lease = state.read_pool_->AcquireReader();
+    if (lease) {
+      auto database = lease.Get();
+      auto res = sqlite3_exec(database, "BEGIN;", NULL, 0, NULL);
+      if (res == SQLITE_OK)
+        res = sqlite3_snapshot_open(database, "main", state.snapshot_);
+      if (res == SQLITE_OK)
+        res = RunQuery(database, sql_script, row_handler);
+      sqlite3_exec(database, "COMMIT;", NULL, 0, NULL);
+      return res;
+    }
+  }
+#endif
+
+  std::unique_lock<std::shared_mutex> lock{state.mutex_};
+  if (!state.database_)
+    return SQLITE_MISUSE;
+  return RunQuery(state.database_, sql_script, row_handler);
+}
+
+void ReadSnapshot::Release() noexcept {
+  if (!state_)
+    return;
+
+  auto &state = *state_;
+  std::unique_lock<std::shared_mutex> lock{state.mutex_};
+#ifdef SQLITE_ENABLE_SNAPSHOT
+  sqlite3_snapshot_free(state.snapshot_);
+  state.snapshot_ = nullptr;
+#endif
+  if (state.database_ && !sqlite3_get_autocommit(state.database_))
+    sqlite3_exec(state.database_, "COMMIT;", NULL, 0, NULL);
+  sqlite3_close(state.database_);
+  state.database_ = nullptr;
+}
+
+int32_t ReadSnapshot::RunQuery(sqlite3 *database, const std::string &sql_script,
+                               const RowHandler &row_handler) {
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v2(database, sql_script.c_str(), -1, &stmt, nullptr);
+  if (res != SQLITE_OK)
+    return res;
+
+  SelectCursor::Row row{stmt};
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW)
+    row_handler(row);
+  sqlite3_finalize(stmt);
+  return (res == SQLITE_DONE) ? SQLITE_OK : res;
+}
+
+} // namespace client
+} // namespace crypto_wallet
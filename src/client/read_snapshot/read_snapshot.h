@@ -0,0 +1,130 @@
+/// \file read_snapshot.h
+/// \brief Class pinning a point-in-time view of the database for reads.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_READ_SNAPSHOT_H_
+#define CRYPTO_WALLET_CLIENT_READ_SNAPSHOT_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+
+#include "connection_pool/connection_pool.h"
+#include "select_cursor/select_cursor.h"
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class ReadSnapshot read_snapshot.h.
+/// \brief Point-in-time view of a WAL database, queries see the database as it was
+/// \brief when the snapshot was pinned while the writer keeps committing.
+/// \details The snapshot owns a read-only connection holding a read transaction
+/// \details until Release. The open read transaction is what keeps the view valid:
+/// \details passive checkpoints stop at its WAL frame and RESTART or TRUNCATE ones
+/// \details cannot reset the WAL under it, so no checkpoint invalidates it early.
+/// \details With SQLITE_ENABLE_SNAPSHOT queries run in parallel on read pool
+/// \details connections opened on the same snapshot (sqlite3_snapshot_open),
+/// \details otherwise they are serialized on the pinned connection.
+class ReadSnapshot {
+ public:
+  /// \brief Row handler.
+  /// \param[in] row Current row, valid during the call only.
+  using RowHandler = std::function<void(const SelectCursor::Row &row)>;
+
+  /// \brief Queries run in parallel on the read pool.
+#ifdef SQLITE_ENABLE_SNAPSHOT
+  static constexpr bool kIsSnapshotOpenSupported = true;
+#else
+  static constexpr bool kIsSnapshotOpenSupported = false;
+#endif
+
+  /// \brief ReadSnapshot constructor of the failed snapshot.
+  /// \param[in] result Result of pinning.
+  explicit ReadSnapshot(int32_t result = SQLITE_MISUSE) noexcept;
+
+  /// \brief ReadSnapshot constructor, pins the current state of the database.
+  /// \param[in] db_name Database name or URI.
+  /// \param[in] init_script Script run on the pinned connection first.
+  /// \param[in] read_pool Read pool queries may run on, nullptr to use the pinned one.
+  ReadSnapshot(const std::string &db_name, const std::string &init_script,
+               std::shared_ptr<ConnectionPool> read_pool);
+
+  /// \brief ReadSnapshot destructor, releases the snapshot.
+  ~ReadSnapshot();
+
+  /// \brief Class ReadSnapshot move constructor.
+  /// \param[in] read_snapshot Class ReadSnapshot object.
+  ReadSnapshot(ReadSnapshot &&read_snapshot) noexcept;
+
+  /// \brief Class ReadSnapshot move assignment.
+  /// \param[in] read_snapshot Class ReadSnapshot object.
+  /// \return ReadSnapshot object.
+  ReadSnapshot &operator=(ReadSnapshot &&read_snapshot) noexcept;
+
+  /// \brief Class ReadSnapshot copy constructor.
+  /// \param[in] read_snapshot Class ReadSnapshot object.
+  ReadSnapshot(const ReadSnapshot &read_snapshot) = delete;
+
+  /// \brief Class ReadSnapshot copy assignment.
+  /// \param[in] read_snapshot Class ReadSnapshot object.
+  /// \return ReadSnapshot object.
+  ReadSnapshot &operator=(const ReadSnapshot &read_snapshot) = delete;
+
+  /// \brief Run query against the snapshot, safe to call from any thread but
+  /// \brief not concurrently with Release.
+  /// \param[in] sql_script Single SQL statement.
+  /// \param[in] row_handler Handler called for every result row.
+  /// \return SQLITE_MISUSE if the snapshot is not pinned, otherwise result of the query.
+  int32_t Query(const std::string &sql_script, const RowHandler &row_handler);
+
+  /// \brief End the read transaction, checkpoints may reset the WAL afterwards.
+  void Release() noexcept;
+
+  /// \brief Check if the snapshot is pinned.
+  /// \return Pinned state.
+  inline bool IsPinned() const noexcept { return state_ && state_->database_; }
+
+  /// \brief Get result of pinning.
+  /// \return Result of pinning.
+  inline int32_t GetResult() const noexcept { return result_; }
+
+ private:
+  /// \struct State read_snapshot.h.
+  /// \brief Pinned connection, kept at a stable address for moves.
+  struct State {
+    // shared by queries on the read pool, exclusive for the pinned connection
+    std::shared_mutex mutex_{};
+    sqlite3 *database_{nullptr};
+    // kept alive while the snapshot is pinned, the owner may replace its pool
+    std::shared_ptr<ConnectionPool> read_pool_{};
+#ifdef SQLITE_ENABLE_SNAPSHOT
+    sqlite3_snapshot *snapshot_{nullptr};
+#endif
+  };
+
+  /// \brief Step the statement and pass rows to the handler.
+  /// \param[in] database Connection.
+  /// \param[in] sql_script SQL statement.
+  /// \param[in] row_handler Row handler.
+  /// \return Result of the query.
+  static int32_t RunQuery(sqlite3 *database, const std::string &sql_script,
+                          const RowHandler &row_handler);
+
+  std::unique_ptr<State> state_{};
+  int32_t result_{SQLITE_MISUSE};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_READ_SNAPSHOT_H_
@@ -0,0 +1,213 @@
+/// \file result_cache.cpp
+/// \brief Source file containing class ResultCache methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "result_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+  // bookkeeping of one entry: list node, index node and the Result object
+  constexpr std::size_t kEntryOverhead = 128;
+
+  std::size_t GetResultBytes(const crypto_wallet::client::ResultCache::Result &result) {
+    std::size_t bytes = result.values.capacity() * sizeof(std::string);
+    for (const auto &value : result.values)
+      if (value.capacity() > sizeof(std::string) - 1)
+        bytes += value.capacity() + 1;
+    return bytes;
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+ResultCache::ResultCache(std::size_t memory_budget,
+                         std::chrono::milliseconds data_version_check_interval)
+    : memory_budget_{memory_budget}, data_version_check_interval_{data_version_check_interval} {}
+
+ResultCache::~ResultCache() {
+  if (database_)
+    sqlite3_update_hook(database_, nullptr, nullptr);
+}
+
+void ResultCache::Attach(sqlite3 *database) {
+  database_ = database;
+  sqlite3_update_hook(database_, &ResultCache::UpdateHook, this);
+  written_tables_.clear();
+  hooked_changes_ = 0;
+  committed_changes_ = sqlite3_total_changes64(database_);
+  is_committing_.store(false, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock{data_version_mutex_};
+    data_version_ = -1;
+  }
+  Clear();
+}
+
+std::shared_ptr<const ResultCache::Result> ResultCache::Find(const std::string &table_name,
+                                                             const std::string &projection) {
+  thread_local std::string key;
+  key.assign(table_name).append(1, '\x1f').append(projection);
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return it->second->result;
+}
+
+void ResultCache::Insert(const std::string &table_name, const std::string &projection,
+                         std::shared_ptr<const Result> result, uint64_t generation) {
+  Entry entry{table_name + '\x1f' + projection, table_name, std::move(result), 0};
+  entry.bytes = GetResultBytes(*entry.result) + 2 * entry.key.capacity() +
+                entry.table_name.capacity() + kEntryOverhead;
+  if (entry.bytes > memory_budget_)
+    return;
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (generation != generation_.load(std::memory_order_acquire) ||
+      is_committing_.load(std::memory_order_acquire))
+    return;
+  auto it = index_.find(entry.key);
+  if (it != index_.end())
+    Erase(it->second);
+  while (!entries_.empty() && memory_usage_ + entry.bytes > memory_budget_) {
+    Erase(std::prev(entries_.end()));
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+  memory_usage_ += entry.bytes;
+  entries_.push_front(std::move(entry));
+  index_.emplace(entries_.front().key, entries_.begin());
+}
+
+/// Rolled back changes are counted on both sides, so the comparison holds
+/// without a rollback hook; their tables are dropped with the next commit.
+void ResultCache::OnCommit() noexcept {
+  auto total_changes = sqlite3_total_changes64(database_);
+  bool is_untracked = static_cast<uint64_t>(total_changes - committed_changes_) > hooked_changes_;
+  committed_changes_ = total_changes;
+  hooked_changes_ = 0;
+  if (is_untracked) {
+    written_tables_.clear();
+    std::lock_guard<std::mutex> lock{mutex_};
+    is_committing_.store(true, std::memory_order_release);
+    ClearEntries();
+    return;
+  }
+  if (written_tables_.empty())
+    return;
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  is_committing_.store(true, std::memory_order_release);
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (std::find(written_tables_.begin(), written_tables_.end(), it->table_name) !=
+        written_tables_.end()) {
+      Erase(it);
+      invalidations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    it = next;
+  }
+  written_tables_.clear();
+}
+
+/// Select which took the generation between the commit hook and the end of the
+/// commit could read the old snapshot, the second bump rejects its result.
+void ResultCache::OnCommitted() noexcept {
+  if (!is_committing_.load(std::memory_order_acquire))
+    return;
+  std::lock_guard<std::mutex> lock{mutex_};
+  is_committing_.store(false, std::memory_order_release);
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+/// data_version changes only with commits of other connections. Statement is
+/// prepared per check, the attached connection is replaced on partition switch.
+int32_t ResultCache::CheckDataVersion(bool is_forced) {
+  if (!database_)
+    return SQLITE_MISUSE;
+
+  std::lock_guard<std::mutex> lock{data_version_mutex_};
+  auto now = std::chrono::steady_clock::now();
+  if (!is_forced && data_version_ >= 0 &&
+      now - data_version_time_ < data_version_check_interval_)
+    return SQLITE_OK;
+
+  data_version_time_ = now;
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v2(database_, "PRAGMA data_version;", -1, &stmt, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_step(stmt);
+  auto data_version = (res == SQLITE_ROW) ? sqlite3_column_int64(stmt, 0) : -1;
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_ROW)
+    return res;
+
+  if (data_version_ >= 0 && data_version != data_version_)
+    Clear();
+  data_version_ = data_version;
+  return SQLITE_OK;
+}
+
+void ResultCache::Clear() noexcept {
+  std::lock_guard<std::mutex> lock{mutex_};
+  ClearEntries();
+}
+
+ResultCache::Metrics ResultCache::GetMetrics() const {
+  Metrics metrics{};
+  metrics.hits = hits_.load(std::memory_order_relaxed);
+  metrics.misses = misses_.load(std::memory_order_relaxed);
+  metrics.invalidations = invalidations_.load(std::memory_order_relaxed);
+  metrics.evictions = evictions_.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    metrics.entries = entries_.size();
+    metrics.memory_usage = memory_usage_;
+  }
+  auto lookups = metrics.hits + metrics.misses;
+  if (lookups) {
+    metrics.hit_ratio = static_cast<double>(metrics.hits) / lookups;
+    metrics.miss_ratio = static_cast<double>(metrics.misses) / lookups;
+  }
+  return metrics;
+}
+
+void ResultCache::ClearEntries() noexcept {
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  invalidations_.fetch_add(entries_.size(), std::memory_order_relaxed);
+  entries_.clear();
+  index_.clear();
+  memory_usage_ = 0;
+}
+
+void ResultCache::Erase(std::list<Entry>::iterator it) noexcept {
+  memory_usage_ -= it->bytes;
+  index_.erase(it->key);
+  entries_.erase(it);
+}
+
+/// Called for every written row, the table is compared with the last noted one
+/// first so a bulk insert costs one strcmp per row.
+void ResultCache::UpdateHook(void *result_cache, int, const char *, const char *table_name,
+                             sqlite3_int64) {
+  auto cache = static_cast<ResultCache *>(result_cache);
+  ++cache->hooked_changes_;
+  auto &tables = cache->written_tables_;
+  if (!tables.empty() && std::strcmp(tables.back().c_str(), table_name) == 0)
+    return;
+  if (std::find(tables.begin(), tables.end(), table_name) == tables.end())
+    tables.emplace_back(table_name);
+}
+
+} // namespace client
+} // namespace crypto_wallet
@@ -0,0 +1,195 @@
+/// \file result_cache.h
+/// \brief Class caching select results until the selected table is written.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_RESULT_CACHE_H_
+#define CRYPTO_WALLET_CLIENT_RESULT_CACHE_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class ResultCache result_cache.h.
+/// \brief LRU cache of select results keyed by table and projection, bounded by
+/// \brief a memory budget.
+/// \details Update hook of the writer connection collects tables written by the
+/// \details transaction, OnCommit (called from the commit hook) drops their results.
+/// \details Commit hook runs before the commit is visible to readers, so results are
+/// \details not cached until OnCommitted, which bumps the generation once more.
+/// \details Changes the update hook does not see (DELETE without WHERE, WITHOUT
+/// \details ROWID tables) are detected by sqlite3_total_changes64 and drop all
+/// \details results. Commits of other connections are detected by polling
+/// \details PRAGMA data_version and drop all results as well.
+class ResultCache {
+ public:
+  /// \struct Result result_cache.h.
+  /// \brief Select result, rows of values read as text, NULL as empty string.
+  struct Result {
+    std::size_t columns_count{0};
+    std::vector<std::string> values{};
+
+    /// \brief Get number of rows.
+    /// \return Number of rows.
+    inline std::size_t GetRowsCount() const noexcept {
+      return columns_count ? values.size() / columns_count : 0;
+    }
+
+    /// \brief Get value.
+    /// \param[in] row Row index.
+    /// \param[in] column Column index.
+    /// \return Value.
+    inline const std::string &GetValue(std::size_t row, std::size_t column) const noexcept {
+      return values[row * columns_count + column];
+    }
+  };
+
+  /// \struct Metrics result_cache.h.
+  /// \brief Cache counters.
+  struct Metrics {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t invalidations{0};
+    uint64_t evictions{0};
+    std::size_t entries{0};
+    std::size_t memory_usage{0};
+    double hit_ratio{0.0};
+    double miss_ratio{0.0};
+  };
+
+  /// \brief ResultCache constructor.
+  /// \param[in] memory_budget Max bytes held by cached results.
+  /// \param[in] data_version_check_interval Min interval between not forced checks
+  /// \param[in] data_version_check_interval of commits made by other connections.
+  explicit ResultCache(std::size_t memory_budget,
+                       std::chrono::milliseconds data_version_check_interval =
+                           std::chrono::milliseconds{10});
+
+  /// \brief ResultCache destructor, removes the update hook.
+  ~ResultCache();
+
+  /// \brief Class ResultCache copy constructor.
+  /// \param[in] result_cache Class ResultCache object.
+  ResultCache(const ResultCache &result_cache) = delete;
+
+  /// \brief Class ResultCache copy assignment.
+  /// \param[in] result_cache Class ResultCache object.
+  /// \return ResultCache object.
+  ResultCache &operator=(const ResultCache &result_cache) = delete;
+
+  /// \brief Track writes of the connection, installs the update hook.
+  /// \details Cached results are dropped, they may belong to another database.
+  /// \details Hook of the previous connection is left, it is expected to be closed.
+  /// \param[in] database Writer connection.
+  void Attach(sqlite3 *database);
+
+  /// \brief Find cached result, found one becomes most recently used.
+  /// \param[in] table_name Table name.
+  /// \param[in] projection Selected columns.
+  /// \return Result or nullptr.
+  std::shared_ptr<const Result> Find(const std::string &table_name,
+                                     const std::string &projection);
+
+  /// \brief Get generation, taken before the select whose result is inserted.
+  /// \return Generation bumped by every invalidation.
+  inline uint64_t GetGeneration() const noexcept {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+  /// \brief Cache result, least recently used ones are evicted to fit the budget.
+  /// \details Result is dropped if cache was invalidated since the generation or a
+  /// \details commit of the attached connection is not finished yet.
+  /// \param[in] table_name Table name.
+  /// \param[in] projection Selected columns.
+  /// \param[in] result Result.
+  /// \param[in] generation Generation taken before the select.
+  void Insert(const std::string &table_name, const std::string &projection,
+              std::shared_ptr<const Result> result, uint64_t generation);
+
+  /// \brief Drop results of the tables written since the previous commit.
+  /// \details Must be called from the commit hook of the attached connection.
+  void OnCommit() noexcept;
+
+  /// \brief Finish invalidation started by OnCommit.
+  /// \details Must be called once the attached connection is back in autocommit mode,
+  /// \details results of selects which took the generation before are dropped.
+  void OnCommitted() noexcept;
+
+  /// \brief Drop all results if other connections committed since the previous check.
+  /// \param[in] is_forced Check even if the check interval has not passed yet.
+  /// \return Result of the check.
+  int32_t CheckDataVersion(bool is_forced);
+
+  /// \brief Drop all results.
+  void Clear() noexcept;
+
+  /// \brief Get cache counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const;
+
+ private:
+  /// \struct Entry result_cache.h.
+  /// \brief Cached result.
+  struct Entry {
+    std::string key{};
+    std::string table_name{};
+    std::shared_ptr<const Result> result{};
+    std::size_t bytes{0};
+  };
+
+  /// \brief Drop all entries, mutex_ is held by the caller.
+  void ClearEntries() noexcept;
+
+  /// \brief Drop entry, mutex_ is held by the caller.
+  /// \param[in] it Entry.
+  void Erase(std::list<Entry>::iterator it) noexcept;
+
+  /// \brief Update hook, notes the written table.
+  static void UpdateHook(void *result_cache, int operation, const char *db_name,
+                         const char *table_name, sqlite3_int64 rowid);
+
+  std::size_t memory_budget_;
+  sqlite3 *database_{nullptr};
+  mutable std::mutex mutex_{};
+  // most recently used first
+  std::list<Entry> entries_{};
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_{};
+  std::size_t memory_usage_{0};
+  std::atomic<uint64_t> generation_{0};
+  // set by OnCommit, cleared by OnCommitted, mutex_ is held by writers
+  std::atomic<bool> is_committing_{false};
+  std::chrono::milliseconds data_version_check_interval_;
+  // data_version_mutex_ is never taken while mutex_ is held
+  std::mutex data_version_mutex_{};
+  int64_t data_version_{-1};
+  std::chrono::steady_clock::time_point data_version_time_{};
+  // written by the hooks on the writer thread only
+  std::vector<std::string> written_tables_{};
+  uint64_t hooked_changes_{0};
+  int64_t committed_changes_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> invalidations_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_RESULT_CACHE_H_
@@ -0,0 +1,102 @@
+/// \file schema_catalog.cpp
+/// \brief Source file containing class SchemaCatalog methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "schema_catalog.h"
+
+#include <iostream>
+#include <mutex>
+
+namespace crypto_wallet {
+namespace client {
+
+void SchemaCatalog::Attach(sqlite3 *database) {
+  std::unique_lock<std::shared_mutex> lock{mutex_};
+  database_ = database;
+  tables_.clear();
+  is_stale_.store(true, std::memory_order_release);
+  sqlite3_set_authorizer(database_, Authorize, this);
+}
+
+bool SchemaCatalog::IsTableExist(const std::string &table_name) {
+  Refresh();
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  return tables_.find(table_name) != tables_.end();
+}
+
+bool SchemaCatalog::GetTableInfo(const std::string &table_name, TableInfo &table_info) {
+  Refresh();
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  auto it = tables_.find(table_name);
+  if (it == tables_.end())
+    return false;
+  table_info = it->second;
+  return true;
+}
+
+void SchemaCatalog::Invalidate() noexcept {
+  is_stale_.store(true, std::memory_order_release);
+}
+
+void SchemaCatalog::Refresh() {
+  if (!is_stale_.load(std::memory_order_acquire))
+    return;
+
+  std::unique_lock<std::shared_mutex> lock{mutex_};
+  if (!database_ || !is_stale_.exchange(false, std::memory_order_acq_rel))
+    return;
+
+  tables_.clear();
+  sqlite3_stmt *stmt{nullptr};
+  const char *columns_script = "SELECT m.name, p.name FROM sqlite_master AS m "
+                               "JOIN pragma_table_info(m.name) AS p "
+                               "WHERE m.type IN ('table', 'view') ORDER BY m.name, p.cid;";
+  if (sqlite3_prepare_v2(database_, columns_script, -1, &stmt, nullptr) == SQLITE_OK) {
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+      tables_[reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0))].columns.emplace_back(
+          reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+  } else {
+    // throw exception here
+    std::cout << "Schema catalog loading results in error: " << sqlite3_errmsg(database_)
+              << std::endl;
+    is_stale_.store(true, std::memory_order_release);
+  }
+  sqlite3_finalize(stmt);
+
+  const char *indexes_script = "SELECT tbl_name, name FROM sqlite_master WHERE type = 'index';";
+  if (sqlite3_prepare_v2(database_, indexes_script, -1, &stmt, nullptr) == SQLITE_OK) {
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+      tables_[reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0))].indexes.emplace_back(
+          reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+  }
+  sqlite3_finalize(stmt);
+  reloads_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Called while statements are prepared, so cached statements cost nothing here.
+int SchemaCatalog::Authorize(void *schema_catalog, int action, const char *, const char *,
+                             const char *, const char *) {
+  switch (action) {
+    case SQLITE_CREATE_INDEX:
+    case SQLITE_CREATE_TABLE:
+    case SQLITE_CREATE_VIEW:
+    case SQLITE_DROP_INDEX:
+    case SQLITE_DROP_TABLE:
+    case SQLITE_DROP_VIEW:
+    case SQLITE_ALTER_TABLE:
+    case SQLITE_DETACH: {
+      auto catalog = static_cast<SchemaCatalog *>(schema_catalog);
+      catalog->ddl_count_.fetch_add(1, std::memory_order_acq_rel);
+      catalog->Invalidate();
+      break;
+    }
+    default:
+      break;
+  }
+  return SQLITE_OK;
+}
+
+} // namespace client
+} // namespace crypt_wallet
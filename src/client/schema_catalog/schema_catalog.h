@@ -0,0 +1,105 @@
+/// \file schema_catalog.h
+/// \brief Class caching database schema metadata.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_SCHEMA_CATALOG_H_
+#define CRYPTO_WALLET_CLIENT_SCHEMA_CATALOG_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class SchemaCatalog schema_catalog.h.
+/// \brief In-process catalog of tables, their columns and indexes.
+/// \details Catalog is loaded from sqlite_master on first use and reloaded only
+/// \details after DDL was prepared on the connection: the authorizer installed on
+/// \details the connection marks the catalog stale. Lookups in between run no SQL.
+/// \details DDL run by other connections is not tracked.
+class SchemaCatalog {
+ public:
+  /// \struct TableInfo schema_catalog.h.
+  /// \brief Table metadata.
+  struct TableInfo {
+    std::vector<std::string> columns{};
+    std::vector<std::string> indexes{};
+  };
+
+  /// \brief SchemaCatalog constructor.
+  SchemaCatalog() = default;
+
+  /// \brief Class SchemaCatalog copy constructor.
+  /// \param[in] schema_catalog Class SchemaCatalog object.
+  SchemaCatalog(const SchemaCatalog &schema_catalog) = delete;
+
+  /// \brief Class SchemaCatalog copy assignment.
+  /// \param[in] schema_catalog Class SchemaCatalog object.
+  /// \return SchemaCatalog object.
+  SchemaCatalog &operator=(const SchemaCatalog &schema_catalog) = delete;
+
+  /// \brief Track schema of the connection, installs the authorizer.
+  /// \param[in] database Connection.
+  void Attach(sqlite3 *database);
+
+  /// \brief Check if table (or view) exists.
+  /// \param[in] table_name Table name.
+  /// \return Result of the check.
+  bool IsTableExist(const std::string &table_name);
+
+  /// \brief Get table metadata.
+  /// \param[in] table_name Table name.
+  /// \param[out] table_info Table metadata.
+  /// \return false if table does not exist.
+  bool GetTableInfo(const std::string &table_name, TableInfo &table_info);
+
+  /// \brief Mark catalog stale, it is reloaded on next lookup.
+  void Invalidate() noexcept;
+
+  /// \brief Get number of DDL statements prepared on the connection.
+  /// \details Authorizer runs on prepare, a lookup racing with the DDL step may load
+  /// \details the old schema: callers compare the counter around the DDL and
+  /// \details invalidate the catalog once more when it changed.
+  /// \return Number of DDL statements.
+  inline uint64_t GetDdlCount() const noexcept {
+    return ddl_count_.load(std::memory_order_acquire);
+  }
+
+  /// \brief Get number of catalog reloads.
+  /// \return Number of reloads.
+  inline uint64_t GetReloadsCount() const noexcept {
+    return reloads_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /// \brief Reload catalog if it is stale.
+  void Refresh();
+
+  /// \brief Authorizer callback, marks catalog stale on DDL.
+  static int Authorize(void *schema_catalog, int action, const char *arg1, const char *arg2,
+                       const char *db_name, const char *trigger_name);
+
+  sqlite3 *database_{nullptr};
+  std::unordered_map<std::string, TableInfo> tables_{};
+  std::shared_mutex mutex_{};
+  std::atomic<bool> is_stale_{true};
+  std::atomic<uint64_t> ddl_count_{0};
+  std::atomic<uint64_t> reloads_count_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_SCHEMA_CATALOG_H_
@@ -0,0 +1,169 @@
+/// \file select_cursor.cpp
+/// \brief Source file containing class SelectCursor methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "select_cursor.h"
+
+#include <iostream>
+#include <limits>
+#include <utility>
+
+#include "boost/format.hpp"
+
+namespace crypto_wallet {
+namespace client {
+
+int32_t SelectCursor::Row::GetColumnCount() const noexcept {
+  return sqlite3_column_count(stmt_) - column_offset_;
+}
+
+bool SelectCursor::Row::IsNull(int32_t column) const noexcept {
+  return sqlite3_column_type(stmt_, column + column_offset_) == SQLITE_NULL;
+}
+
+std::string_view SelectCursor::Row::GetText(int32_t column) const noexcept {
+  auto text = sqlite3_column_text(stmt_, column + column_offset_);
+  auto size = sqlite3_column_bytes(stmt_, column + column_offset_);
+  return text ? std::string_view{reinterpret_cast<const char *>(text),
+                                 static_cast<std::size_t>(size)} : std::string_view{};
+}
+
+std::string_view SelectCursor::Row::GetBlob(int32_t column) const noexcept {
+  auto blob = sqlite3_column_blob(stmt_, column + column_offset_);
+  auto size = sqlite3_column_bytes(stmt_, column + column_offset_);
+  return blob ? std::string_view{static_cast<const char *>(blob),
+                                 static_cast<std::size_t>(size)} : std::string_view{};
+}
+
+int64_t SelectCursor::Row::GetInt64(int32_t column) const noexcept {
+  return sqlite3_column_int64(stmt_, column + column_offset_);
+}
+
+double SelectCursor::Row::GetDouble(int32_t column) const noexcept {
+  return sqlite3_column_double(stmt_, column + column_offset_);
+}
+
+SelectCursor::Iterator &SelectCursor::Iterator::operator++() {
+  if (cursor_ && !cursor_->Next())
+    cursor_ = nullptr;
+  return *this;
+}
+
+/// Paged query ex: SELECT rowid, col1, ... colN FROM table_name WHERE rowid > ?1
+/// ORDER BY rowid LIMIT ?2; the rowid column is hidden from the row.
+SelectCursor::SelectCursor(sqlite3 *database, const std::string &table_name,
+                           const std::string &projection, std::size_t page_size)
+    : page_size_{page_size}, last_rowid_{std::numeric_limits<int64_t>::min()} {
+  std::string sql_script;
+  if (page_size_) {
+    std::string select_template = "SELECT rowid, %1% FROM %2% WHERE rowid > ?1 "
+                                  "ORDER BY rowid LIMIT ?2;";
+    sql_script = boost::str(boost::format{select_template} % projection % table_name);
+  } else {
+    std::string select_template = "SELECT %1% FROM %2%;";
+    sql_script = boost::str(boost::format{select_template} % projection % table_name);
+  }
+
+  result_ = sqlite3_prepare_v2(database, sql_script.c_str(),
+                               static_cast<int>(sql_script.size()) + 1, &stmt_, nullptr);
+  if (result_ != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Statement preparation results in error: " << sqlite3_errmsg(database)
+              << std::endl;
+    sqlite3_finalize(stmt_);
+    stmt_ = nullptr;
+    return;
+  }
+
+  row_ = Row{stmt_, page_size_ ? 1 : 0};
+  if (page_size_)
+    StartPage();
+}
+
+SelectCursor::SelectCursor(ConnectionPool::Lease &&lease, const std::string &table_name,
+                           const std::string &projection, std::size_t page_size)
+    : SelectCursor{lease.Get(), table_name, projection, page_size} {
+  lease_ = std::move(lease);
+  if (!stmt_)
+    lease_.Release();
+}
+
+SelectCursor::~SelectCursor() {
+  sqlite3_finalize(stmt_);
+}
+
+SelectCursor::SelectCursor(SelectCursor &&select_cursor) noexcept
+    : lease_{std::move(select_cursor.lease_)},
+      stmt_{std::exchange(select_cursor.stmt_, nullptr)}, row_{select_cursor.row_},
+      page_size_{select_cursor.page_size_}, rows_in_page_{select_cursor.rows_in_page_},
+      last_rowid_{select_cursor.last_rowid_}, rows_count_{select_cursor.rows_count_},
+      result_{select_cursor.result_}, is_started_{select_cursor.is_started_} {}
+
+SelectCursor &SelectCursor::operator=(SelectCursor &&select_cursor) noexcept {
+  if (this != &select_cursor) {
+    sqlite3_finalize(stmt_);
+    lease_ = std::move(select_cursor.lease_);
+    stmt_ = std::exchange(select_cursor.stmt_, nullptr);
+    row_ = select_cursor.row_;
+    page_size_ = select_cursor.page_size_;
+    rows_in_page_ = select_cursor.rows_in_page_;
+    last_rowid_ = select_cursor.last_rowid_;
+    rows_count_ = select_cursor.rows_count_;
+    result_ = select_cursor.result_;
+    is_started_ = select_cursor.is_started_;
+  }
+  return *this;
+}
+
+bool SelectCursor::Next() {
+  is_started_ = true;
+  if (!stmt_ || (result_ != SQLITE_OK && result_ != SQLITE_ROW))
+    return false;
+
+  result_ = sqlite3_step(stmt_);
+  // page exhausted, next one starts after the last fetched rowid
+  if (result_ == SQLITE_DONE && page_size_ && rows_in_page_ == page_size_) {
+    StartPage();
+    result_ = sqlite3_step(stmt_);
+  }
+
+  if (result_ == SQLITE_ROW) {
+    ++rows_count_;
+    if (page_size_) {
+      ++rows_in_page_;
+      last_rowid_ = sqlite3_column_int64(stmt_, 0);
+    }
+    return true;
+  }
+
+  if (result_ == SQLITE_DONE) {
+    result_ = SQLITE_OK;
+  } else {
+    // throw exception here
+    std::cout << "Statement evaluation results in error: "
+              << sqlite3_errmsg(sqlite3_db_handle(stmt_)) << std::endl;
+  }
+  // release read transaction right away, not when the cursor goes away
+  sqlite3_finalize(stmt_);
+  stmt_ = nullptr;
+  lease_.Release();
+  return false;
+}
+
+SelectCursor::Iterator SelectCursor::begin() {
+  if (!is_started_)
+    Next();
+  return (result_ == SQLITE_ROW) ? Iterator{this} : Iterator{};
+}
+
+void SelectCursor::StartPage() {
+  sqlite3_reset(stmt_);
+  sqlite3_bind_int64(stmt_, 1, last_rowid_);
+  sqlite3_bind_int64(stmt_, 2, static_cast<sqlite3_int64>(page_size_));
+  rows_in_page_ = 0;
+}
+
+} // namespace client
+} // namespace crypt_wallet
@@ -0,0 +1,195 @@
+/// \file select_cursor.h
+/// \brief Class streaming rows of the select query.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_SELECT_CURSOR_H_
+#define CRYPTO_WALLET_CLIENT_SELECT_CURSOR_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "connection_pool/connection_pool.h"
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class SelectCursor select_cursor.h.
+/// \brief Class streaming rows of the select query with sqlite3_step.
+/// \details Column values are views into SQLite buffers, they stay valid
+/// \details until the cursor moves to the next row. With non-zero page size the
+/// \details rows are fetched in rowid order page by page, the read transaction is
+/// \details released between pages (tables WITHOUT ROWID are not supported then).
+class SelectCursor {
+ public:
+  /// \class Row select_cursor.h.
+  /// \brief Current row of the cursor.
+  class Row {
+   public:
+    /// \brief Row constructor.
+    /// \param[in] stmt Statement positioned on the row.
+    /// \param[in] column_offset Number of leading service columns.
+    explicit Row(sqlite3_stmt *stmt = nullptr, int32_t column_offset = 0)
+        : stmt_{stmt}, column_offset_{column_offset} {}
+
+    /// \brief Get number of columns.
+    /// \return Number of columns.
+    int32_t GetColumnCount() const noexcept;
+
+    /// \brief Check if column value is NULL.
+    /// \param[in] column Column index.
+    /// \return Result of the check.
+    bool IsNull(int32_t column) const noexcept;
+
+    /// \brief Get column value as text.
+    /// \param[in] column Column index.
+    /// \return View into the SQLite buffer.
+    std::string_view GetText(int32_t column) const noexcept;
+
+    /// \brief Get column value as blob.
+    /// \param[in] column Column index.
+    /// \return View into the SQLite buffer.
+    std::string_view GetBlob(int32_t column) const noexcept;
+
+    /// \brief Get column value as integer.
+    /// \param[in] column Column index.
+    /// \return Column value.
+    int64_t GetInt64(int32_t column) const noexcept;
+
+    /// \brief Get column value as floating point number.
+    /// \param[in] column Column index.
+    /// \return Column value.
+    double GetDouble(int32_t column) const noexcept;
+
+   private:
+    sqlite3_stmt *stmt_{nullptr};
+    int32_t column_offset_{0};
+  };
+
+  /// \class Iterator select_cursor.h.
+  /// \brief Single pass iterator over cursor rows.
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Row;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Row *;
+    using reference = const Row &;
+
+    /// \brief Iterator constructor.
+    /// \param[in] cursor Cursor, nullptr for the end iterator.
+    explicit Iterator(SelectCursor *cursor = nullptr) : cursor_{cursor} {}
+
+    reference operator*() const noexcept { return cursor_->GetRow(); }
+    pointer operator->() const noexcept { return &cursor_->GetRow(); }
+    Iterator &operator++();
+    bool operator==(const Iterator &other) const noexcept { return cursor_ == other.cursor_; }
+    bool operator!=(const Iterator &other) const noexcept { return cursor_ != other.cursor_; }
+
+   private:
+    SelectCursor *cursor_{nullptr};
+  };
+
+  /// \brief SelectCursor constructor.
+  /// \param[in] database Database connection.
+  /// \param[in] table_name Table name.
+  /// \param[in] projection Comma separated list of columns.
+  /// \param[in] page_size Number of rows per page, 0 to fetch in a single pass.
+  SelectCursor(sqlite3 *database, const std::string &table_name, const std::string &projection,
+               std::size_t page_size = 0);
+
+  /// \brief SelectCursor constructor for the query run on a leased connection.
+  /// \param[in] lease Leased connection, held until all rows are fetched.
+  /// \param[in] table_name Table name.
+  /// \param[in] projection Comma separated list of columns.
+  /// \param[in] page_size Number of rows per page, 0 to fetch in a single pass.
+  SelectCursor(ConnectionPool::Lease &&lease, const std::string &table_name,
+               const std::string &projection, std::size_t page_size = 0);
+
+  /// \brief SelectCursor constructor for the cursor failed to be opened.
+  /// \param[in] result Result of opening the cursor.
+  explicit SelectCursor(int32_t result) : result_{result} {}
+
+  /// \brief SelectCursor destructor.
+  ~SelectCursor();
+
+  /// \brief Class SelectCursor move constructor.
+  /// \param[in] select_cursor Class SelectCursor object.
+  SelectCursor(SelectCursor &&select_cursor) noexcept;
+
+  /// \brief Class SelectCursor move assignment.
+  /// \param[in] select_cursor Class SelectCursor object.
+  /// \return SelectCursor object.
+  SelectCursor &operator=(SelectCursor &&select_cursor) noexcept;
+
+  /// \brief Class SelectCursor copy constructor.
+  /// \param[in] select_cursor Class SelectCursor object.
+  SelectCursor(const SelectCursor &select_cursor) = delete;
+
+  /// \brief Class SelectCursor copy assignment.
+  /// \param[in] select_cursor Class SelectCursor object.
+  /// \return SelectCursor object.
+  SelectCursor &operator=(const SelectCursor &select_cursor) = delete;
+
+  /// \brief Move cursor to the next row.
+  /// \return true if cursor is positioned on a row.
+  bool Next();
+
+  /// \brief Get current row.
+  /// \return Current row.
+  inline const Row &GetRow() const noexcept {
+    return row_;
+  }
+
+  /// \brief Get result of the query.
+  /// \return SQLITE_ROW while rows are fetched, SQLITE_OK once all rows were fetched,
+  /// \return error code otherwise.
+  inline int32_t GetResult() const noexcept {
+    return result_;
+  }
+
+  /// \brief Get number of rows fetched so far.
+  /// \return Number of rows.
+  inline uint64_t GetRowsCount() const noexcept {
+    return rows_count_;
+  }
+
+  /// \brief Get iterator positioned on the first row.
+  /// \return Iterator.
+  Iterator begin();
+
+  /// \brief Get end iterator.
+  /// \return Iterator.
+  inline Iterator end() noexcept {
+    return Iterator{};
+  }
+
+ private:
+  /// \brief Bind page boundary and rewind the statement.
+  void StartPage();
+
+  ConnectionPool::Lease lease_{};
+  sqlite3_stmt *stmt_{nullptr};
+  Row row_{};
+  std::size_t page_size_{0};
+  std::size_t rows_in_page_{0};
+  int64_t last_rowid_{0};
+  uint64_t rows_count_{0};
+  int32_t result_{SQLITE_OK};
+  bool is_started_{false};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_SELECT_CURSOR_H_
@@ -0,0 +1,396 @@
+/// \file sharded_store.cpp
+/// \brief Source file containing class ShardedStore methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "sharded_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "index_manager/index_manager.h"
+#include "mpsc_queue/mpsc_queue.h"
+
+namespace {
+  // rows of one scan batch handed from a shard scanner to the merging thread
+  constexpr std::size_t kScanBatchRows{1024};
+  // attempts left for a failing batch once the store is closed
+  constexpr uint32_t kCloseRetries{8};
+
+  // errors of the row itself, writing the batch again would not help
+  bool IsRowError(int32_t res) {
+    auto primary = res & 0xff;
+    return primary == SQLITE_CONSTRAINT || primary == SQLITE_MISMATCH ||
+           primary == SQLITE_TOOBIG || primary == SQLITE_RANGE;
+  }
+
+  template <typename T>
+  void PushWithBackoff(crypto_wallet::client::MpscQueue<T> &queue, T &&value) {
+    for (uint32_t attempt = 0; !queue.TryPush(std::move(value)); ++attempt)
+      if (attempt >= 64)
+        std::this_thread::yield();
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+struct ShardedStore::Shard {
+  explicit Shard(std::size_t queue_capacity) : queue_{queue_capacity} {}
+
+  std::string db_name_{};
+  sqlite3 *writer_{nullptr};
+  sqlite3_stmt *insert_stmt_{nullptr};
+  MpscQueue<std::vector<std::string>> queue_;
+  std::thread thread_{};
+  // reader_mutex_ guards reader_ and lookup_stmt_, lookups and scans share them
+  std::mutex reader_mutex_{};
+  sqlite3 *reader_{nullptr};
+  sqlite3_stmt *lookup_stmt_{nullptr};
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> failed_{0};
+  std::atomic<uint64_t> transactions_{0};
+  std::atomic<uint64_t> retried_transactions_{0};
+};
+
+ShardedStore::ShardedStore(const std::string &db_name, const std::string &table_name,
+                           const std::vector<std::string> &columns, std::size_t key_column,
+                           const Options &options)
+    : db_name_{db_name}, table_name_{table_name}, columns_{columns}, key_column_{key_column},
+      options_{options} {
+  options_.shards_count = std::max<std::size_t>(options_.shards_count, 1);
+  options_.rows_per_transaction = std::max<std::size_t>(options_.rows_per_transaction, 1);
+}
+
+ShardedStore::~ShardedStore() {
+  Close();
+}
+
+int32_t ShardedStore::Open() {
+  if (!shards_.empty() || key_column_ >= columns_.size())
+    return SQLITE_MISUSE;
+
+  for (std::size_t i = 0; i < options_.shards_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>(options_.queue_capacity));
+    auto res = OpenShard(i);
+    if (res != SQLITE_OK) {
+      Close();
+      return res;
+    }
+  }
+
+  is_running_.store(true, std::memory_order_release);
+  for (auto &shard : shards_)
+    shard->thread_ = std::thread{&ShardedStore::RunWriter, this, std::ref(*shard)};
+  return SQLITE_OK;
+}
+
+int32_t ShardedStore::OpenShard(std::size_t shard_idx) {
+  auto &shard = *shards_[shard_idx];
+  shard.db_name_ = GetShardName(shard_idx);
+  auto res = sqlite3_open_v2(shard.db_name_.c_str(), &shard.writer_,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                             nullptr);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "shard " << shard.db_name_ << " was not opened: "
+              << sqlite3_errmsg(shard.writer_) << std::endl;
+    return res;
+  }
+  sqlite3_busy_timeout(shard.writer_, 1000);
+
+  std::string column_list;
+  std::string placeholders;
+  for (const auto &column : columns_) {
+    column_list += (column_list.empty() ? "" : ", ") + column;
+    placeholders += placeholders.empty() ? "?" : ", ?";
+  }
+  const auto &key = columns_[key_column_];
+  auto script = options_.storage_profile.GetWriterScript(false) +
+                "CREATE TABLE IF NOT EXISTS " + table_name_ + " (" + column_list + ");" +
+                "CREATE INDEX IF NOT EXISTS " + IndexManager::GetIndexName(table_name_, {key}) +
+                " ON " + table_name_ + " (" + key + ");";
+  char *errMsg{nullptr};
+  res = sqlite3_exec(shard.writer_, script.c_str(), NULL, 0, &errMsg);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "shard " << shard.db_name_ << " init script results in error: "
+              << (errMsg ? errMsg : "") << std::endl;
+    sqlite3_free(errMsg);
+    return res;
+  }
+
+  res = sqlite3_prepare_v3(shard.writer_,
+                           ("INSERT INTO " + table_name_ + " (" + column_list + ") VALUES (" +
+                            placeholders + ");").c_str(),
+                           -1, SQLITE_PREPARE_PERSISTENT, &shard.insert_stmt_, nullptr);
+  if (res != SQLITE_OK)
+    return res;
+
+  // reader opens after the writer switched journal mode, so WAL readers never block it
+  res = sqlite3_open_v2(shard.db_name_.c_str(), &shard.reader_,
+                        SQLITE_OPEN_READONLY | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX, nullptr);
+  if (res != SQLITE_OK)
+    return res;
+  sqlite3_busy_timeout(shard.reader_, 1000);
+  sqlite3_exec(shard.reader_, options_.storage_profile.GetReaderScript().c_str(), NULL, 0,
+               NULL);
+  return sqlite3_prepare_v3(shard.reader_,
+                            ("SELECT " + column_list + " FROM " + table_name_ + " WHERE " + key +
+                             " = ?;").c_str(),
+                            -1, SQLITE_PREPARE_PERSISTENT, &shard.lookup_stmt_, nullptr);
+}
+
+void ShardedStore::Close() {
+  is_running_.store(false, std::memory_order_release);
+  for (auto &shard : shards_) {
+    if (shard->thread_.joinable())
+      shard->thread_.join();
+    sqlite3_finalize(shard->insert_stmt_);
+    sqlite3_finalize(shard->lookup_stmt_);
+    sqlite3_close(shard->reader_);
+    sqlite3_close(shard->writer_);
+  }
+  shards_.clear();
+}
+
+int32_t ShardedStore::Insert(std::vector<std::string> &&row) {
+  if (row.size() != columns_.size())
+    return SQLITE_MISMATCH;
+
+  pushing_count_.fetch_add(1, std::memory_order_acq_rel);
+  if (!is_running_.load(std::memory_order_acquire)) {
+    pushing_count_.fetch_sub(1, std::memory_order_acq_rel);
+    return SQLITE_MISUSE;
+  }
+  auto &shard = *shards_[GetShard(row[key_column_])];
+  shard.enqueued_.fetch_add(1, std::memory_order_relaxed);
+  PushWithBackoff(shard.queue_, std::move(row));
+  pushing_count_.fetch_sub(1, std::memory_order_acq_rel);
+  return SQLITE_OK;
+}
+
+int32_t ShardedStore::Flush() {
+  for (auto &shard : shards_) {
+    auto target = shard->enqueued_.load(std::memory_order_acquire);
+    while (shard->written_.load(std::memory_order_acquire) +
+               shard->failed_.load(std::memory_order_acquire) < target)
+      std::this_thread::sleep_for(std::chrono::microseconds{100});
+  }
+
+  uint64_t failed_rows{0};
+  for (auto &shard : shards_)
+    failed_rows += shard->failed_.load(std::memory_order_relaxed);
+  bool is_failed = failed_rows != reported_failed_rows_;
+  reported_failed_rows_ = failed_rows;
+  return is_failed ? SQLITE_ERROR : SQLITE_OK;
+}
+
+int32_t ShardedStore::Select(std::string_view key, std::vector<std::vector<std::string>> &rows) {
+  rows.clear();
+  if (shards_.empty())
+    return SQLITE_MISUSE;
+
+  auto &shard = *shards_[GetShard(key)];
+  std::lock_guard<std::mutex> lock{shard.reader_mutex_};
+  auto stmt = shard.lookup_stmt_;
+  sqlite3_bind_text(stmt, 1, key.data(), static_cast<int>(key.size()), SQLITE_STATIC);
+  int32_t res{SQLITE_OK};
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW) {
+    auto &row = rows.emplace_back(columns_.size());
+    for (std::size_t i = 0; i < row.size(); ++i) {
+      auto text = sqlite3_column_text(stmt, static_cast<int>(i));
+      if (text)
+        row[i].assign(reinterpret_cast<const char *>(text),
+                      static_cast<std::size_t>(sqlite3_column_bytes(stmt, static_cast<int>(i))));
+    }
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  return res == SQLITE_DONE ? SQLITE_OK : res;
+}
+
+/// Every shard is read by its own thread into batches, the calling thread is the
+/// single consumer of the batch queue, so the handler needs no synchronization.
+int32_t ShardedStore::Scan(const RowHandler &row_handler) {
+  if (shards_.empty())
+    return SQLITE_MISUSE;
+
+  const auto columns_count = columns_.size();
+  std::string sql{"SELECT "};
+  for (std::size_t i = 0; i < columns_count; ++i)
+    sql += (i ? ", " : "") + columns_[i];
+  sql += " FROM " + table_name_ + ";";
+
+  MpscQueue<std::vector<std::string>> batches{shards_.size() * 4};
+  std::atomic<std::size_t> done_count{0};
+  std::atomic<int32_t> scan_res{SQLITE_OK};
+  std::vector<std::thread> scanners;
+  for (auto &shard_ptr : shards_) {
+    scanners.emplace_back([&, shard = shard_ptr.get()]() {
+      std::lock_guard<std::mutex> lock{shard->reader_mutex_};
+      sqlite3_stmt *stmt{nullptr};
+      auto res = sqlite3_prepare_v2(shard->reader_, sql.c_str(), -1, &stmt, nullptr);
+      std::vector<std::string> batch;
+      while (res == SQLITE_OK && (res = sqlite3_step(stmt)) == SQLITE_ROW) {
+        for (std::size_t i = 0; i < columns_count; ++i) {
+          auto text = sqlite3_column_text(stmt, static_cast<int>(i));
+          batch.emplace_back(text ? reinterpret_cast<const char *>(text) : "",
+                             static_cast<std::size_t>(
+                                 sqlite3_column_bytes(stmt, static_cast<int>(i))));
+        }
+        if (batch.size() == kScanBatchRows * columns_count) {
+          PushWithBackoff(batches, std::move(batch));
+          batch = std::vector<std::string>{};
+          batch.reserve(kScanBatchRows * columns_count);
+        }
+        res = SQLITE_OK;
+      }
+      sqlite3_finalize(stmt);
+      if (!batch.empty())
+        PushWithBackoff(batches, std::move(batch));
+      if (res != SQLITE_DONE) {
+        int32_t expected{SQLITE_OK};
+        scan_res.compare_exchange_strong(expected, res);
+      }
+      done_count.fetch_add(1, std::memory_order_release);
+    });
+  }
+
+  std::vector<std::string> batch;
+  uint32_t idle_rounds{0};
+  while (true) {
+    if (!batches.TryPop(batch)) {
+      bool is_done = done_count.load(std::memory_order_acquire) == shards_.size();
+      if (is_done && !batches.TryPop(batch))
+        break;
+      if (!is_done) {
+        idle_rounds = std::min<uint32_t>(idle_rounds + 1, 10);
+        std::this_thread::sleep_for(std::chrono::microseconds{1 << idle_rounds});
+        continue;
+      }
+    }
+    idle_rounds = 0;
+    for (std::size_t pos = 0; pos < batch.size(); pos += columns_count)
+      row_handler(&batch[pos], columns_count);
+  }
+
+  for (auto &scanner : scanners)
+    scanner.join();
+  return scan_res.load();
+}
+
+/// FNV-1a keeps routing stable across builds, std::hash gives no such promise.
+std::size_t ShardedStore::GetShard(std::string_view key) const noexcept {
+  uint64_t hash{14695981039346656037ULL};
+  for (auto ch : key) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<std::size_t>(hash % options_.shards_count);
+}
+
+std::string ShardedStore::GetShardName(std::size_t shard) const {
+  return db_name_ + "_shard" + std::to_string(shard);
+}
+
+ShardedStore::Metrics ShardedStore::GetMetrics() const {
+  Metrics metrics{};
+  for (const auto &shard : shards_) {
+    metrics.enqueued_rows += shard->enqueued_.load(std::memory_order_relaxed);
+    metrics.failed_rows += shard->failed_.load(std::memory_order_relaxed);
+    metrics.transactions += shard->transactions_.load(std::memory_order_relaxed);
+    metrics.retried_transactions +=
+        shard->retried_transactions_.load(std::memory_order_relaxed);
+    metrics.shard_rows.push_back(shard->written_.load(std::memory_order_relaxed));
+    metrics.written_rows += metrics.shard_rows.back();
+  }
+  return metrics;
+}
+
+/// Rows available right away are grouped into one transaction, the writer backs
+/// off while the queue is empty. Batch which fails to commit is written again
+/// after a pause until it succeeds, once the store is closed it gets a few more
+/// attempts before its rows are counted as failed.
+void ShardedStore::RunWriter(Shard &shard) {
+  std::vector<std::string> row;
+  std::vector<std::vector<std::string>> batch;
+  uint32_t idle_rounds{0};
+  while (true) {
+    if (!shard.queue_.TryPop(row)) {
+      bool is_stopped = !is_running_.load(std::memory_order_acquire) &&
+                        pushing_count_.load(std::memory_order_acquire) == 0;
+      if (is_stopped && !shard.queue_.TryPop(row))
+        break;
+      if (!is_stopped) {
+        idle_rounds = std::min<uint32_t>(idle_rounds + 1, 10);
+        std::this_thread::sleep_for(std::chrono::microseconds{1 << idle_rounds});
+        continue;
+      }
+    }
+    idle_rounds = 0;
+
+    batch.clear();
+    do
+      batch.push_back(std::move(row));
+    while (batch.size() < options_.rows_per_transaction && shard.queue_.TryPop(row));
+
+    for (uint32_t attempt = 1; ; ++attempt) {
+      uint64_t batch_failed{0};
+      if (WriteBatch(shard, batch, batch_failed) == SQLITE_OK) {
+        shard.failed_.fetch_add(batch_failed, std::memory_order_release);
+        shard.written_.fetch_add(batch.size() - batch_failed, std::memory_order_release);
+        break;
+      }
+      if (!is_running_.load(std::memory_order_acquire) && attempt >= kCloseRetries) {
+        shard.failed_.fetch_add(batch.size(), std::memory_order_release);
+        break;
+      }
+      shard.retried_transactions_.fetch_add(1, std::memory_order_relaxed);
+      std::this_thread::sleep_for(std::chrono::milliseconds{1 << std::min<uint32_t>(attempt, 10)});
+    }
+    shard.transactions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/// Rows rejected by constraints are skipped, any other error rolls the whole
+/// batch back so it can be written again.
+int32_t ShardedStore::WriteBatch(Shard &shard,
+                                 const std::vector<std::vector<std::string>> &batch,
+                                 uint64_t &failed_count) {
+  failed_count = 0;
+  auto res = sqlite3_exec(shard.writer_, "BEGIN IMMEDIATE;", NULL, 0, NULL);
+  auto stmt = shard.insert_stmt_;
+  for (std::size_t row_idx = 0; res == SQLITE_OK && row_idx < batch.size(); ++row_idx) {
+    const auto &row = batch[row_idx];
+    for (std::size_t i = 0; i < row.size(); ++i)
+      sqlite3_bind_text(stmt, static_cast<int>(i + 1), row[i].data(),
+                        static_cast<int>(row[i].size()), SQLITE_STATIC);
+    res = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    if (res == SQLITE_DONE || IsRowError(res)) {
+      failed_count += (res != SQLITE_DONE);
+      res = SQLITE_OK;
+    }
+  }
+  if (res == SQLITE_OK)
+    res = sqlite3_exec(shard.writer_, "COMMIT;", NULL, 0, NULL);
+
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "shard " << shard.db_name_ << " batch results in error: "
+              << sqlite3_errmsg(shard.writer_) << std::endl;
+    if (!sqlite3_get_autocommit(shard.writer_))
+      sqlite3_exec(shard.writer_, "ROLLBACK;", NULL, 0, NULL);
+  }
+  return res;
+}
+
+} // namespace client
+} // namespace crypto_wallet
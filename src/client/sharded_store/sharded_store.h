@@ -0,0 +1,167 @@
+/// \file sharded_store.h
+/// \brief Class splitting a table across database files by hash of a key column.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_SHARDED_STORE_H_
+#define CRYPTO_WALLET_CLIENT_SHARDED_STORE_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "storage_profile/storage_profile.h"
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class ShardedStore sharded_store.h.
+/// \brief Class writing one logical table into several database files, so every
+/// \brief file has its own writer thread and ingest is not capped by a single writer.
+/// \details Row goes to shard FNV-1a(key) % shards_count, shard files are named
+/// \details <db_name>_shard<N>, so shard count must stay the same for existing files.
+/// \details Every shard has a writer thread fed by a lock-free queue and a reader
+/// \details connection used by lookups and scans.
+class ShardedStore {
+ public:
+  /// \struct Options sharded_store.h.
+  /// \brief Sharding options.
+  struct Options {
+    std::size_t shards_count{4};
+    // rows queued per shard before producers are pushed back
+    std::size_t queue_capacity{65536};
+    // rows written in one shard transaction
+    std::size_t rows_per_transaction{10000};
+    StorageProfile storage_profile{StorageProfile::BalancedOltp()};
+  };
+
+  /// \struct Metrics sharded_store.h.
+  /// \brief Sharding counters.
+  struct Metrics {
+    uint64_t enqueued_rows{0};
+    uint64_t written_rows{0};
+    uint64_t failed_rows{0};
+    uint64_t transactions{0};
+    uint64_t retried_transactions{0};
+    // written rows of every shard, shows how even the key distribution is
+    std::vector<uint64_t> shard_rows{};
+  };
+
+  /// \brief Scan row handler, called on the scanning thread only.
+  /// \param[in] values Row values, NULL is read as empty string.
+  /// \param[in] columns_count Number of values.
+  using RowHandler = std::function<void(const std::string *values, std::size_t columns_count)>;
+
+  /// \brief ShardedStore constructor.
+  /// \param[in] db_name Shard file name prefix.
+  /// \param[in] table_name Table name.
+  /// \param[in] columns Table columns.
+  /// \param[in] key_column Index of the column rows are routed by.
+  /// \param[in] options Sharding options.
+  ShardedStore(const std::string &db_name, const std::string &table_name,
+               const std::vector<std::string> &columns, std::size_t key_column,
+               const Options &options);
+
+  /// \brief ShardedStore destructor, writes queued rows and closes the shards.
+  ~ShardedStore();
+
+  /// \brief Class ShardedStore copy constructor.
+  /// \param[in] sharded_store Class ShardedStore object.
+  ShardedStore(const ShardedStore &sharded_store) = delete;
+
+  /// \brief Class ShardedStore copy assignment.
+  /// \param[in] sharded_store Class ShardedStore object.
+  /// \return ShardedStore object.
+  ShardedStore &operator=(const ShardedStore &sharded_store) = delete;
+
+  /// \brief Open shard files, create the table with key index and start writers.
+  /// \return SQLITE_MISUSE if already open or key column is out of range,
+  /// \return otherwise result of opening.
+  int32_t Open();
+
+  /// \brief Write queued rows and stop the writers.
+  void Close();
+
+  /// \brief Queue row to its shard, safe to call from any thread.
+  /// \details Producer spins, then yields, while the shard queue is full.
+  /// \param[in] row Row values.
+  /// \return SQLITE_MISUSE if not open, SQLITE_MISMATCH on wrong number of values,
+  /// \return otherwise SQLITE_OK.
+  int32_t Insert(std::vector<std::string> &&row);
+
+  /// \brief Wait until every row queued before the call is committed or failed.
+  /// \return SQLITE_ERROR if any row failed since the previous Flush, otherwise SQLITE_OK.
+  int32_t Flush();
+
+  /// \brief Get rows with the key, only the key shard is queried.
+  /// \param[in] key Key value.
+  /// \param[out] rows Rows found, committed ones only.
+  /// \return SQLITE_MISUSE if not open, otherwise result of the lookup.
+  int32_t Select(std::string_view key, std::vector<std::vector<std::string>> &rows);
+
+  /// \brief Scan all shards in parallel, rows are merged to the calling thread.
+  /// \details Rows come in no particular order, each shard is read in one transaction.
+  /// \param[in] row_handler Handler called for every row.
+  /// \return SQLITE_MISUSE if not open, otherwise first failed shard scan result.
+  int32_t Scan(const RowHandler &row_handler);
+
+  /// \brief Get shard of the key.
+  /// \param[in] key Key value.
+  /// \return Shard index.
+  std::size_t GetShard(std::string_view key) const noexcept;
+
+  /// \brief Get shard file name.
+  /// \param[in] shard Shard index.
+  /// \return Shard file name.
+  std::string GetShardName(std::size_t shard) const;
+
+  /// \brief Get sharding counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const;
+
+ private:
+  struct Shard;
+
+  /// \brief Write loop of the shard writer thread.
+  /// \param[in] shard Shard.
+  void RunWriter(Shard &shard);
+
+  /// \brief Write rows into the shard in one transaction.
+  /// \param[in] shard Shard.
+  /// \param[in] batch Rows.
+  /// \param[out] failed_count Number of rows rejected by the database.
+  /// \return SQLITE_OK if committed, otherwise the batch is rolled back.
+  int32_t WriteBatch(Shard &shard, const std::vector<std::vector<std::string>> &batch,
+                     uint64_t &failed_count);
+
+  /// \brief Open connections of the shard and create its table.
+  /// \param[in] shard_idx Shard index.
+  /// \return Result of opening.
+  int32_t OpenShard(std::size_t shard_idx);
+
+  std::string db_name_;
+  std::string table_name_;
+  std::vector<std::string> columns_;
+  std::size_t key_column_;
+  Options options_;
+  std::vector<std::unique_ptr<Shard>> shards_{};
+  std::atomic<bool> is_running_{false};
+  std::atomic<uint32_t> pushing_count_{0};
+  uint64_t reported_failed_rows_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_SHARDED_STORE_H_
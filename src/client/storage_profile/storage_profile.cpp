@@ -0,0 +1,230 @@
+/// \file storage_profile.cpp
+/// \brief Source file containing class StorageProfile methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "storage_profile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+  const uint64_t kRowsPerBatch{1000};
+
+  void remove_database_files(const std::string &db_path) {
+    std::remove(db_path.c_str());
+    std::remove((db_path + "-journal").c_str());
+    std::remove((db_path + "-wal").c_str());
+    std::remove((db_path + "-shm").c_str());
+  }
+
+  int32_t run_workload(sqlite3 *database, const std::vector<std::string> &columns,
+                       uint64_t sample_rows) {
+    std::string create{"CREATE TABLE autotune ("};
+    std::string insert{"INSERT INTO autotune VALUES ("};
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      create += (i ? ", " : "") + columns[i];
+      insert += (i ? ", ?" : "?") + std::to_string(i + 1);
+    }
+    create += ");";
+    insert += ");";
+    auto res = sqlite3_exec(database, create.c_str(), nullptr, nullptr, nullptr);
+    if (res != SQLITE_OK)
+      return res;
+
+    sqlite3_stmt *stmt{nullptr};
+    res = sqlite3_prepare_v2(database, insert.c_str(), -1, &stmt, nullptr);
+    if (res != SQLITE_OK)
+      return res;
+
+    // 1% of rows are committed one by one, the rest goes in batches
+    const uint64_t single_rows = sample_rows / 100;
+    std::string value;
+    for (uint64_t row = 0; row < sample_rows && res == SQLITE_OK; ++row) {
+      const bool is_batch_start = row >= single_rows && (row - single_rows) % kRowsPerBatch == 0;
+      if (is_batch_start) {
+        if (row > single_rows)
+          res = sqlite3_exec(database, "COMMIT;", nullptr, nullptr, nullptr);
+        if (res == SQLITE_OK)
+          res = sqlite3_exec(database, "BEGIN;", nullptr, nullptr, nullptr);
+      }
+      for (std::size_t i = 0; i < columns.size() && res == SQLITE_OK; ++i) {
+        value = "address_" + std::to_string(row * columns.size() + i);
+        res = sqlite3_bind_text(stmt, static_cast<int>(i + 1), value.data(),
+                                static_cast<int>(value.size()), SQLITE_TRANSIENT);
+      }
+      if (res == SQLITE_OK) {
+        res = sqlite3_step(stmt);
+        res = (res == SQLITE_DONE) ? SQLITE_OK : res;
+      }
+      sqlite3_reset(stmt);
+    }
+    if (res == SQLITE_OK && sample_rows > single_rows)
+      res = sqlite3_exec(database, "COMMIT;", nullptr, nullptr, nullptr);
+    sqlite3_finalize(stmt);
+    if (res != SQLITE_OK)
+      return res;
+
+    res = sqlite3_prepare_v2(database, "SELECT * FROM autotune;", -1, &stmt, nullptr);
+    if (res != SQLITE_OK)
+      return res;
+    while ((res = sqlite3_step(stmt)) == SQLITE_ROW)
+      sqlite3_column_text(stmt, 0);
+    sqlite3_finalize(stmt);
+    return (res == SQLITE_DONE) ? SQLITE_OK : res;
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+StorageProfile StorageProfile::BulkLoad() {
+  StorageProfile profile;
+  profile.name = "bulk-load";
+  profile.journal_mode = "WAL";
+  profile.synchronous = "OFF";
+  profile.cache_size = -262144;
+  profile.mmap_size = 268435456;
+  profile.temp_store = "MEMORY";
+  profile.page_size = 16384;
+  profile.wal_autocheckpoint = 10000;
+  return profile;
+}
+
+StorageProfile StorageProfile::BalancedOltp() {
+  StorageProfile profile;
+  profile.name = "balanced-oltp";
+  profile.journal_mode = "WAL";
+  profile.synchronous = "NORMAL";
+  profile.cache_size = -65536;
+  profile.mmap_size = 67108864;
+  profile.temp_store = "MEMORY";
+  profile.page_size = 4096;
+  profile.wal_autocheckpoint = 1000;
+  return profile;
+}
+
+StorageProfile StorageProfile::ReadMostly() {
+  StorageProfile profile;
+  profile.name = "read-mostly";
+  profile.journal_mode = "WAL";
+  profile.synchronous = "NORMAL";
+  profile.cache_size = -131072;
+  profile.mmap_size = 1073741824;
+  profile.temp_store = "MEMORY";
+  profile.page_size = 4096;
+  profile.wal_autocheckpoint = 1000;
+  return profile;
+}
+
+StorageProfile StorageProfile::Durable() {
+  StorageProfile profile;
+  profile.name = "durable";
+  profile.journal_mode = "WAL";
+  profile.synchronous = "FULL";
+  profile.cache_size = -16384;
+  profile.mmap_size = 0;
+  profile.temp_store = "DEFAULT";
+  profile.page_size = 4096;
+  profile.wal_autocheckpoint = 1000;
+  return profile;
+}
+
+std::vector<StorageProfile> StorageProfile::GetProfiles() {
+  return {BulkLoad(), BalancedOltp(), ReadMostly(), Durable()};
+}
+
+bool StorageProfile::FindProfile(const std::string &profile_name, StorageProfile &profile) {
+  for (auto &candidate : GetProfiles()) {
+    if (candidate.name == profile_name) {
+      profile = std::move(candidate);
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Pragma values are matched as the profiles spell them, names or numbers.
+int32_t StorageProfile::GetDurabilityLevel() const noexcept {
+  // crash in the middle of the transaction may corrupt the database without a journal
+  if (journal_mode == "OFF" || journal_mode == "MEMORY")
+    return 0;
+  if (synchronous == "EXTRA" || synchronous == "3")
+    return 3;
+  if (synchronous == "FULL" || synchronous == "2")
+    return 2;
+  if (synchronous == "NORMAL" || synchronous == "1")
+    return 1;
+  return 0;
+}
+
+std::string StorageProfile::GetWriterScript(bool is_in_memory) const {
+  // page_size has to go before journal_mode, a WAL database keeps its page size
+  std::string script{"PRAGMA page_size=" + std::to_string(page_size) + ";"};
+  if (!is_in_memory)
+    script += "PRAGMA journal_mode=" + journal_mode + ";";
+  script += "PRAGMA synchronous=" + synchronous + ";";
+  script += "PRAGMA wal_autocheckpoint=" + std::to_string(wal_autocheckpoint) + ";";
+  if (is_in_memory)
+    return script + "PRAGMA cache_size=" + std::to_string(cache_size) + ";"
+                  + "PRAGMA temp_store=" + temp_store + ";";
+  return script + GetReaderScript();
+}
+
+std::string StorageProfile::GetReaderScript() const {
+  return "PRAGMA cache_size=" + std::to_string(cache_size) + ";"
+         + "PRAGMA mmap_size=" + std::to_string(mmap_size) + ";"
+         + "PRAGMA temp_store=" + temp_store + ";";
+}
+
+int32_t StorageProfile::AutoTune(const std::string &db_path,
+                                 const std::vector<std::string> &columns,
+                                 const std::vector<StorageProfile> &candidates,
+                                 uint64_t sample_rows, std::size_t &best,
+                                 std::vector<double> *seconds) {
+  best = 0;
+  if (seconds)
+    seconds->assign(candidates.size(), 0.0);
+  if (columns.empty() || candidates.empty())
+    return SQLITE_MISUSE;
+
+  int32_t last_error{SQLITE_OK};
+  double best_seconds{0.0};
+  bool is_found{false};
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    remove_database_files(db_path);
+    sqlite3 *database{nullptr};
+    auto res = sqlite3_open_v2(db_path.c_str(), &database,
+                               SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    if (res == SQLITE_OK)
+      res = sqlite3_exec(database, candidates[i].GetWriterScript(false).c_str(),
+                         nullptr, nullptr, nullptr);
+    if (res == SQLITE_OK)
+      res = run_workload(database, columns, sample_rows);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    sqlite3_close(database);
+    remove_database_files(db_path);
+
+    if (res != SQLITE_OK) {
+      // throw exception here
+      std::cout << "Auto tune of profile " << candidates[i].name << " failed: "
+                << sqlite3_errstr(res) << std::endl;
+      last_error = res;
+      continue;
+    }
+    if (seconds)
+      (*seconds)[i] = elapsed.count();
+    if (!is_found || elapsed.count() < best_seconds) {
+      best = i;
+      best_seconds = elapsed.count();
+      is_found = true;
+    }
+  }
+  return is_found ? SQLITE_OK : last_error;
+}
+
+} // namespace client
+} // namespace crypto_wallet
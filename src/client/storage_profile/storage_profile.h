@@ -0,0 +1,98 @@
+/// \file storage_profile.h
+/// \brief Class describing storage tuning profile.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_STORAGE_PROFILE_H_
+#define CRYPTO_WALLET_CLIENT_STORAGE_PROFILE_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class StorageProfile storage_profile.h.
+/// \brief Named set of storage pragmas.
+/// \details page_size takes effect on a database without pages only, journal mode
+/// \details and mmap are left alone for in-memory databases.
+class StorageProfile {
+ public:
+  std::string name{"default"};
+  std::string journal_mode{"DELETE"};
+  std::string synchronous{"FULL"};
+  // negative value is size in KiB, positive one is number of pages
+  int64_t cache_size{-2000};
+  int64_t mmap_size{0};
+  std::string temp_store{"DEFAULT"};
+  int32_t page_size{4096};
+  int32_t wal_autocheckpoint{1000};
+
+  /// \brief Large sequential writes, unsynced WAL, big cache and rare checkpoints.
+  /// \return Profile.
+  static StorageProfile BulkLoad();
+
+  /// \brief Mixed reads and writes, WAL with synchronous NORMAL.
+  /// \return Profile.
+  static StorageProfile BalancedOltp();
+
+  /// \brief Readers dominate, big cache and mmap.
+  /// \return Profile.
+  static StorageProfile ReadMostly();
+
+  /// \brief Every commit is synced, WAL with synchronous FULL and no mmap.
+  /// \return Profile.
+  static StorageProfile Durable();
+
+  /// \brief Get all named profiles.
+  /// \return Profiles.
+  static std::vector<StorageProfile> GetProfiles();
+
+  /// \brief Find profile by name ("bulk-load", "balanced-oltp", "read-mostly", "durable").
+  /// \param[in] profile_name Profile name.
+  /// \param[out] profile Found profile.
+  /// \return false if there is no such profile.
+  static bool FindProfile(const std::string &profile_name, StorageProfile &profile);
+
+  /// \brief Get how much of the committed data survives a power loss.
+  /// \details 0 synchronous OFF or no journal on disk, 1 NORMAL, 2 FULL, 3 EXTRA.
+  /// \return Durability level.
+  int32_t GetDurabilityLevel() const noexcept;
+
+  /// \brief Get pragmas of the writer connection.
+  /// \param[in] is_in_memory Database is in memory.
+  /// \return SQL script.
+  std::string GetWriterScript(bool is_in_memory) const;
+
+  /// \brief Get pragmas of the reader connections.
+  /// \return SQL script.
+  std::string GetReaderScript() const;
+
+  /// \brief Run the sample workload against every candidate and find the fastest one.
+  /// \details Workload inserts rows in batches of 1000, inserts 1% of them one per
+  /// \details transaction and scans the table, on a fresh database at db_path.
+  /// \param[in] db_path Scratch database path, removed after every run.
+  /// \param[in] columns Table columns.
+  /// \param[in] candidates Candidate profiles.
+  /// \param[in] sample_rows Number of rows in the workload.
+  /// \param[out] best Index of the fastest candidate.
+  /// \param[out] seconds Workload time per candidate, may be nullptr.
+  /// \return Result of the last failed run or SQLITE_OK.
+  static int32_t AutoTune(const std::string &db_path, const std::vector<std::string> &columns,
+                          const std::vector<StorageProfile> &candidates, uint64_t sample_rows,
+                          std::size_t &best, std::vector<double> *seconds);
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_STORAGE_PROFILE_H_
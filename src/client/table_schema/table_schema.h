@@ -0,0 +1,240 @@
+/// \file table_schema.h
+/// \brief Compile-time description of the database table.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_TABLE_SCHEMA_H_
+#define CRYPTO_WALLET_CLIENT_TABLE_SCHEMA_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \struct Blob table_schema.h.
+/// \brief Binary value, bound without copying.
+struct Blob {
+  const void *data{nullptr};
+  std::size_t size{0};
+};
+
+/// \struct FixedString table_schema.h.
+/// \brief Null terminated string built at compile time.
+template <std::size_t N>
+struct FixedString {
+  char data[N + 1]{};
+
+  /// \brief Get string length.
+  /// \return String length.
+  constexpr std::size_t size() const noexcept {
+    return N;
+  }
+
+  /// \brief Get null terminated string.
+  /// \return String.
+  constexpr const char *c_str() const noexcept {
+    return data;
+  }
+
+  /// \brief Get string view.
+  /// \return String view.
+  constexpr std::string_view view() const noexcept {
+    return std::string_view{data, N};
+  }
+};
+
+/// \struct SqlType table_schema.h.
+/// \brief SQL type of the column C++ type.
+template <typename T>
+struct SqlType;
+
+template <>
+struct SqlType<int64_t> {
+  static constexpr std::string_view kName = "INTEGER";
+};
+
+template <>
+struct SqlType<double> {
+  static constexpr std::string_view kName = "REAL";
+};
+
+template <>
+struct SqlType<std::string> {
+  static constexpr std::string_view kName = "TEXT";
+};
+
+template <>
+struct SqlType<Blob> {
+  static constexpr std::string_view kName = "BLOB";
+};
+
+/// \struct Column table_schema.h.
+/// \brief Base of the column description, derived struct declares kName and
+/// \brief may override kConstraint (ex: "NOT NULL").
+template <typename T>
+struct Column {
+  using Type = T;
+  static constexpr std::string_view kConstraint = "";
+};
+
+/// \struct IsBindable table_schema.h.
+/// \brief Check if value of type V can be bound to the column of type T.
+template <typename T, typename V>
+struct IsBindable : std::false_type {};
+
+template <typename V>
+struct IsBindable<int64_t, V>
+    : std::bool_constant<std::is_integral_v<std::decay_t<V>> &&
+                         !std::is_same_v<std::decay_t<V>, bool>> {};
+
+template <typename V>
+struct IsBindable<double, V> : std::is_arithmetic<std::decay_t<V>> {};
+
+template <typename V>
+struct IsBindable<std::string, V> : std::is_convertible<V, std::string_view> {};
+
+template <typename V>
+struct IsBindable<Blob, V> : std::is_convertible<V, Blob> {};
+
+/// \brief Bind native value to the statement parameter.
+/// \param[in] stmt Prepared statement.
+/// \param[in] idx Parameter index.
+/// \param[in] value Value, must outlive statement step.
+/// \return Result of binding.
+inline int32_t BindValue(sqlite3_stmt *stmt, int32_t idx, int64_t value) {
+  return sqlite3_bind_int64(stmt, idx, value);
+}
+
+inline int32_t BindValue(sqlite3_stmt *stmt, int32_t idx, double value) {
+  return sqlite3_bind_double(stmt, idx, value);
+}
+
+inline int32_t BindValue(sqlite3_stmt *stmt, int32_t idx, std::string_view value) {
+  return sqlite3_bind_text(stmt, idx, value.data(), static_cast<int>(value.size()),
+                           SQLITE_STATIC);
+}
+
+inline int32_t BindValue(sqlite3_stmt *stmt, int32_t idx, const Blob &value) {
+  return sqlite3_bind_blob(stmt, idx, value.data, static_cast<int>(value.size), SQLITE_STATIC);
+}
+
+/// \class TableSchema table_schema.h.
+/// \brief Table description: name type with kName and list of columns.
+/// \details SQL scripts are built at compile time, values are checked against
+/// \details column types at compile time and bound natively, never as text.
+/// \details Ex: using Transactions = TableSchema<TransactionsName, Address, Amount>;
+template <typename Name, typename... Columns>
+class TableSchema {
+ public:
+  static_assert(sizeof...(Columns) > 0, "table must have at least one column");
+
+  /// \brief Number of columns.
+  static constexpr std::size_t kColumnCount = sizeof...(Columns);
+
+  /// \brief Table name.
+  static constexpr std::string_view kName = Name::kName;
+
+  /// \brief Get columns definition, ex: "address TEXT NOT NULL, amount INTEGER".
+  /// \return Columns definition.
+  static constexpr auto StructTemplate() {
+    FixedString<StructTemplateSize()> res{};
+    std::size_t pos{0};
+    std::size_t idx{0};
+    ((Append(res.data, pos, Columns::kName), Append(res.data, pos, " "),
+      Append(res.data, pos, SqlType<typename Columns::Type>::kName),
+      Columns::kConstraint.empty() ? void() :
+          (Append(res.data, pos, " "), Append(res.data, pos, Columns::kConstraint)),
+      (++idx < kColumnCount) ? Append(res.data, pos, ", ") : void()), ...);
+    return res;
+  }
+
+  /// \brief Get create table script.
+  /// \return CREATE TABLE name (columns definition);
+  static constexpr auto CreateTableSql() {
+    constexpr auto struct_template = StructTemplate();
+    FixedString<kName.size() + struct_template.size() + 17> res{};
+    std::size_t pos{0};
+    Append(res.data, pos, "CREATE TABLE ");
+    Append(res.data, pos, kName);
+    Append(res.data, pos, " (");
+    Append(res.data, pos, struct_template.view());
+    Append(res.data, pos, ");");
+    return res;
+  }
+
+  /// \brief Get insert script.
+  /// \return INSERT INTO name (col1, ... colN) VALUES (?, ... ?);
+  static constexpr auto InsertSql() {
+    FixedString<kName.size() + ((Columns::kName.size() + 5) + ...) + 22> res{};
+    std::size_t pos{0};
+    std::size_t idx{0};
+    Append(res.data, pos, "INSERT INTO ");
+    Append(res.data, pos, kName);
+    Append(res.data, pos, " (");
+    ((Append(res.data, pos, Columns::kName),
+      (++idx < kColumnCount) ? Append(res.data, pos, ", ") : void()), ...);
+    Append(res.data, pos, ") VALUES (");
+    for (idx = 0; idx < kColumnCount; ++idx)
+      Append(res.data, pos, (idx + 1 < kColumnCount) ? "?, " : "?");
+    Append(res.data, pos, ");");
+    return res;
+  }
+
+  /// \brief Check at compile time that values match the columns.
+  /// \return true, compilation fails otherwise.
+  template <typename... Values>
+  static constexpr bool CheckValues() {
+    static_assert(sizeof...(Values) == kColumnCount, "values count does not match columns");
+    static_assert((IsBindable<typename Columns::Type, Values>::value && ...),
+                  "value type does not match column type");
+    return true;
+  }
+
+  /// \brief Bind values to the insert statement parameters.
+  /// \param[in] stmt Prepared insert statement.
+  /// \param[in] values Values in columns order.
+  /// \return Result of binding.
+  template <typename... Values>
+  static int32_t Bind(sqlite3_stmt *stmt, const Values &...values) {
+    static_assert(CheckValues<Values...>(), "");
+    int32_t idx{0};
+    int32_t res{SQLITE_OK};
+    ((res = (res == SQLITE_OK) ?
+          BindValue(stmt, ++idx, static_cast<BindType<typename Columns::Type>>(values)) : res),
+     ...);
+    return res;
+  }
+
+ private:
+  /// \brief Type value is converted to before binding.
+  template <typename T>
+  using BindType = std::conditional_t<std::is_same_v<T, std::string>, std::string_view,
+                                      std::conditional_t<std::is_same_v<T, Blob>, const Blob &, T>>;
+
+  static constexpr std::size_t StructTemplateSize() {
+    return ((Columns::kName.size() + 1 + SqlType<typename Columns::Type>::kName.size() +
+             (Columns::kConstraint.empty() ? 0 : Columns::kConstraint.size() + 1)) + ...) +
+           (kColumnCount - 1) * 2;
+  }
+
+  static constexpr void Append(char *data, std::size_t &pos, std::string_view str) {
+    for (auto ch : str)
+      data[pos++] = ch;
+  }
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_TABLE_SCHEMA_H_
@@ -0,0 +1,216 @@
+/// \file value_dictionary.cpp
+/// \brief Source file containing class ValueDictionary methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "value_dictionary.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iostream>
+
+namespace crypto_wallet {
+namespace client {
+
+ValueDictionary::ValueDictionary(const Options &options) : options_{options} {}
+
+ValueDictionary::~ValueDictionary() {
+  sqlite3_finalize(select_stmt_);
+  sqlite3_finalize(insert_stmt_);
+  sqlite3_finalize(select_value_stmt_);
+  if (!database_)
+    return;
+
+  sqlite3_create_function_v2(database_, decode_function_name_.c_str(), 1, SQLITE_UTF8, nullptr,
+                             nullptr, nullptr, nullptr, nullptr);
+  sqlite3_rollback_hook(database_, nullptr, nullptr);
+}
+
+int32_t ValueDictionary::Attach(sqlite3 *database, const std::string &table_name) {
+  if (database_ || !sqlite3_get_autocommit(database))
+    return SQLITE_MISUSE;
+
+  database_ = database;
+  dictionary_table_name_ = table_name + "_dictionary";
+  decode_function_name_ = dictionary_table_name_ + "_value";
+  const auto &dictionary = dictionary_table_name_;
+  char *err_msg{nullptr};
+  auto res = sqlite3_exec(database_, ("CREATE TABLE IF NOT EXISTS main." + dictionary +
+                                      " (id INTEGER PRIMARY KEY, value TEXT NOT NULL "
+                                      "UNIQUE);").c_str(),
+                          nullptr, nullptr, &err_msg);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Value dictionary script results in error: "
+              << (err_msg ? err_msg : sqlite3_errstr(res)) << std::endl;
+    sqlite3_free(err_msg);
+    return res;
+  }
+
+  res = sqlite3_prepare_v3(database_, ("SELECT id FROM main." + dictionary +
+                                       " WHERE value = ?1;").c_str(),
+                           -1, SQLITE_PREPARE_PERSISTENT, &select_stmt_, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_prepare_v3(database_, ("INSERT INTO main." + dictionary +
+                                         " (value) VALUES (?1);").c_str(),
+                             -1, SQLITE_PREPARE_PERSISTENT, &insert_stmt_, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_prepare_v3(database_, ("SELECT value FROM main." + dictionary +
+                                         " WHERE id = ?1;").c_str(),
+                             -1, SQLITE_PREPARE_PERSISTENT, &select_value_stmt_, nullptr);
+  if (res == SQLITE_OK)
+    res = sqlite3_create_function_v2(database_, decode_function_name_.c_str(), 1, SQLITE_UTF8,
+                                     this, &ValueDictionary::DecodeValue, nullptr, nullptr,
+                                     nullptr);
+  if (res == SQLITE_OK)
+    sqlite3_rollback_hook(database_, &ValueDictionary::RollbackHook, this);
+  return res;
+}
+
+/// Value interned by other connection in between the lookup and the insert fails
+/// the unique constraint, it is looked up once more then.
+int32_t ValueDictionary::Intern(std::string_view value, int64_t &id) {
+  if (!insert_stmt_)
+    return SQLITE_MISUSE;
+
+  scratch_value_.assign(value.data(), value.size());
+  auto it = cache_.find(scratch_value_);
+  if (it != cache_.end()) {
+    cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    id = it->second;
+    return SQLITE_OK;
+  }
+
+  cache_misses_.fetch_add(1, std::memory_order_relaxed);
+  auto res = SelectId(id);
+  if (res == SQLITE_DONE) {
+    sqlite3_bind_text(insert_stmt_, 1, scratch_value_.data(),
+                      static_cast<int>(scratch_value_.size()), SQLITE_STATIC);
+    res = sqlite3_step(insert_stmt_);
+    sqlite3_reset(insert_stmt_);
+    if (res == SQLITE_DONE) {
+      id = sqlite3_last_insert_rowid(database_);
+      interned_values_.fetch_add(1, std::memory_order_relaxed);
+      res = SQLITE_ROW;
+    } else if (res == SQLITE_CONSTRAINT) {
+      res = SelectId(id);
+    }
+  }
+  if (res != SQLITE_ROW)
+    return (res == SQLITE_DONE) ? SQLITE_INTERNAL : res;
+
+  if (cache_.size() >= options_.max_cached_values)
+    DropCache();
+  cache_.emplace(scratch_value_, id);
+  values_cache_.emplace(id, scratch_value_);
+  return SQLITE_OK;
+}
+
+int32_t ValueDictionary::BindEncoded(sqlite3_stmt *stmt, int32_t idx, std::string_view value) {
+  int64_t id{0};
+  auto res = Intern(value, id);
+  if (res != SQLITE_OK)
+    return res;
+  char digits[24];
+  auto end = std::to_chars(digits, digits + sizeof(digits), id).ptr;
+  return sqlite3_bind_blob(stmt, idx, digits, static_cast<int>(end - digits), SQLITE_TRANSIENT);
+}
+
+/// Rules of the SQLite column affinity, the first match wins: INT, then CHAR, CLOB or TEXT.
+bool ValueDictionary::IsTextAffinity(std::string declared_type) {
+  std::transform(declared_type.begin(), declared_type.end(), declared_type.begin(),
+                 [](unsigned char symbol) { return std::toupper(symbol); });
+  if (declared_type.find("INT") != std::string::npos)
+    return false;
+  return declared_type.find("CHAR") != std::string::npos ||
+         declared_type.find("CLOB") != std::string::npos ||
+         declared_type.find("TEXT") != std::string::npos;
+}
+
+std::string ValueDictionary::GetDecodeExpression(const std::string &column_name,
+                                                 bool is_attached) const {
+  if (is_attached)
+    return decode_function_name_ + "(" + column_name + ")";
+  // rows written before encoding keep their values, only BLOB ids are looked up
+  return "CASE typeof(" + column_name + ") WHEN 'blob' THEN (SELECT value FROM main." +
+         dictionary_table_name_ + " WHERE id = CAST(CAST(" + column_name +
+         " AS TEXT) AS INTEGER)) ELSE " + column_name + " END";
+}
+
+ValueDictionary::Metrics ValueDictionary::GetMetrics() const noexcept {
+  return Metrics{cache_hits_.load(std::memory_order_relaxed),
+                 cache_misses_.load(std::memory_order_relaxed),
+                 cache_drops_.load(std::memory_order_relaxed),
+                 interned_values_.load(std::memory_order_relaxed)};
+}
+
+void ValueDictionary::DropCache() {
+  if (cache_.empty() && values_cache_.empty())
+    return;
+  cache_.clear();
+  values_cache_.clear();
+  cache_drops_.fetch_add(1, std::memory_order_relaxed);
+}
+
+int32_t ValueDictionary::SelectId(int64_t &id) {
+  sqlite3_bind_text(select_stmt_, 1, scratch_value_.data(),
+                    static_cast<int>(scratch_value_.size()), SQLITE_STATIC);
+  auto res = sqlite3_step(select_stmt_);
+  if (res == SQLITE_ROW)
+    id = sqlite3_column_int64(select_stmt_, 0);
+  sqlite3_reset(select_stmt_);
+  return res;
+}
+
+/// Ids missing in the cache are looked up by the primary key, other values (rows
+/// written before encoding was enabled) are returned as is.
+void ValueDictionary::DecodeValue(sqlite3_context *context, int argc, sqlite3_value **argv) {
+  auto value_dictionary = static_cast<ValueDictionary *>(sqlite3_user_data(context));
+  if (argc != 1 || sqlite3_value_type(argv[0]) != SQLITE_BLOB) {
+    if (argc == 1)
+      sqlite3_result_value(context, argv[0]);
+    return;
+  }
+
+  auto digits = static_cast<const char *>(sqlite3_value_blob(argv[0]));
+  auto digits_end = digits + sqlite3_value_bytes(argv[0]);
+  int64_t id{0};
+  if (!digits || std::from_chars(digits, digits_end, id).ptr != digits_end) {
+    sqlite3_result_null(context);
+    return;
+  }
+  auto &values_cache = value_dictionary->values_cache_;
+  auto it = values_cache.find(id);
+  if (it == values_cache.end()) {
+    value_dictionary->cache_misses_.fetch_add(1, std::memory_order_relaxed);
+    auto stmt = value_dictionary->select_value_stmt_;
+    sqlite3_bind_int64(stmt, 1, id);
+    auto res = sqlite3_step(stmt);
+    if (res != SQLITE_ROW) {
+      sqlite3_reset(stmt);
+      if (res == SQLITE_DONE)
+        sqlite3_result_null(context);
+      else
+        sqlite3_result_error_code(context, res);
+      return;
+    }
+    if (values_cache.size() >= value_dictionary->options_.max_cached_values)
+      value_dictionary->DropCache();
+    it = values_cache.emplace(id, std::string{
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)),
+        static_cast<std::size_t>(sqlite3_column_bytes(stmt, 0))}).first;
+    sqlite3_reset(stmt);
+  } else {
+    value_dictionary->cache_hits_.fetch_add(1, std::memory_order_relaxed);
+  }
+  sqlite3_result_text(context, it->second.data(), static_cast<int>(it->second.size()),
+                      SQLITE_TRANSIENT);
+}
+
+void ValueDictionary::RollbackHook(void *value_dictionary) {
+  static_cast<ValueDictionary *>(value_dictionary)->DropCache();
+}
+} // namespace client
+} // namespace crypto_wallet
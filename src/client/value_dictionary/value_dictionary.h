@@ -0,0 +1,148 @@
+/// \file value_dictionary.h
+/// \brief Class interning repeated column values into the dictionary table.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_VALUE_DICTIONARY_H_
+#define CRYPTO_WALLET_CLIENT_VALUE_DICTIONARY_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class ValueDictionary value_dictionary.h.
+/// \brief Dictionary table <table>_dictionary (id INTEGER PRIMARY KEY, value TEXT
+/// \brief UNIQUE) of the values of encoded columns, rows keep the id.
+/// \details Dictionary is append-only and shared by every encoded column of the table.
+/// \details Rows keep the id as BLOB of its decimal digits: column affinity never
+/// \details converts a BLOB and plain values are never stored as one, so ids are told
+/// \details from the values written before encoding without guessing.
+/// \details Ids and values are cached in process both ways, rollback drops the cache
+/// \details since ids interned by the transaction are gone and may be reused. ROLLBACK
+/// \details TO a savepoint is not tracked by SQLite hooks, savepoints must not be
+/// \details rolled back over interned values.
+class ValueDictionary {
+ public:
+  /// \struct Options value_dictionary.h.
+  /// \brief Cache limits.
+  struct Options {
+    // cache is dropped once it grows over the limit
+    std::size_t max_cached_values{1000000};
+  };
+
+  /// \struct Metrics value_dictionary.h.
+  /// \brief Cache counters.
+  struct Metrics {
+    uint64_t cache_hits{0};
+    uint64_t cache_misses{0};
+    uint64_t cache_drops{0};
+    uint64_t interned_values{0};
+  };
+
+  /// \brief ValueDictionary constructor.
+  /// \param[in] options Cache limits.
+  explicit ValueDictionary(const Options &options);
+
+  /// \brief ValueDictionary destructor, removes the rollback hook.
+  ~ValueDictionary();
+
+  /// \brief Class ValueDictionary copy constructor.
+  /// \param[in] value_dictionary Class ValueDictionary object.
+  ValueDictionary(const ValueDictionary &value_dictionary) = delete;
+
+  /// \brief Class ValueDictionary copy assignment.
+  /// \param[in] value_dictionary Class ValueDictionary object.
+  /// \return ValueDictionary object.
+  ValueDictionary &operator=(const ValueDictionary &value_dictionary) = delete;
+
+  /// \brief Create dictionary table of the table if it does not exist.
+  /// \details Must be called outside of transaction. Installs the rollback hook.
+  /// \param[in] database Connection.
+  /// \param[in] table_name Table with encoded columns.
+  /// \return Result of the setup.
+  int32_t Attach(sqlite3 *database, const std::string &table_name);
+
+  /// \brief Get id of the value, add the value to the dictionary if it is new.
+  /// \details Value added outside of transaction is committed at once.
+  /// \param[in] value Column value.
+  /// \param[out] id Dictionary id.
+  /// \return Result of the lookup or insert.
+  int32_t Intern(std::string_view value, int64_t &id);
+
+  /// \brief Intern the value and bind its id to the statement as the encoded value.
+  /// \param[in] stmt Statement.
+  /// \param[in] idx Parameter index.
+  /// \param[in] value Column value.
+  /// \return Result of the lookup or insert.
+  int32_t BindEncoded(sqlite3_stmt *stmt, int32_t idx, std::string_view value);
+
+  /// \brief Check if the declared column type gives the column TEXT affinity.
+  /// \param[in] declared_type Declared column type.
+  /// \return TEXT affinity state.
+  static bool IsTextAffinity(std::string declared_type);
+
+  /// \brief Get expression selecting the value stored as id in the column.
+  /// \param[in] column_name Encoded column.
+  /// \param[in] is_attached Expression runs on the attached connection, values are
+  /// \param[in] decoded from the cache by SQL function then.
+  /// \return SQL function call or scalar subquery by the dictionary primary key, both
+  /// \return return values other than encoded ids as is.
+  std::string GetDecodeExpression(const std::string &column_name, bool is_attached) const;
+
+  /// \brief Get dictionary table name.
+  /// \return Table name.
+  inline std::string GetTableName() const { return dictionary_table_name_; }
+
+  /// \brief Get cache counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const noexcept;
+
+ private:
+  /// \brief Drop the cached ids.
+  void DropCache();
+
+  /// \brief Look the value up in the dictionary table.
+  /// \param[out] id Dictionary id.
+  /// \return SQLITE_ROW if found, SQLITE_DONE if not, otherwise error.
+  int32_t SelectId(int64_t &id);
+
+  /// \brief SQL function decoding the id: <table>_dictionary_value(id).
+  static void DecodeValue(sqlite3_context *context, int argc, sqlite3_value **argv);
+
+  /// \brief Rollback hook, ids interned by the transaction are gone.
+  static void RollbackHook(void *value_dictionary);
+
+  Options options_;
+  sqlite3 *database_{nullptr};
+  std::string dictionary_table_name_{};
+  sqlite3_stmt *select_stmt_{nullptr};
+  sqlite3_stmt *insert_stmt_{nullptr};
+  sqlite3_stmt *select_value_stmt_{nullptr};
+  std::string decode_function_name_{};
+  std::unordered_map<std::string, int64_t> cache_{};
+  std::unordered_map<int64_t, std::string> values_cache_{};
+  // lookups reuse its capacity
+  std::string scratch_value_{};
+  std::atomic<uint64_t> cache_hits_{0};
+  std::atomic<uint64_t> cache_misses_{0};
+  std::atomic<uint64_t> cache_drops_{0};
+  std::atomic<uint64_t> interned_values_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_VALUE_DICTIONARY_H_
@@ -0,0 +1,256 @@
+/// \file write_behind.cpp
+/// \brief Source file containing class WriteBehind methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "write_behind.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+  std::string columns_to_string(const std::vector<std::string> &columns) {
+    std::string res;
+    for (const auto &column : columns)
+      res += ", " + column;
+    return res;
+  }
+}
+
+namespace crypto_wallet {
+namespace client {
+
+WriteBehind::WriteBehind(const std::string &disk_db_name, const Options &options)
+    : disk_db_name_{disk_db_name}, options_{options} {
+  options_.rows_per_flush = std::max<std::size_t>(options_.rows_per_flush, 1);
+}
+
+WriteBehind::~WriteBehind() {
+  Stop();
+  sqlite3_close(disk_database_);
+}
+
+int32_t WriteBehind::Open(const std::string &hot_db_name, sqlite3 *hot_database,
+                          bool &is_warmed) {
+  is_warmed = false;
+  auto res = sqlite3_open_v2(disk_db_name_.c_str(), &disk_database_,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                             nullptr);
+  if (res != SQLITE_OK)
+    return res;
+  sqlite3_busy_timeout(disk_database_, 1000);
+
+  // warm up: the whole disk database replaces the hot one
+  sqlite3_stmt *stmt{nullptr};
+  int64_t tables_count{0};
+  res = sqlite3_prepare_v2(disk_database_,
+                           "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table';", -1,
+                           &stmt, nullptr);
+  if (res == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+    tables_count = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_OK)
+    return res;
+
+  if (tables_count > 0) {
+    auto backup = sqlite3_backup_init(hot_database, "main", disk_database_, "main");
+    if (!backup)
+      return sqlite3_errcode(hot_database);
+    sqlite3_backup_step(backup, -1);
+    res = sqlite3_backup_finish(backup);
+    if (res != SQLITE_OK)
+      return res;
+    is_warmed = true;
+  }
+
+  return RunSqlScript("PRAGMA journal_mode=WAL; PRAGMA synchronous=FULL; "
+                      "PRAGMA read_uncommitted=1; ATTACH DATABASE '" + hot_db_name +
+                      "' AS hot;");
+}
+
+void WriteBehind::Start() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (is_running_ || !disk_database_)
+    return;
+  is_running_ = true;
+  flusher_ = std::thread{&WriteBehind::RunFlusher, this};
+}
+
+void WriteBehind::Stop() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    is_running_ = false;
+  }
+  flush_condition_.notify_one();
+  if (flusher_.joinable())
+    flusher_.join();
+  if (disk_database_)
+    Flush();
+}
+
+int32_t WriteBehind::SetTable(const std::string &table_name,
+                              const std::vector<std::string> &columns) {
+  std::lock_guard<std::mutex> lock{flush_mutex_};
+  auto res = FlushCommitted();
+  table_name_ = table_name;
+  columns_ = columns;
+  is_table_prepared_ = false;
+  committed_rowid_.store(0, std::memory_order_relaxed);
+  flushed_rowid_.store(0, std::memory_order_relaxed);
+  return res;
+}
+
+void WriteBehind::NoteCommitted(int64_t rowid) noexcept {
+  auto committed = committed_rowid_.load(std::memory_order_relaxed);
+  while (rowid > committed &&
+         !committed_rowid_.compare_exchange_weak(committed, rowid, std::memory_order_release)) {}
+
+  auto pending = rowid - flushed_rowid_.load(std::memory_order_relaxed);
+  if (pending >= static_cast<int64_t>(options_.max_pending_rows) &&
+      !is_flush_requested_.exchange(true, std::memory_order_acq_rel)) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    flush_condition_.notify_one();
+  }
+}
+
+int32_t WriteBehind::Flush() {
+  std::lock_guard<std::mutex> lock{flush_mutex_};
+  return FlushCommitted();
+}
+
+WriteBehind::Metrics WriteBehind::GetMetrics() const noexcept {
+  Metrics metrics{};
+  metrics.flushes = flushes_.load(std::memory_order_relaxed);
+  metrics.flushed_rows = flushed_rows_.load(std::memory_order_relaxed);
+  metrics.failed_flushes = failed_flushes_.load(std::memory_order_relaxed);
+  metrics.committed_rowid = committed_rowid_.load(std::memory_order_relaxed);
+  metrics.flushed_rowid = flushed_rowid_.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+void WriteBehind::RunFlusher() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (is_running_) {
+    flush_condition_.wait_for(lock, options_.max_flush_delay, [this] {
+      return !is_running_ || is_flush_requested_.load(std::memory_order_acquire);
+    });
+    is_flush_requested_.store(false, std::memory_order_release);
+    lock.unlock();
+    Flush();
+    lock.lock();
+  }
+}
+
+/// Rows are copied with their rowid, so flushed rowid survives restart as
+/// max(rowid) of the disk table.
+int32_t WriteBehind::FlushCommitted() {
+  if (table_name_.empty() || !disk_database_)
+    return SQLITE_OK;
+
+  if (!is_table_prepared_) {
+    auto res = PrepareTable();
+    if (res != SQLITE_OK) {
+      failed_flushes_.fetch_add(1, std::memory_order_relaxed);
+      return res;
+    }
+  }
+
+  auto committed = committed_rowid_.load(std::memory_order_acquire);
+  auto flushed = flushed_rowid_.load(std::memory_order_relaxed);
+  if (flushed >= committed)
+    return SQLITE_OK;
+
+  sqlite3_stmt *stmt{nullptr};
+  auto res = sqlite3_prepare_v2(disk_database_, flush_script_.c_str(), -1, &stmt, nullptr);
+  while (res == SQLITE_OK && flushed < committed) {
+    auto upper = std::min<int64_t>(committed,
+                                   flushed + static_cast<int64_t>(options_.rows_per_flush));
+    // deferred: IMMEDIATE would take the write lock on the attached hot database too
+    res = RunSqlScript("BEGIN;");
+    if (res != SQLITE_OK)
+      break;
+    sqlite3_bind_int64(stmt, 1, flushed);
+    sqlite3_bind_int64(stmt, 2, upper);
+    res = sqlite3_step(stmt);
+    res = (res == SQLITE_DONE) ? SQLITE_OK : res;
+    auto changes = sqlite3_changes(disk_database_);
+    sqlite3_reset(stmt);
+    if (res == SQLITE_OK)
+      res = RunSqlScript("COMMIT;");
+    if (res != SQLITE_OK) {
+      RunSqlScript("ROLLBACK;");
+      break;
+    }
+
+    flushed = upper;
+    flushed_rowid_.store(flushed, std::memory_order_relaxed);
+    flushes_.fetch_add(1, std::memory_order_relaxed);
+    flushed_rows_.fetch_add(static_cast<uint64_t>(changes), std::memory_order_relaxed);
+  }
+  sqlite3_finalize(stmt);
+
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Write-behind flush results in error: " << sqlite3_errmsg(disk_database_)
+              << std::endl;
+    failed_flushes_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return res;
+}
+
+int32_t WriteBehind::PrepareTable() {
+  sqlite3_stmt *stmt{nullptr};
+  std::string create_table_sql;
+  auto res = sqlite3_prepare_v2(disk_database_,
+                                "SELECT sql FROM hot.sqlite_master WHERE type = 'table' AND "
+                                "name = ?1;", -1, &stmt, nullptr);
+  if (res == SQLITE_OK) {
+    sqlite3_bind_text(stmt, 1, table_name_.c_str(), -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+      create_table_sql = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+  }
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_OK)
+    return res;
+  if (create_table_sql.empty())
+    return SQLITE_ERROR;
+
+  // sqlite_master keeps "CREATE TABLE name (...)"
+  const std::string create_table = "CREATE TABLE ";
+  if (create_table_sql.compare(0, create_table.size(), create_table) == 0)
+    create_table_sql.replace(0, create_table.size(), "CREATE TABLE IF NOT EXISTS main.");
+  res = RunSqlScript(create_table_sql);
+  if (res != SQLITE_OK)
+    return res;
+
+  res = sqlite3_prepare_v2(disk_database_,
+                           ("SELECT COALESCE(MAX(rowid), 0) FROM main." + table_name_ +
+                            ";").c_str(), -1, &stmt, nullptr);
+  if (res == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+    flushed_rowid_.store(sqlite3_column_int64(stmt, 0), std::memory_order_relaxed);
+  sqlite3_finalize(stmt);
+  if (res != SQLITE_OK)
+    return res;
+
+  auto columns = columns_to_string(columns_);
+  flush_script_ = "INSERT INTO main." + table_name_ + " (rowid" + columns + ") SELECT rowid" +
+                  columns + " FROM hot." + table_name_ + " WHERE rowid > ?1 AND rowid <= ?2;";
+  is_table_prepared_ = true;
+  return SQLITE_OK;
+}
+
+int32_t WriteBehind::RunSqlScript(const std::string &sql_script) {
+  char *errMsg{nullptr};
+  auto res = sqlite3_exec(disk_database_, sql_script.c_str(), nullptr, nullptr, &errMsg);
+  if (res != SQLITE_OK) {
+    // throw exception here
+    std::cout << "Write-behind script evaluation results in error: "
+              << (errMsg ? errMsg : "") << std::endl;
+    sqlite3_free(errMsg);
+  }
+  return res;
+}
+
+} // namespace client
+} // namespace crypt_wallet
@@ -0,0 +1,147 @@
+/// \file write_behind.h
+/// \brief Class flushing rows of the in-memory database into the disk database.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_CLIENT_WRITE_BEHIND_H_
+#define CRYPTO_WALLET_CLIENT_WRITE_BEHIND_H_
+
+extern "C" {
+#include <sqlite3.h>
+}
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace client
+/// \brief Client namespace.
+namespace client {
+/// \class WriteBehind write_behind.h.
+/// \brief Class moving committed rows of the hot (shared in-memory) database into
+/// \brief the disk database on a background thread.
+/// \details Flusher connection opens the disk database and attaches the hot one as
+/// \details "hot" with read_uncommitted, so it takes no table locks the writer waits
+/// \details on. Rows are copied by rowid range up to the committed rowid reported
+/// \details by the writer, tables are expected to be append-only.
+class WriteBehind {
+ public:
+  /// \struct Options write_behind.h.
+  /// \brief Write-behind options.
+  struct Options {
+    // crash window: committed rows reach the disk within this delay
+    std::chrono::milliseconds max_flush_delay{1000};
+    // flush starts early once this many rows are pending
+    std::size_t max_pending_rows{10000};
+    // rows copied in one disk transaction
+    std::size_t rows_per_flush{50000};
+  };
+
+  /// \struct Metrics write_behind.h.
+  /// \brief Write-behind counters.
+  struct Metrics {
+    uint64_t flushes{0};
+    uint64_t flushed_rows{0};
+    uint64_t failed_flushes{0};
+    int64_t committed_rowid{0};
+    int64_t flushed_rowid{0};
+  };
+
+  /// \brief WriteBehind constructor.
+  /// \param[in] disk_db_name Disk database path.
+  /// \param[in] options Write-behind options.
+  WriteBehind(const std::string &disk_db_name, const Options &options);
+
+  /// \brief WriteBehind destructor, stops the flusher after the final flush.
+  ~WriteBehind();
+
+  /// \brief Class WriteBehind copy constructor.
+  /// \param[in] write_behind Class WriteBehind object.
+  WriteBehind(const WriteBehind &write_behind) = delete;
+
+  /// \brief Class WriteBehind copy assignment.
+  /// \param[in] write_behind Class WriteBehind object.
+  /// \return WriteBehind object.
+  WriteBehind &operator=(const WriteBehind &write_behind) = delete;
+
+  /// \brief Open disk database, warm the hot database from it and attach the hot one.
+  /// \details Hot database content is replaced with the disk one if the disk one
+  /// \details has any table, so it is opened before the hot database is written.
+  /// \param[in] hot_db_name Hot database URI.
+  /// \param[in] hot_database Hot database writer connection.
+  /// \param[out] is_warmed Hot database was replaced with the disk content.
+  /// \return Result of opening.
+  int32_t Open(const std::string &hot_db_name, sqlite3 *hot_database, bool &is_warmed);
+
+  /// \brief Start the flusher thread.
+  void Start();
+
+  /// \brief Stop the flusher thread, pending rows are flushed before it returns.
+  void Stop();
+
+  /// \brief Set table to flush, rows of the previous table are flushed first.
+  /// \param[in] table_name Table name.
+  /// \param[in] columns Table columns.
+  /// \return Result of the previous table flush.
+  int32_t SetTable(const std::string &table_name, const std::vector<std::string> &columns);
+
+  /// \brief Report rows up to the rowid as committed in the hot database.
+  /// \param[in] rowid Last committed rowid.
+  void NoteCommitted(int64_t rowid) noexcept;
+
+  /// \brief Flush committed rows synchronously.
+  /// \return Result of the flush.
+  int32_t Flush();
+
+  /// \brief Get write-behind counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const noexcept;
+
+ private:
+  /// \brief Flush loop of the background thread.
+  void RunFlusher();
+
+  /// \brief Flush committed rows, flush_mutex_ is held by the caller.
+  /// \return Result of the flush.
+  int32_t FlushCommitted();
+
+  /// \brief Create current table on disk and load its flushed rowid.
+  /// \return Result of the preparation.
+  int32_t PrepareTable();
+
+  /// \brief Run SQL script on the disk connection.
+  int32_t RunSqlScript(const std::string &sql_script);
+
+  std::string disk_db_name_;
+  Options options_;
+  sqlite3 *disk_database_{nullptr};
+  std::string table_name_{};
+  std::vector<std::string> columns_{};
+  bool is_table_prepared_{false};
+  std::string flush_script_{};
+  // flush_mutex_ serializes flushes and table changes, mutex_ guards the flusher state
+  std::mutex flush_mutex_{};
+  std::mutex mutex_{};
+  std::condition_variable flush_condition_{};
+  std::thread flusher_{};
+  bool is_running_{false};
+  std::atomic<bool> is_flush_requested_{false};
+  std::atomic<int64_t> committed_rowid_{0};
+  std::atomic<int64_t> flushed_rowid_{0};
+  std::atomic<uint64_t> flushes_{0};
+  std::atomic<uint64_t> flushed_rows_{0};
+  std::atomic<uint64_t> failed_flushes_{0};
+};
+}  // namespace client
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_CLIENT_WRITE_BEHIND_H_
@@ -0,0 +1,288 @@
+/// \file unix_connection.cpp
+/// \brief Source file containing class UnixConnection methods definitions.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include "unix_connection.h"
+
+extern "C" {
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace crypto_wallet {
+namespace socket_communication {
+
+namespace {
+  constexpr int32_t kMaxEvents = 64;
+  constexpr std::size_t kReadChunkSize = 64 * 1024;
+  // bytes read from one client per wakeup
+  constexpr std::size_t kMaxReadPerWakeup = 4 * kReadChunkSize;
+  // period paused clients are offered to the handler again
+  constexpr int32_t kPausedRetryMs = 1;
+}
+
+void AppendFrame(std::string &buffer, std::string_view record) {
+  uint32_t size = htonl(static_cast<uint32_t>(record.size()));
+  buffer.append(reinterpret_cast<const char *>(&size), sizeof(size));
+  buffer.append(record.data(), record.size());
+}
+
+UnixConnection::~UnixConnection() {
+  Close();
+}
+
+int32_t UnixConnection::Bind(const std::string &socket_path) {
+  sockaddr_un addr{};
+  if (socket_path.size() >= sizeof(addr.sun_path))
+    return ENAMETOOLONG;
+
+  Close();
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (listen_fd_ < 0 || epoll_fd_ < 0 || stop_fd_ < 0) {
+    auto res = errno;
+    Close();
+    return res;
+  }
+
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(socket_path.c_str());
+  if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(listen_fd_, SOMAXCONN) < 0) {
+    auto res = errno;
+    Close();
+    return res;
+  }
+  socket_path_ = socket_path;
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = listen_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event);
+  event.data.fd = stop_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event);
+  return 0;
+}
+
+void UnixConnection::SetRecordHandler(RecordHandler record_handler) {
+  record_handler_ = std::move(record_handler);
+}
+
+int32_t UnixConnection::Run() {
+  if (epoll_fd_ < 0)
+    return EBADF;
+
+  epoll_event events[kMaxEvents];
+  while (true) {
+    auto count = epoll_wait(epoll_fd_, events, kMaxEvents,
+                            paused_clients_.empty() ? -1 : kPausedRetryMs);
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      return errno;
+    }
+    if (!paused_clients_.empty())
+      ResumeClients();
+
+    for (int32_t i = 0; i < count; ++i) {
+      auto fd = events[i].data.fd;
+      if (fd == stop_fd_) {
+        uint64_t value{0};
+        if (read(stop_fd_, &value, sizeof(value)) < 0) {}
+        return 0;
+      }
+
+      if (fd == listen_fd_)
+        AcceptClients();
+      else if (!ReadClient(fd))
+        CloseClient(fd);
+    }
+  }
+}
+
+void UnixConnection::Stop() noexcept {
+  uint64_t value{1};
+  if (stop_fd_ >= 0 && write(stop_fd_, &value, sizeof(value)) < 0) {}
+}
+
+UnixConnection::Metrics UnixConnection::GetMetrics() const noexcept {
+  Metrics metrics{};
+  metrics.accepted_clients = accepted_clients_.load(std::memory_order_relaxed);
+  metrics.active_clients = active_clients_.load(std::memory_order_relaxed);
+  metrics.records = records_.load(std::memory_order_relaxed);
+  metrics.bytes = bytes_.load(std::memory_order_relaxed);
+  metrics.dropped_clients = dropped_clients_.load(std::memory_order_relaxed);
+  metrics.paused_clients = paused_count_.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+void UnixConnection::AcceptClients() {
+  while (true) {
+    auto client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client_fd < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        std::cout << "Error occured while accepting client " << std::strerror(errno)
+                  << std::endl;
+      return;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = client_fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_fd, &event) < 0) {
+      close(client_fd);
+      continue;
+    }
+    client_buffers_[client_fd].data.resize(kReadChunkSize);
+    accepted_clients_.fetch_add(1, std::memory_order_relaxed);
+    active_clients_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool UnixConnection::ReadClient(int32_t client_fd) {
+  auto &buffer = client_buffers_[client_fd];
+  std::size_t read_bytes{0};
+  while (read_bytes < kMaxReadPerWakeup) {
+    if (buffer.data.size() < buffer.size + kReadChunkSize)
+      buffer.data.resize(buffer.size + kReadChunkSize);
+    auto res = read(client_fd, buffer.data.data() + buffer.size, kReadChunkSize);
+    if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break;
+    if (res < 0 && errno == EINTR)
+      continue;
+    if (res <= 0) {
+      // peer closed connection or error, frames already read are still handled
+      buffer.is_peer_closed = true;
+    } else {
+      buffer.size += res;
+      read_bytes += res;
+      bytes_.fetch_add(res, std::memory_order_relaxed);
+    }
+
+    bool is_paused{false};
+    if (!HandleFrames(buffer, is_paused)) {
+      dropped_clients_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (is_paused) {
+      PauseClient(client_fd);
+      return true;
+    }
+    if (buffer.is_peer_closed)
+      return false;
+  }
+  return true;
+}
+
+/// Complete frames are handed out straight from the receive buffer, only the
+/// trailing partial frame and the frames not taken are moved to the buffer front.
+bool UnixConnection::HandleFrames(ClientBuffer &buffer, bool &is_paused) {
+  std::size_t offset{0};
+  bool res{true};
+  while (buffer.size - offset >= kFrameHeaderSize) {
+    uint32_t frame_size{0};
+    std::memcpy(&frame_size, buffer.data.data() + offset, kFrameHeaderSize);
+    frame_size = ntohl(frame_size);
+    if (frame_size > kMaxFrameSize) {
+      res = false;
+      break;
+    }
+    if (buffer.size - offset - kFrameHeaderSize < frame_size)
+      break;
+
+    if (record_handler_ &&
+        !record_handler_(std::string_view{buffer.data.data() + offset + kFrameHeaderSize,
+                                          frame_size})) {
+      is_paused = true;
+      break;
+    }
+    records_.fetch_add(1, std::memory_order_relaxed);
+    offset += kFrameHeaderSize + frame_size;
+  }
+
+  if (offset) {
+    std::memmove(buffer.data.data(), buffer.data.data() + offset, buffer.size - offset);
+    buffer.size -= offset;
+  }
+  return res;
+}
+
+void UnixConnection::PauseClient(int32_t client_fd) noexcept {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, client_fd, nullptr);
+  paused_clients_.push_back(client_fd);
+  paused_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Paused client is out of epoll, so a peer hang up does not wake the loop up
+/// while its records wait.
+void UnixConnection::ResumeClients() {
+  auto paused_clients = std::move(paused_clients_);
+  paused_clients_.clear();
+  for (std::size_t i = 0; i < paused_clients.size(); ++i) {
+    auto client_fd = paused_clients[i];
+    auto &buffer = client_buffers_[client_fd];
+    bool is_paused{false};
+    if (!HandleFrames(buffer, is_paused)) {
+      dropped_clients_.fetch_add(1, std::memory_order_relaxed);
+      CloseClient(client_fd);
+      continue;
+    }
+    if (is_paused) {
+      // handler is still full, the rest waits for the next retry in order
+      paused_clients_.insert(paused_clients_.end(), paused_clients.begin() + i,
+                             paused_clients.end());
+      return;
+    }
+    if (buffer.is_peer_closed) {
+      CloseClient(client_fd);
+      continue;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = client_fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_fd, &event) < 0)
+      CloseClient(client_fd);
+  }
+}
+
+void UnixConnection::CloseClient(int32_t client_fd) noexcept {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, client_fd, nullptr);
+  close(client_fd);
+  client_buffers_.erase(client_fd);
+  active_clients_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void UnixConnection::Close() noexcept {
+  paused_clients_.clear();
+  for (const auto &el : client_buffers_)
+    close(el.first);
+  active_clients_.fetch_sub(client_buffers_.size(), std::memory_order_relaxed);
+  client_buffers_.clear();
+
+  for (auto fd : {listen_fd_, epoll_fd_, stop_fd_})
+    if (fd >= 0)
+      close(fd);
+  listen_fd_ = epoll_fd_ = stop_fd_ = -1;
+
+  if (!socket_path_.empty()) {
+    unlink(socket_path_.c_str());
+    socket_path_.clear();
+  }
+}
+
+} // namespace socket_communication
+} // namespace crypto_wallet
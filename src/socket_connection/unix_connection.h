@@ -0,0 +1,155 @@
+/// \file unix_connection.h
+/// \brief Class serving framed records over the Unix domain socket.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_SOCKET_CONNECTION_UNIX_CONNECTION_H_
+#define CRYPTO_WALLET_SOCKET_CONNECTION_UNIX_CONNECTION_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace socket_communication
+/// \brief Interprocess communication namespace.
+namespace socket_communication {
+/// \brief Size of the frame header holding payload length (network byte order).
+constexpr std::size_t kFrameHeaderSize = 4;
+
+/// \brief Max payload size, client sending bigger frame is disconnected.
+constexpr std::size_t kMaxFrameSize = 16 * 1024 * 1024;
+
+/// \brief Append length-prefixed frame to the buffer.
+/// \param[out] buffer Buffer.
+/// \param[in] record Frame payload.
+void AppendFrame(std::string &buffer, std::string_view record);
+
+/// \class UnixConnection unix_connection.h.
+/// \brief Non-blocking epoll server accepting clients on the Unix domain socket.
+/// \details Clients send records as frames: 4 byte payload length followed by
+/// \details the payload. Records are passed to the handler as views into the
+/// \details receive buffer, valid only during the handler call. Client whose record
+/// \details the handler could not take is not read until it takes it, so socket
+/// \details buffers push back on that client while the others are still served.
+class UnixConnection {
+ public:
+  /// \brief Record handler.
+  /// \param[in] record Record payload.
+  /// \return false if the record cannot be taken now, it is passed again later.
+  using RecordHandler = std::function<bool(std::string_view record)>;
+
+  /// \struct Metrics unix_connection.h.
+  /// \brief Server counters.
+  struct Metrics {
+    uint64_t accepted_clients{0};
+    uint64_t active_clients{0};
+    uint64_t records{0};
+    uint64_t bytes{0};
+    uint64_t dropped_clients{0};
+    // times a client stopped being read because the handler took no more records
+    uint64_t paused_clients{0};
+  };
+
+  /// \brief UnixConnection constructor.
+  UnixConnection() = default;
+
+  /// \brief UnixConnection destructor.
+  ~UnixConnection();
+
+  /// \brief Class UnixConnection copy constructor.
+  /// \param[in] unix_connection Class UnixConnection object.
+  UnixConnection(const UnixConnection &unix_connection) = delete;
+
+  /// \brief Class UnixConnection copy assignment.
+  /// \param[in] unix_connection Class UnixConnection object.
+  /// \return UnixConnection object.
+  UnixConnection &operator=(const UnixConnection &unix_connection) = delete;
+
+  /// \brief Bind listening socket.
+  /// \param[in] socket_path Socket file path, stale file is removed.
+  /// \return 0 on success, errno otherwise.
+  int32_t Bind(const std::string &socket_path);
+
+  /// \brief Set handler of the received records.
+  /// \param[in] record_handler Record handler.
+  void SetRecordHandler(RecordHandler record_handler);
+
+  /// \brief Serve clients until Stop is called.
+  /// \return 0 on success, errno otherwise.
+  int32_t Run();
+
+  /// \brief Wake up and stop the server loop, safe to call from any thread.
+  void Stop() noexcept;
+
+  /// \brief Get server counters.
+  /// \return Counters snapshot.
+  Metrics GetMetrics() const noexcept;
+
+ private:
+  /// \brief Accept all pending clients.
+  void AcceptClients();
+
+  /// \brief Read available data of the client and pass complete records on.
+  /// \details At most kMaxReadPerWakeup bytes are read, so one busy client does not
+  /// \details starve the others; epoll reports the rest on the next wakeup.
+  /// \param[in] client_fd Client socket.
+  /// \return false if the client has to be closed.
+  bool ReadClient(int32_t client_fd);
+
+  /// \struct ClientBuffer unix_connection.h.
+  /// \brief Receive buffer of the client, grown only, never shrunk.
+  struct ClientBuffer {
+    std::vector<char> data{};
+    std::size_t size{0};
+    // peer closed the connection while its records were still buffered
+    bool is_peer_closed{false};
+  };
+
+  /// \brief Pass complete frames of the buffer to the handler.
+  /// \param[in] buffer Client buffer, handled frames are removed.
+  /// \param[out] is_paused Set if the handler did not take a record.
+  /// \return false if the buffer holds a frame bigger than kMaxFrameSize.
+  bool HandleFrames(ClientBuffer &buffer, bool &is_paused);
+
+  /// \brief Stop reading the client until its buffered records are taken.
+  /// \param[in] client_fd Client socket.
+  void PauseClient(int32_t client_fd) noexcept;
+
+  /// \brief Offer buffered records of the paused clients again, clients whose
+  /// \brief records were all taken are read again.
+  void ResumeClients();
+
+  /// \brief Close client socket and drop its buffer.
+  /// \param[in] client_fd Client socket.
+  void CloseClient(int32_t client_fd) noexcept;
+
+  /// \brief Close all sockets.
+  void Close() noexcept;
+
+  std::string socket_path_{};
+  int32_t listen_fd_{-1};
+  int32_t epoll_fd_{-1};
+  int32_t stop_fd_{-1};
+  RecordHandler record_handler_{};
+  std::unordered_map<int32_t, ClientBuffer> client_buffers_{};
+  // clients removed from epoll until the handler takes their records
+  std::vector<int32_t> paused_clients_{};
+  std::atomic<uint64_t> accepted_clients_{0};
+  std::atomic<uint64_t> active_clients_{0};
+  std::atomic<uint64_t> records_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> dropped_clients_{0};
+  std::atomic<uint64_t> paused_count_{0};
+};
+}  // namespace socket_communication
+}  // namespace crypto_wallet
+
+#endif // CRYPTO_WALLET_SOCKET_CONNECTION_UNIX_CONNECTION_H_
@@ -0,0 +1,103 @@
+/// \file bulk_importer_test.cpp
+/// \brief Tests of CSV splitting of class BulkImporter.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bulk_importer/bulk_importer.h"
+#include "check.h"
+
+namespace {
+  using crypto_wallet::client::BulkImporter;
+
+  constexpr BulkImporter::SimdLevel kSimdLevels[] = {BulkImporter::SimdLevel::kScalar,
+                                                     BulkImporter::SimdLevel::kSse2,
+                                                     BulkImporter::SimdLevel::kAvx2};
+
+  using Rows = std::vector<std::vector<std::string>>;
+
+  Rows Split(std::string_view text, char delimiter, BulkImporter::SimdLevel simd_level) {
+    std::vector<std::string_view> fields;
+    std::vector<std::size_t> fields_per_row;
+    std::deque<std::string> unescaped;
+    BulkImporter::Split(text, delimiter, simd_level, fields, fields_per_row, unescaped);
+    Rows rows;
+    std::size_t field{0};
+    for (auto count : fields_per_row) {
+      rows.emplace_back(fields.begin() + field, fields.begin() + field + count);
+      field += count;
+    }
+    return rows;
+  }
+
+  // levels the CPU lacks fall back to the supported one
+  void CheckSplit(std::string_view text, char delimiter, const Rows &expected) {
+    for (auto simd_level : kSimdLevels)
+      CHECK(Split(text, delimiter, simd_level) == expected);
+  }
+
+  void TestRows() {
+    CheckSplit("", ',', Rows{});
+    CheckSplit("a,b,c", ',', Rows{{"a", "b", "c"}});
+    CheckSplit("a,b,c\n1,2,3\n", ',', Rows{{"a", "b", "c"}, {"1", "2", "3"}});
+    CheckSplit("a;b\tc\n", ';', Rows{{"a", "b\tc"}});
+    CheckSplit("a\tb\n", '\t', Rows{{"a", "b"}});
+  }
+
+  void TestEmptyFields() {
+    CheckSplit(",,\n", ',', Rows{{"", "", ""}});
+    CheckSplit("a\n\nb\n", ',', Rows{{"a"}, {""}, {"b"}});
+    CheckSplit("a,\n", ',', Rows{{"a", ""}});
+    CheckSplit("\n", ',', Rows{{""}});
+  }
+
+  void TestLineEndings() {
+    CheckSplit("a,b\r\nc,d\r\n", ',', Rows{{"a", "b"}, {"c", "d"}});
+    CheckSplit("a,b\r", ',', Rows{{"a", "b"}});
+    // carriage return inside the row is data
+    CheckSplit("a\r,b\n", ',', Rows{{"a\r", "b"}});
+  }
+
+  void TestQuotes() {
+    CheckSplit("\"a,b\",c\n", ',', Rows{{"a,b", "c"}});
+    CheckSplit("\"line\nbreak\",x\n", ',', Rows{{"line\nbreak", "x"}});
+    // doubled quotes stand for one quote
+    CheckSplit("\"say \"\"hi\"\"\",1\n", ',', Rows{{"say \"hi\"", "1"}});
+    CheckSplit("\"\"\"\"\"\",\"a\"\"b\",\"c\"\n", ',', Rows{{"\"\"", "a\"b", "c"}});
+    CheckSplit("\"\",\"\"\n", ',', Rows{{"", ""}});
+    CheckSplit("\"q\"\r\n", ',', Rows{{"q"}});
+    // unterminated quote runs to the end of the text
+    CheckSplit("\"open,end\n", ',', Rows{{"open,end\n"}});
+    // quote inside the unquoted field is data
+    CheckSplit("a\"b,c\n", ',', Rows{{"a\"b", "c"}});
+  }
+
+  void TestBlockBoundaries() {
+    // fields crossing the 64 byte blocks, separators on every offset of the block
+    std::string text;
+    Rows expected_rows;
+    std::vector<std::string> values;
+    for (std::size_t length = 0; length < 140; ++length)
+      values.push_back(std::string(length, static_cast<char>('a' + length % 26)));
+    for (std::size_t i = 0; i < values.size(); i += 3) {
+      text += values[i] + "," + values[i + 1] + "," + values[i + 2] + "\n";
+      expected_rows.push_back({values[i], values[i + 1], values[i + 2]});
+    }
+    CheckSplit(text, ',', expected_rows);
+    CHECK(Split(text, ',', BulkImporter::SimdLevel::kAuto) == expected_rows);
+  }
+}
+
+int main() {
+  TestRows();
+  TestEmptyFields();
+  TestLineEndings();
+  TestQuotes();
+  TestBlockBoundaries();
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
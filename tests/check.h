@@ -0,0 +1,33 @@
+/// \file check.h
+/// \brief Check macro of the test executables.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#ifndef CRYPTO_WALLET_TESTS_CHECK_H_
+#define CRYPTO_WALLET_TESTS_CHECK_H_
+
+#include <iostream>
+
+/// \namespace crypto_wallet.
+/// \brief Project namespace.
+namespace crypto_wallet {
+/// \namespace test
+/// \brief Test namespace.
+namespace test {
+  // number of failed checks, main returns non-zero once it is not zero
+  inline int failures_count{0};
+}  // namespace test
+}  // namespace crypto_wallet
+
+// Checks stay enabled in release builds, unlike assert.
+#define CHECK(condition)                                                              \
+  do {                                                                                \
+    if (!(condition)) {                                                               \
+      std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " << #condition    \
+                << std::endl;                                                         \
+      ++crypto_wallet::test::failures_count;                                          \
+    }                                                                                 \
+  } while (false)
+
+#endif // CRYPTO_WALLET_TESTS_CHECK_H_
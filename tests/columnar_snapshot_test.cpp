@@ -0,0 +1,183 @@
+/// \file columnar_snapshot_test.cpp
+/// \brief Tests of corrupted snapshot rejection by class ColumnarReader.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "check.h"
+#include "columnar_snapshot/columnar_snapshot.h"
+
+namespace {
+  using crypto_wallet::client::ColumnarReader;
+  using crypto_wallet::client::ColumnarWriter;
+  namespace columnar = crypto_wallet::client::columnar;
+
+  const std::string kSnapshotPath = "columnar_snapshot_test.cols";
+  const std::string kCorruptedPath = "columnar_snapshot_test_corrupted.cols";
+
+  std::string ReadFile(const std::string &path) {
+    std::ifstream file{path, std::ios::binary};
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  }
+
+  void WriteFile(const std::string &path, const std::string &data) {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+
+  template <typename T>
+  T Load(const std::string &data, uint64_t offset) {
+    T value{};
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+    return value;
+  }
+
+  template <typename T>
+  void Store(std::string &data, uint64_t offset, const T &value) {
+    std::memcpy(&data[offset], &value, sizeof(value));
+  }
+
+  // Offset of ChunkMeta of the column in the first row group.
+  uint64_t FindChunkMeta(const std::string &data, uint64_t column) {
+    auto trailer = Load<columnar::Trailer>(data, data.size() - sizeof(columnar::Trailer));
+    auto pos = trailer.footer_offset;
+    auto header = Load<columnar::FooterHeader>(data, pos);
+    pos += sizeof(header);
+    for (uint64_t i = 0; i < header.columns_count; ++i) {
+      auto length = Load<uint64_t>(data, pos);
+      pos += sizeof(length) + length + (8 - length % 8) % 8;
+    }
+    return pos + sizeof(uint64_t) + column * sizeof(columnar::ChunkMeta);
+  }
+
+  int32_t OpenCorrupted(const std::string &data) {
+    WriteFile(kCorruptedPath, data);
+    ColumnarReader reader;
+    return reader.Open(kCorruptedPath);
+  }
+
+  bool ExportSnapshot() {
+    sqlite3 *database{nullptr};
+    sqlite3_open(":memory:", &database);
+    auto res = sqlite3_exec(database,
+                            "CREATE TABLE tx (id, address, amount);"
+                            "INSERT INTO tx VALUES (1, 'a', 1.5), (2, NULL, 2.5), (3, 'b', 3.5),"
+                            "(4, 'a', NULL);",
+                            nullptr, nullptr, nullptr);
+    ColumnarWriter::Report report;
+    if (res == SQLITE_OK)
+      res = ColumnarWriter{ColumnarWriter::Options{}}.Export(database, "tx", kSnapshotPath,
+                                                              report);
+    sqlite3_close(database);
+    return res == SQLITE_OK && report.rows == 4;
+  }
+
+  void TestValidSnapshot() {
+    ColumnarReader reader;
+    CHECK(reader.Open(kSnapshotPath) == SQLITE_OK);
+    CHECK(reader.GetRowsCount() == 4);
+    CHECK(reader.GetRowGroupsCount() == 1);
+    auto address = reader.FindColumn("address");
+    CHECK(address == 1);
+    if (address != 1)
+      return;
+    const auto &chunk = reader.GetChunk(0, address);
+    CHECK(chunk.GetEncoding() == columnar::Encoding::kDictionary);
+    CHECK(chunk.GetDictionarySize() == 2);
+    CHECK(chunk.IsNull(1));
+    CHECK(chunk.GetText(0) == "a" && chunk.GetText(2) == "b" && chunk.GetText(3) == "a");
+  }
+
+  void TestMissingFile() {
+    ColumnarReader reader;
+    CHECK(reader.Open("columnar_snapshot_test_missing.cols") == SQLITE_CANTOPEN);
+    CHECK(OpenCorrupted("") == SQLITE_CANTOPEN);
+  }
+
+  void TestBadFrame() {
+    const auto data = ReadFile(kSnapshotPath);
+    CHECK(OpenCorrupted(data.substr(0, 8)) == SQLITE_CORRUPT);
+    CHECK(OpenCorrupted(data.substr(0, data.size() - 1)) == SQLITE_CORRUPT);
+
+    auto corrupted = data;
+    corrupted[0] = 'X';
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    corrupted = data;
+    auto trailer_offset = data.size() - sizeof(columnar::Trailer);
+    auto trailer = Load<columnar::Trailer>(data, trailer_offset);
+    trailer.footer_size = data.size();
+    Store(corrupted, trailer_offset, trailer);
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    corrupted = data;
+    auto header = Load<columnar::FooterHeader>(data, trailer.footer_offset);
+    ++header.rows_count;
+    Store(corrupted, trailer.footer_offset, header);
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+  }
+
+  void TestBadChunks() {
+    const auto data = ReadFile(kSnapshotPath);
+    const auto id_meta_offset = FindChunkMeta(data, 0);
+    const auto address_meta_offset = FindChunkMeta(data, 1);
+    const auto id_meta = Load<columnar::ChunkMeta>(data, id_meta_offset);
+    const auto address_meta = Load<columnar::ChunkMeta>(data, address_meta_offset);
+    CHECK(id_meta.encoding == columnar::Encoding::kInt64);
+    CHECK(address_meta.encoding == columnar::Encoding::kDictionary);
+
+    auto corrupted = data;
+    auto meta = id_meta;
+    meta.data_offset = data.size() + 8;
+    Store(corrupted, id_meta_offset, meta);
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    corrupted = data;
+    meta = id_meta;
+    meta.data_size = sizeof(int64_t);
+    Store(corrupted, id_meta_offset, meta);
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    corrupted = data;
+    meta = id_meta;
+    meta.encoding = static_cast<columnar::Encoding>(7);
+    Store(corrupted, id_meta_offset, meta);
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    // dictionary offsets must not go back
+    corrupted = data;
+    auto dictionary_offsets = address_meta.data_offset + sizeof(uint64_t);
+    Store(corrupted, dictionary_offsets + sizeof(uint64_t), uint64_t{1000});
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    // code of the non-NULL row out of the dictionary
+    corrupted = data;
+    Store(corrupted, address_meta.codes_offset, uint32_t{2});
+    CHECK(OpenCorrupted(corrupted) == SQLITE_CORRUPT);
+
+    // code of the NULL row is never read
+    corrupted = data;
+    Store(corrupted, address_meta.codes_offset + sizeof(uint32_t), uint32_t{0xffffffff});
+    CHECK(OpenCorrupted(corrupted) == SQLITE_OK);
+  }
+}
+
+int main() {
+  CHECK(ExportSnapshot());
+  if (!crypto_wallet::test::failures_count) {
+    TestValidSnapshot();
+    TestMissingFile();
+    TestBadFrame();
+    TestBadChunks();
+  }
+  std::remove(kSnapshotPath.c_str());
+  std::remove(kCorruptedPath.c_str());
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+/// \file database_backup_test.cpp
+/// \brief Tests of differential backup of class DatabaseBackup.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "check.h"
+#include "database_backup/database_backup.h"
+
+namespace {
+  using crypto_wallet::client::DatabaseBackup;
+
+  void RemoveDataBase(const std::string &db_name) {
+    for (const auto &suffix : {"", "-wal", "-shm", "-journal", "-undo"})
+      std::remove((db_name + suffix).c_str());
+  }
+
+  sqlite3 *OpenTracked(const std::string &db_name, const std::string &journal_mode) {
+    sqlite3 *database{nullptr};
+    sqlite3_open_v2(db_name.c_str(), &database, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                    DatabaseBackup::RegisterChangeTrackingVfs());
+    sqlite3_busy_timeout(database, 1000);
+    sqlite3_exec(database, ("PRAGMA journal_mode=" + journal_mode + ";"
+                            "CREATE TABLE IF NOT EXISTS tx (id INTEGER PRIMARY KEY, payload);")
+                              .c_str(),
+                 nullptr, nullptr, nullptr);
+    return database;
+  }
+
+  void InsertRows(sqlite3 *database, int32_t first_id, int32_t count) {
+    sqlite3_exec(database, "BEGIN;", nullptr, nullptr, nullptr);
+    for (int32_t id = first_id; id < first_id + count; ++id)
+      sqlite3_exec(database, ("INSERT INTO tx VALUES (" + std::to_string(id) +
+                              ", randomblob(200));").c_str(),
+                   nullptr, nullptr, nullptr);
+    sqlite3_exec(database, "COMMIT;", nullptr, nullptr, nullptr);
+  }
+
+  std::string QueryText(sqlite3 *database, const std::string &sql_script) {
+    std::string res;
+    sqlite3_stmt *stmt{nullptr};
+    if (sqlite3_prepare_v2(database, sql_script.c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_text(stmt, 0))
+      res = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    sqlite3_finalize(stmt);
+    return res;
+  }
+
+  // Checksum of all rows, equal for the source and an exact backup.
+  const std::string kContentQuery = "SELECT count(*) || ':' || total(id) || ':' || "
+                                    "coalesce(sum(length(payload) * id), 0) || ':' || "
+                                    "hex(max(payload)) FROM tx;";
+
+  std::string QueryBackup(const std::string &backup_name, const std::string &sql_script) {
+    sqlite3 *backup_db{nullptr};
+    sqlite3_open_v2(backup_name.c_str(), &backup_db, SQLITE_OPEN_READONLY, nullptr);
+    auto res = QueryText(backup_db, sql_script);
+    sqlite3_close(backup_db);
+    return res;
+  }
+
+  DatabaseBackup::Options MakeOptions(int32_t pages_per_step) {
+    DatabaseBackup::Options options;
+    options.pages_per_step = pages_per_step;
+    options.step_pause = std::chrono::milliseconds{0};
+    options.is_differential = true;
+    options.max_restarts = 1000;
+    return options;
+  }
+
+  void TestDifferential(const std::string &journal_mode) {
+    const std::string db_name = "database_backup_test_" + journal_mode + "_db";
+    const std::string backup_name = db_name + "_backup";
+    RemoveDataBase(db_name);
+    RemoveDataBase(backup_name);
+    auto database = OpenTracked(db_name, journal_mode);
+    InsertRows(database, 0, 2000);
+
+    DatabaseBackup backup;
+    CHECK(backup.Start(database, backup_name, MakeOptions(16)) == SQLITE_OK);
+    CHECK(backup.Wait() == SQLITE_OK);
+    auto progress = backup.GetProgress();
+    CHECK(progress.total_pages > 100 && progress.copied_pages == progress.total_pages);
+    CHECK(QueryBackup(backup_name, "PRAGMA integrity_check;") == "ok");
+    CHECK(QueryBackup(backup_name, kContentQuery) == QueryText(database, kContentQuery));
+
+    // only pages of the new rows and the pages pointing to them are copied again
+    InsertRows(database, 2000, 10);
+    CHECK(backup.Start(database, backup_name, MakeOptions(16)) == SQLITE_OK);
+    CHECK(backup.Wait() == SQLITE_OK);
+    progress = backup.GetProgress();
+    CHECK(progress.copied_pages > 0 && progress.copied_pages < 16);
+    CHECK(QueryBackup(backup_name, kContentQuery) == QueryText(database, kContentQuery));
+
+    // writes during the pass end up in the backup up to the snapshot of its last step
+    std::atomic<bool> is_writing{true};
+    std::atomic<int32_t> batches_count{0};
+    std::thread writer{[&]() {
+      for (int32_t id = 3000; is_writing.load(); id += 5) {
+        InsertRows(database, id, 5);
+        ++batches_count;
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+    }};
+    while (batches_count.load() < 10)
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    CHECK(backup.Start(database, backup_name, MakeOptions(16)) == SQLITE_OK);
+    CHECK(backup.Wait() == SQLITE_OK);
+    is_writing = false;
+    writer.join();
+    CHECK(QueryBackup(backup_name, "PRAGMA integrity_check;") == "ok");
+    CHECK(std::stoi("0" + QueryBackup(backup_name, "SELECT count(*) FROM tx;")) >= 2010);
+
+    // cancelled pass rolls the backup back from the undo file
+    auto expected = QueryBackup(backup_name, kContentQuery);
+    sqlite3_exec(database, "UPDATE tx SET payload = randomblob(210);", nullptr, nullptr,
+                 nullptr);
+    auto options = MakeOptions(1);
+    options.progress_handler = [&backup](const DatabaseBackup::Progress &progress) {
+      if (progress.copied_pages >= 10)
+        backup.Cancel();
+    };
+    CHECK(backup.Start(database, backup_name, options) == SQLITE_OK);
+    CHECK(backup.Wait() == SQLITE_INTERRUPT);
+    CHECK(QueryBackup(backup_name, kContentQuery) == expected);
+    auto undo_file = std::fopen((backup_name + "-undo").c_str(), "r");
+    CHECK(!undo_file);
+    if (undo_file)
+      std::fclose(undo_file);
+
+    // pages taken by the cancelled pass are copied by the next one
+    CHECK(backup.Start(database, backup_name, MakeOptions(64)) == SQLITE_OK);
+    CHECK(backup.Wait() == SQLITE_OK);
+    CHECK(QueryBackup(backup_name, "PRAGMA integrity_check;") == "ok");
+    CHECK(QueryBackup(backup_name, kContentQuery) == QueryText(database, kContentQuery));
+
+    sqlite3_close(database);
+    RemoveDataBase(db_name);
+    RemoveDataBase(backup_name);
+  }
+
+  void TestUntrackedFallsBackToFull() {
+    const std::string db_name = "database_backup_test_untracked_db";
+    const std::string backup_name = db_name + "_backup";
+    RemoveDataBase(db_name);
+    RemoveDataBase(backup_name);
+    sqlite3 *database{nullptr};
+    sqlite3_open(db_name.c_str(), &database);
+    sqlite3_exec(database, "CREATE TABLE tx (id INTEGER PRIMARY KEY, payload);", nullptr,
+                 nullptr, nullptr);
+    InsertRows(database, 0, 100);
+
+    DatabaseBackup backup;
+    CHECK(backup.Start(database, backup_name, MakeOptions(16)) == SQLITE_OK);
+    CHECK(backup.Wait() == SQLITE_OK);
+    CHECK(QueryBackup(backup_name, kContentQuery) == QueryText(database, kContentQuery));
+    sqlite3_close(database);
+    RemoveDataBase(db_name);
+    RemoveDataBase(backup_name);
+  }
+}
+
+int main() {
+  CHECK(DatabaseBackup::RegisterChangeTrackingVfs() != nullptr);
+  TestDifferential("delete");
+  TestDifferential("wal");
+  TestUntrackedFallsBackToFull();
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/// \file handle_registry_test.cpp
+/// \brief Tests of eviction by class HandleRegistry.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "handle_registry/handle_registry.h"
+
+namespace {
+  using crypto_wallet::client::HandleRegistry;
+
+  // Handle recording its opens and closes, memory usage is set per path.
+  class TestHandle {
+   public:
+    explicit TestHandle(const std::string &path) : path_{path} {
+      if (path == "broken")
+        throw std::runtime_error{"cannot open"};
+      opened_paths.push_back(path);
+    }
+
+    ~TestHandle() {
+      closed_paths.push_back(path_);
+    }
+
+    std::size_t GetMemoryUsage() const noexcept {
+      ++measures_count;
+      return path_.compare(0, 3, "big") == 0 ? 100 : 1;
+    }
+
+    mutable uint32_t measures_count{0};
+
+    static inline std::vector<std::string> opened_paths{};
+    static inline std::vector<std::string> closed_paths{};
+
+   private:
+    std::string path_;
+  };
+
+  using Registry = HandleRegistry<TestHandle>;
+
+  Registry::Options MakeOptions(std::size_t max_open_handles, std::size_t memory_budget) {
+    Registry::Options options;
+    options.max_open_handles = max_open_handles;
+    options.memory_budget = memory_budget;
+    return options;
+  }
+
+  void TestLeastRecentlyUsedEvicted() {
+    TestHandle::closed_paths.clear();
+    Registry registry{MakeOptions(2, 1000)};
+    auto first = registry.Acquire("a").get();
+    registry.Acquire("b");
+    // hit moves "a" to the front, "b" becomes the least recently used
+    CHECK(registry.Acquire("a").get() == first);
+    registry.Acquire("c");
+    CHECK(TestHandle::closed_paths == std::vector<std::string>{"b"});
+    auto metrics = registry.GetMetrics();
+    CHECK(metrics.opens == 3 && metrics.hits == 1 && metrics.evictions == 1);
+    CHECK(metrics.open_handles == 2);
+
+    // evicted path is opened again on the next use
+    registry.Acquire("b");
+    metrics = registry.GetMetrics();
+    CHECK(metrics.reopens == 1 && metrics.evictions == 2);
+    CHECK(TestHandle::closed_paths == (std::vector<std::string>{"b", "a"}));
+  }
+
+  void TestHeldAndPinnedKept() {
+    TestHandle::closed_paths.clear();
+    Registry registry{MakeOptions(2, 1000)};
+    auto &pinned = registry.AcquirePinned("pinned");
+    auto held = registry.Acquire("held");
+    registry.Acquire("idle");
+    // only idle handles are closed, the budget may be exceeded otherwise
+    CHECK(TestHandle::closed_paths.empty());
+    CHECK(registry.GetMetrics().open_handles == 3);
+    registry.Acquire("next");
+    CHECK(TestHandle::closed_paths == std::vector<std::string>{"idle"});
+    CHECK(&registry.AcquirePinned("pinned") == &pinned);
+
+    held.reset();
+    registry.Acquire("last");
+    CHECK(TestHandle::closed_paths == (std::vector<std::string>{"idle", "held", "next"}));
+    auto metrics = registry.GetMetrics();
+    CHECK(metrics.pinned_handles == 1 && metrics.open_handles == 2);
+  }
+
+  void TestMemoryBudget() {
+    TestHandle::closed_paths.clear();
+    Registry registry{MakeOptions(100, 150)};
+    registry.Acquire("big1");
+    registry.Acquire("small");
+    CHECK(TestHandle::closed_paths.empty());
+    registry.Acquire("big2");
+    CHECK(TestHandle::closed_paths.empty());
+    // 201 bytes are over the budget, oldest idle handles go until it fits
+    registry.Acquire("big3");
+    CHECK(TestHandle::closed_paths == std::vector<std::string>{"big1"});
+    auto metrics = registry.GetMetrics();
+    CHECK(metrics.memory_usage == 101 && metrics.open_handles == 3);
+
+    registry.SetOptions(MakeOptions(100, 50));
+    registry.Acquire("small2");
+    CHECK(TestHandle::closed_paths == (std::vector<std::string>{"big1", "small", "big2",
+                                                                "big3"}));
+    CHECK(registry.GetMetrics().open_handles == 1);
+  }
+
+  void TestHeldNotMeasured() {
+    TestHandle::closed_paths.clear();
+    Registry registry{MakeOptions(100, 150)};
+    auto held = registry.Acquire("big_held");
+    auto measures_count = held->measures_count;
+    registry.Acquire("small");
+    registry.Acquire("small2");
+    // handle in use is counted with the usage measured at open
+    CHECK(held->measures_count == measures_count);
+    CHECK(registry.GetMetrics().memory_usage == 101);
+
+    held.reset();
+    registry.Acquire("big2");
+    CHECK(TestHandle::closed_paths.empty());
+    registry.Acquire("big3");
+    CHECK(TestHandle::closed_paths == std::vector<std::string>{"big_held"});
+  }
+
+  void TestFailedOpen() {
+    Registry registry{MakeOptions(2, 1000)};
+    bool is_thrown{false};
+    try {
+      registry.Acquire("broken");
+    } catch (const std::runtime_error &) {
+      is_thrown = true;
+    }
+    CHECK(is_thrown);
+    CHECK(registry.GetMetrics().open_handles == 0 && registry.GetMetrics().opens == 0);
+
+    int initialized_count{0};
+    registry.SetInitializer([&initialized_count](TestHandle &, const std::string &) {
+      ++initialized_count;
+    });
+    registry.Acquire("a");
+    registry.Acquire("a");
+    CHECK(initialized_count == 1);
+  }
+}
+
+int main() {
+  TestLeastRecentlyUsedEvicted();
+  TestHeldAndPinnedKept();
+  TestMemoryBudget();
+  TestHeldNotMeasured();
+  TestFailedOpen();
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
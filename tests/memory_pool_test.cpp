@@ -0,0 +1,122 @@
+/// \file memory_pool_test.cpp
+/// \brief Tests of class MemoryPool size classes.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "memory_pool/memory_pool.h"
+
+namespace {
+  using crypto_wallet::client::MemoryPool;
+
+  void TestRoundedSize() {
+    CHECK(MemoryPool::GetRoundedSize(0) == 16);
+    CHECK(MemoryPool::GetRoundedSize(1) == 16);
+    CHECK(MemoryPool::GetRoundedSize(16) == 16);
+    CHECK(MemoryPool::GetRoundedSize(17) == 32);
+    CHECK(MemoryPool::GetRoundedSize(128) == 128);
+    CHECK(MemoryPool::GetRoundedSize(129) == 160);
+    CHECK(MemoryPool::GetRoundedSize(160) == 160);
+    CHECK(MemoryPool::GetRoundedSize(161) == 192);
+    CHECK(MemoryPool::GetRoundedSize(256) == 256);
+    CHECK(MemoryPool::GetRoundedSize(257) == 320);
+    CHECK(MemoryPool::GetRoundedSize(MemoryPool::kMaxPooledSize) == MemoryPool::kMaxPooledSize);
+    CHECK(MemoryPool::GetRoundedSize(MemoryPool::kMaxPooledSize + 1) ==
+          MemoryPool::kMaxPooledSize + 8);
+  }
+
+  void TestSizeClassBounds() {
+    // classes grow by a quarter of the power of two, so waste stays below 25%
+    std::size_t previous{0};
+    std::size_t classes_count{0};
+    bool is_valid{true};
+    for (std::size_t size = 1; size <= MemoryPool::kMaxPooledSize; ++size) {
+      auto rounded = MemoryPool::GetRoundedSize(size);
+      is_valid = is_valid && rounded >= size && rounded % 16 == 0 &&
+                 MemoryPool::GetRoundedSize(rounded) == rounded &&
+                 (size <= 128 || rounded - size < size / 4 + 1) && rounded >= previous;
+      if (rounded != previous)
+        ++classes_count;
+      previous = rounded;
+    }
+    CHECK(is_valid);
+    CHECK(classes_count == MemoryPool::kSizeClassCount);
+  }
+
+  void TestAllocate() {
+    auto &pool = MemoryPool::GetInstance();
+    auto before = pool.GetStats();
+    std::vector<void *> blocks;
+    for (std::size_t size : {1, 24, 100, 129, 1000, 4096, 32768}) {
+      auto ptr = pool.Allocate(size);
+      CHECK(ptr);
+      CHECK(reinterpret_cast<uintptr_t>(ptr) % 16 == 0);
+      CHECK(pool.GetSize(ptr) == MemoryPool::GetRoundedSize(size));
+      std::memset(ptr, 0xab, pool.GetSize(ptr));
+      blocks.push_back(ptr);
+    }
+    auto large = pool.Allocate(MemoryPool::kMaxPooledSize + 1);
+    CHECK(large && pool.GetSize(large) >= MemoryPool::kMaxPooledSize + 1);
+    auto after = pool.GetStats();
+    CHECK(after.allocations - before.allocations == blocks.size() + 1);
+    CHECK(after.system_allocations - before.system_allocations == 1);
+
+    // released block is handed out again for the same size class
+    auto reused = blocks[2];
+    pool.Deallocate(reused);
+    blocks[2] = pool.Allocate(MemoryPool::GetRoundedSize(100));
+    CHECK(blocks[2] == reused);
+
+    for (auto ptr : blocks)
+      pool.Deallocate(ptr);
+    pool.Deallocate(large);
+    pool.Deallocate(nullptr);
+    CHECK(pool.GetStats().deallocations - before.deallocations == blocks.size() + 2);
+  }
+
+  void TestReallocate() {
+    auto &pool = MemoryPool::GetInstance();
+    auto ptr = static_cast<char *>(pool.Allocate(130));
+    std::memcpy(ptr, "size class", 11);
+    // 130 and 150 share the 160 bytes class
+    auto same = static_cast<char *>(pool.Reallocate(ptr, 150));
+    CHECK(same == ptr);
+    auto grown = static_cast<char *>(pool.Reallocate(same, 5000));
+    CHECK(grown && pool.GetSize(grown) == MemoryPool::GetRoundedSize(5000));
+    CHECK(std::memcmp(grown, "size class", 11) == 0);
+    auto huge = static_cast<char *>(pool.Reallocate(grown, MemoryPool::kMaxPooledSize * 2));
+    CHECK(huge && std::memcmp(huge, "size class", 11) == 0);
+    pool.Deallocate(huge);
+  }
+
+  void TestCrossThreadRelease() {
+    auto &pool = MemoryPool::GetInstance();
+    std::vector<void *> blocks;
+    for (int i = 0; i < 1000; ++i)
+      blocks.push_back(pool.Allocate(64));
+    // blocks of one thread released by another go through the central lists
+    std::thread releaser{[&]() {
+      for (auto ptr : blocks)
+        pool.Deallocate(ptr);
+    }};
+    releaser.join();
+    auto ptr = pool.Allocate(64);
+    CHECK(ptr && pool.GetSize(ptr) == 64);
+    pool.Deallocate(ptr);
+  }
+}
+
+int main() {
+  TestRoundedSize();
+  TestSizeClassBounds();
+  TestAllocate();
+  TestReallocate();
+  TestCrossThreadRelease();
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
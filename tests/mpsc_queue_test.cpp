@@ -0,0 +1,115 @@
+/// \file mpsc_queue_test.cpp
+/// \brief Tests of class MpscQueue.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "mpsc_queue/mpsc_queue.h"
+
+namespace {
+  using crypto_wallet::client::MpscQueue;
+
+  void TestCapacity() {
+    CHECK(MpscQueue<int>{0}.GetCapacity() == 2);
+    CHECK(MpscQueue<int>{2}.GetCapacity() == 2);
+    CHECK(MpscQueue<int>{3}.GetCapacity() == 4);
+    CHECK(MpscQueue<int>{1000}.GetCapacity() == 1024);
+  }
+
+  void TestFifoAndFull() {
+    MpscQueue<int> queue{4};
+    int value{0};
+    CHECK(!queue.TryPop(value));
+    for (int i = 0; i < 4; ++i)
+      CHECK(queue.TryPush(int{i}));
+    CHECK(!queue.TryPush(4));
+    for (int i = 0; i < 4; ++i) {
+      CHECK(queue.TryPop(value));
+      CHECK(value == i);
+    }
+    CHECK(!queue.TryPop(value));
+  }
+
+  void TestWrapAround() {
+    MpscQueue<uint64_t> queue{8};
+    uint64_t next_push{0};
+    uint64_t next_pop{0};
+    uint64_t value{0};
+    // cells are reused many times with the queue partly filled
+    for (int round = 0; round < 10000; ++round) {
+      for (int i = 0; i < 5; ++i)
+        CHECK(queue.TryPush(uint64_t{next_push++}));
+      for (int i = 0; i < 5; ++i) {
+        CHECK(queue.TryPop(value));
+        CHECK(value == next_pop++);
+      }
+    }
+    CHECK(!queue.TryPop(value));
+  }
+
+  void TestValueKeptWhenFull() {
+    MpscQueue<std::unique_ptr<int>> queue{2};
+    CHECK(queue.TryPush(std::make_unique<int>(1)));
+    CHECK(queue.TryPush(std::make_unique<int>(2)));
+    auto rejected = std::make_unique<int>(3);
+    CHECK(!queue.TryPush(std::move(rejected)));
+    CHECK(rejected && *rejected == 3);
+    std::unique_ptr<int> value;
+    CHECK(queue.TryPop(value) && value && *value == 1);
+    CHECK(queue.TryPush(std::move(rejected)));
+    CHECK(queue.TryPop(value) && *value == 2);
+    CHECK(queue.TryPop(value) && *value == 3);
+  }
+
+  void TestProducers() {
+    constexpr uint64_t kProducersCount = 4;
+    constexpr uint64_t kValuesCount = 100000;
+    MpscQueue<uint64_t> queue{64};
+    std::vector<std::thread> producers;
+    for (uint64_t producer = 0; producer < kProducersCount; ++producer)
+      producers.emplace_back([&queue, producer]() {
+        for (uint64_t i = 0; i < kValuesCount; ++i)
+          while (!queue.TryPush((producer << 32) | i))
+            std::this_thread::yield();
+      });
+
+    // values of every producer come out in the order they were pushed
+    std::vector<uint64_t> next(kProducersCount, 0);
+    uint64_t popped{0};
+    uint64_t value{0};
+    bool is_ordered{true};
+    while (popped < kProducersCount * kValuesCount) {
+      if (!queue.TryPop(value)) {
+        std::this_thread::yield();
+        continue;
+      }
+      auto producer = value >> 32;
+      is_ordered = is_ordered && producer < kProducersCount &&
+                   (value & 0xffffffff) == next[producer];
+      if (producer < kProducersCount)
+        ++next[producer];
+      ++popped;
+    }
+    for (auto &producer : producers)
+      producer.join();
+    CHECK(is_ordered);
+    CHECK(!queue.TryPop(value));
+    for (auto count : next)
+      CHECK(count == kValuesCount);
+  }
+}
+
+int main() {
+  TestCapacity();
+  TestFifoAndFull();
+  TestWrapAround();
+  TestValueKeptWhenFull();
+  TestProducers();
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/// \file result_cache_test.cpp
+/// \brief Tests of select result caching through class DataLoader.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "data_loader/data_loader.h"
+
+namespace {
+  using crypto_wallet::client::DataLoader;
+  using crypto_wallet::client::ResultCache;
+
+  void RemoveDataBase(const std::string &db_name) {
+    for (const auto &suffix : {"", "-wal", "-shm", "-journal"})
+      std::remove((db_name + suffix).c_str());
+  }
+
+  std::vector<std::string> SelectAll(DataLoader &data_loader) {
+    std::shared_ptr<const ResultCache::Result> result;
+    CHECK(data_loader.SelectFromTable({"address", "amount"}, result) == SQLITE_OK);
+    return result ? result->values : std::vector<std::string>{};
+  }
+
+  void TestCommittedResultCached() {
+    const std::string db_name = "result_cache_test_committed_db";
+    RemoveDataBase(db_name);
+    auto data_loader = DataLoader::GetRegistry().Acquire(db_name);
+    data_loader->SetDBTableStructTemplate({"address TEXT", "amount INTEGER"});
+    CHECK(data_loader->CreateDBTable("tx") == SQLITE_OK);
+    data_loader->EnableResultCache(1 << 20);
+    CHECK(data_loader->InsertIntoTable({"a", "1"}) == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1"}));
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1"}));
+    CHECK(data_loader->GetResultCacheMetrics().hits == 1);
+
+    // write drops the result
+    CHECK(data_loader->InsertIntoTable({"b", "2"}) == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1", "b", "2"}));
+    data_loader.reset();
+    RemoveDataBase(db_name);
+  }
+
+  void TestRolledBackRowsNotCached() {
+    const std::string db_name = "result_cache_test_rollback_db";
+    RemoveDataBase(db_name);
+    auto data_loader = DataLoader::GetRegistry().Acquire(db_name);
+    data_loader->SetDBTableStructTemplate({"address TEXT", "amount INTEGER"});
+    CHECK(data_loader->CreateDBTable("tx") == SQLITE_OK);
+    data_loader->EnableResultCache(1 << 20);
+    CHECK(data_loader->InsertIntoTable({"a", "1"}) == SQLITE_OK);
+
+    // uncommitted row seen by the writer is not cached
+    CHECK(data_loader->BeginTransaction() == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"b", "2"}) == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1", "b", "2"}));
+    CHECK(data_loader->RollbackTransaction() == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1"}));
+
+    // cached result is not served to the writer inside the transaction
+    CHECK(data_loader->BeginTransaction() == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"c", "3"}) == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1", "c", "3"}));
+    CHECK(data_loader->RollbackTransaction() == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"a", "1"}));
+    data_loader.reset();
+    RemoveDataBase(db_name);
+  }
+}
+
+int main() {
+  TestCommittedResultCached();
+  TestRolledBackRowsNotCached();
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+/// \file value_dictionary_test.cpp
+/// \brief Tests of dictionary encoding round trip through class DataLoader.
+/// \author Dmitry Kormulev <dmitry.kormulev@yandex.ru>
+/// \version 1.0.0.0
+/// \date 17.10.2026
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "data_loader/data_loader.h"
+
+namespace {
+  using crypto_wallet::client::DataLoader;
+  using crypto_wallet::client::ResultCache;
+  using crypto_wallet::client::ValueDictionary;
+
+  void RemoveDataBase(const std::string &db_name) {
+    for (const auto &suffix : {"", "-wal", "-shm", "-journal"})
+      std::remove((db_name + suffix).c_str());
+  }
+
+  std::vector<std::string> SelectAll(DataLoader &data_loader) {
+    std::shared_ptr<const ResultCache::Result> result;
+    CHECK(data_loader.SelectFromTable({"address", "amount"}, result) == SQLITE_OK);
+    return result ? result->values : std::vector<std::string>{};
+  }
+
+  void TestTextAffinity() {
+    CHECK(ValueDictionary::IsTextAffinity("TEXT"));
+    CHECK(ValueDictionary::IsTextAffinity("varchar(64)"));
+    CHECK(ValueDictionary::IsTextAffinity("CLOB"));
+    CHECK(!ValueDictionary::IsTextAffinity(""));
+    CHECK(!ValueDictionary::IsTextAffinity("INTEGER"));
+    // INT wins over CHAR
+    CHECK(!ValueDictionary::IsTextAffinity("CHARINT"));
+    CHECK(!ValueDictionary::IsTextAffinity("BLOB"));
+    CHECK(!ValueDictionary::IsTextAffinity("NUMERIC"));
+  }
+
+  void TestTextColumnRefused() {
+    const std::string db_name = "value_dictionary_test_text_db";
+    RemoveDataBase(db_name);
+    auto data_loader = DataLoader::GetRegistry().Acquire(db_name);
+    data_loader->SetDBTableStructTemplate({"address TEXT", "amount TEXT"});
+    CHECK(data_loader->CreateDBTable("tx") == SQLITE_OK);
+    CHECK(data_loader->EnableDictionaryEncoding({"address"}) == SQLITE_MISMATCH);
+    CHECK(data_loader->InsertIntoTable({"wallet_abc", "5"}) == SQLITE_OK);
+    CHECK(SelectAll(*data_loader) == (std::vector<std::string>{"wallet_abc", "5"}));
+    data_loader.reset();
+    RemoveDataBase(db_name);
+  }
+
+  // Values looking like ids are written before and after encoding is enabled.
+  void TestRoundTrip(const std::string &db_name, const std::string &address_type,
+                     bool is_read_pool) {
+    RemoveDataBase(db_name);
+    auto data_loader = DataLoader::GetRegistry().Acquire(db_name);
+    data_loader->SetDBTableStructTemplate({"address " + address_type, "amount INTEGER"});
+    CHECK(data_loader->CreateDBTable("tx") == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"1", "10"}) == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"plain", "20"}) == SQLITE_OK);
+    CHECK(data_loader->EnableDictionaryEncoding({"address"}) == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"wallet_abc", "5"}) == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"2", "6"}) == SQLITE_OK);
+    CHECK(data_loader->InsertIntoTable({"wallet_abc", "7"}) == SQLITE_OK);
+    if (is_read_pool)
+      CHECK(data_loader->EnableReadPool(2) == SQLITE_OK);
+
+    const std::vector<std::string> expected{"1", "10", "plain", "20", "wallet_abc", "5",
+                                            "2", "6", "wallet_abc", "7"};
+    CHECK(SelectAll(*data_loader) == expected);
+    std::vector<std::string> values;
+    auto cursor = data_loader->OpenSelectCursor({"address", "amount"}, 2);
+    for (const auto &row : cursor)
+      for (int32_t i = 0; i < 2; ++i)
+        values.emplace_back(row.GetText(i));
+    CHECK(cursor.GetResult() == SQLITE_OK);
+    CHECK(values == expected);
+    CHECK(data_loader->GetDictionaryMetrics().interned_values == 2);
+    data_loader.reset();
+    RemoveDataBase(db_name);
+  }
+}
+
+int main() {
+  TestTextAffinity();
+  TestTextColumnRefused();
+  TestRoundTrip("value_dictionary_test_untyped_db", "", false);
+  TestRoundTrip("value_dictionary_test_integer_db", "INTEGER", false);
+  TestRoundTrip("value_dictionary_test_numeric_db", "NUMERIC", true);
+  return crypto_wallet::test::failures_count ? 1 : 0;
+}